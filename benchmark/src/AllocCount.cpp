@@ -0,0 +1,57 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+// Replaces the global allocation functions, so the benchmarks can report
+// the number of allocations made by each implementation.
+// The other forms of `operator new` and `operator delete` provided by the
+// standard library forward to the ones below.
+
+#include "Bench.hpp"
+
+#include <cstdlib>
+
+#include <atomic>
+#include <new>
+
+namespace
+{
+
+std::atomic<uint64_t> g_numAllocs(0);
+
+} // namespace
+
+namespace SimpleUtf_Bench
+{
+
+uint64_t GetNumAllocs()
+{
+	return g_numAllocs.load(std::memory_order_relaxed);
+}
+
+} // namespace SimpleUtf_Bench
+
+void* operator new(std::size_t size)
+{
+	g_numAllocs.fetch_add(1, std::memory_order_relaxed);
+
+	void* ptr = std::malloc(size != 0 ? size : 1);
+	if (ptr == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+#endif // __cpp_sized_deallocation
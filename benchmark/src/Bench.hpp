@@ -0,0 +1,104 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace SimpleUtf_Bench
+{
+
+struct BenchConfig
+{
+	// the maximum number of threads used by multi-threaded benchmarks
+	size_t maxThreads;
+	// the minimum time spent on each measurement, in seconds
+	double minTime;
+}; // struct BenchConfig
+
+using BenchFunc = void(*)(const BenchConfig&);
+
+int RegisterBench(const char* name, BenchFunc func);
+
+/**
+ * @brief Runs `func` repeatedly for at least `minTime` seconds, and returns
+ *        the average time per run, in seconds.
+ *
+ */
+template<typename _FuncType>
+inline double TimeIt(double minTime, _FuncType func)
+{
+	using Clock = std::chrono::steady_clock;
+
+	// warm up
+	func();
+
+	size_t runs = 0;
+	double elapsed = 0.0;
+	const auto start = Clock::now();
+	do
+	{
+		func();
+		++runs;
+		elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+	} while (elapsed < minTime);
+
+	return elapsed / static_cast<double>(runs);
+}
+
+inline void PrintResult(
+	const std::string& group,
+	const std::string& name,
+	double secPerRun,
+	size_t bytesPerRun)
+{
+	const double mbPerSec =
+		(static_cast<double>(bytesPerRun) / (1024.0 * 1024.0)) / secPerRun;
+	std::cout << group << "/" << name << ": "
+		<< (secPerRun * 1e3) << " ms/run, "
+		<< mbPerSec << " MiB/s" << std::endl;
+}
+
+/**
+ * @brief The number of calls to the global `operator new` so far
+ *
+ */
+uint64_t GetNumAllocs();
+
+/**
+ * @brief Runs `func` once, and returns the number of allocations it made
+ *
+ */
+template<typename _FuncType>
+inline uint64_t CountAllocs(_FuncType func)
+{
+	const uint64_t before = GetNumAllocs();
+	func();
+	return GetNumAllocs() - before;
+}
+
+/**
+ * @brief Generates a UTF-8 test corpus of roughly `numBytes` bytes, with
+ *        the given portions of 2, 3, and 4-byte code points (in percent);
+ *        the rest are ASCII.
+ *
+ */
+std::string GenUtf8Corpus(
+	size_t numBytes, unsigned pct2B, unsigned pct3B, unsigned pct4B,
+	uint32_t seed = 1);
+
+} // namespace SimpleUtf_Bench
+
+#define SIMPLEUTF_BENCH(NAME) \
+	static void NAME(const SimpleUtf_Bench::BenchConfig&); \
+	static const int NAME##_reg = \
+		SimpleUtf_Bench::RegisterBench(#NAME, NAME); \
+	static void NAME(const SimpleUtf_Bench::BenchConfig& config)
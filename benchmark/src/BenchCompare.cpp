@@ -0,0 +1,328 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+// Runs the same corpora through SimpleUtf, iconv, and (where the standard
+// library still provides it) std::wstring_convert with codecvt_utf8_utf16,
+// and reports the throughput, number of allocations, and the cost of
+// handling invalid inputs side by side.
+
+#ifdef SIMPLEUTF_BENCH_COMPARE
+
+#include "Bench.hpp"
+
+#include <iconv.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <stdexcept>
+
+// codecvt_utf8_utf16 is deprecated since C++17, and removed in C++26
+#if __cplusplus <= 202302L
+#	define SIMPLEUTF_BENCH_HAS_CODECVT
+#	include <codecvt>
+#	include <locale>
+#endif
+
+#include <SimpleUtf/Utf.hpp>
+
+using namespace SimpleUtf_Bench;
+
+namespace
+{
+
+/**
+ * @brief A thin wrapper of an iconv conversion descriptor
+ *
+ */
+class IconvConverter
+{
+public:
+
+	IconvConverter(const char* to, const char* from) :
+		m_cd(iconv_open(to, from))
+	{
+		if (m_cd == reinterpret_cast<iconv_t>(-1))
+		{
+			throw std::runtime_error(
+				std::string("iconv_open failed: ") + std::strerror(errno));
+		}
+	}
+
+	IconvConverter(const IconvConverter&) = delete;
+
+	IconvConverter& operator=(const IconvConverter&) = delete;
+
+	~IconvConverter()
+	{
+		iconv_close(m_cd);
+	}
+
+	/**
+	 * @brief Converts `in` into `out`; iconv needs a big enough output
+	 *        buffer upfront, so `out` is resized to `maxRatio` code units per
+	 *        input code unit, and shrunk afterwards.
+	 *
+	 * @return false if the input is invalid
+	 */
+	template<typename _InCharType, typename _OutCharType>
+	bool Convert(const std::basic_string<_InCharType>& in,
+		std::basic_string<_OutCharType>& out,
+		size_t maxRatio)
+	{
+		out.resize(in.size() * maxRatio);
+
+		// reset the conversion state
+		iconv(m_cd, nullptr, nullptr, nullptr, nullptr);
+
+		char* inPtr = const_cast<char*>(
+			reinterpret_cast<const char*>(in.data()));
+		size_t inLeft = in.size() * sizeof(_InCharType);
+		char* outPtr = reinterpret_cast<char*>(&out[0]);
+		size_t outLeft = out.size() * sizeof(_OutCharType);
+
+		if (iconv(m_cd, &inPtr, &inLeft, &outPtr, &outLeft) ==
+			static_cast<size_t>(-1))
+		{
+			out.clear();
+			return false;
+		}
+
+		out.resize(out.size() - (outLeft / sizeof(_OutCharType)));
+		return true;
+	}
+
+private:
+
+	iconv_t m_cd;
+}; // class IconvConverter
+
+const char* NativeUtf16Name()
+{
+	const uint16_t val = 0x0102U;
+	unsigned char firstByte = 0;
+	std::memcpy(&firstByte, &val, 1);
+	return firstByte == 0x01U ? "UTF-16BE" : "UTF-16LE";
+}
+
+#ifdef SIMPLEUTF_BENCH_HAS_CODECVT
+#	if defined(__GNUC__)
+#		pragma GCC diagnostic push
+#		pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#	endif
+
+using CodecvtConverter =
+	std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>;
+
+#endif // SIMPLEUTF_BENCH_HAS_CODECVT
+
+struct Corpus
+{
+	const char* name;
+	std::string utf8;
+	std::u16string utf16;
+}; // struct Corpus
+
+std::vector<Corpus> GenCorpora()
+{
+	static constexpr size_t sk_size = 4 * 1024 * 1024;
+
+	std::vector<Corpus> res;
+	res.push_back({ "ascii",  GenUtf8Corpus(sk_size,  0,  0,  0, 3), u"" });
+	res.push_back({ "latin",  GenUtf8Corpus(sk_size, 30,  5,  0, 5), u"" });
+	res.push_back({ "cjk",    GenUtf8Corpus(sk_size,  5, 80,  2, 7), u"" });
+	res.push_back({ "emoji",  GenUtf8Corpus(sk_size,  0, 10, 40, 9), u"" });
+	for (auto& corpus : res)
+	{
+		corpus.utf16 = SimpleUtf::Utf8ToUtf16(corpus.utf8);
+	}
+	return res;
+}
+
+/**
+ * @brief Times `func`, counts its allocations, and prints both
+ *
+ */
+template<typename _FuncType>
+void Measure(const BenchConfig& config,
+	const std::string& group, const std::string& name, size_t bytesPerRun,
+	_FuncType func)
+{
+	const double secPerRun = TimeIt(config.minTime, func);
+	const uint64_t allocs = CountAllocs(func);
+	PrintResult(group, name, secPerRun, bytesPerRun);
+	std::cout << "    allocations/run: " << allocs << std::endl;
+}
+
+template<typename _CharType>
+void CheckSame(const std::string& name,
+	const std::basic_string<_CharType>& expected,
+	const std::basic_string<_CharType>& actual)
+{
+	if (expected != actual)
+	{
+		std::cout << "    WARNING: output of " << name
+			<< " differs from SimpleUtf" << std::endl;
+	}
+}
+
+} // namespace
+
+SIMPLEUTF_BENCH(CompareUtf8ToUtf16)
+{
+	IconvConverter iconvConv(NativeUtf16Name(), "UTF-8");
+
+	for (const auto& corpus : GenCorpora())
+	{
+		const std::string group = std::string("Utf8ToUtf16/") + corpus.name;
+		const size_t bytes = corpus.utf8.size();
+		std::u16string out;
+
+		Measure(config, group, "SimpleUtf", bytes, [&]()
+		{
+			out = SimpleUtf::Utf8ToUtf16(corpus.utf8);
+		});
+
+		Measure(config, group, "SimpleUtf (reused output)", bytes, [&]()
+		{
+			SimpleUtf::Utf8ToUtf16(corpus.utf8, out);
+		});
+
+		Measure(config, group, "iconv", bytes, [&]()
+		{
+			iconvConv.Convert(corpus.utf8, out, 1);
+		});
+		CheckSame("iconv", corpus.utf16, out);
+
+#ifdef SIMPLEUTF_BENCH_HAS_CODECVT
+		CodecvtConverter codecvtConv;
+		Measure(config, group, "codecvt_utf8_utf16", bytes, [&]()
+		{
+			out = codecvtConv.from_bytes(corpus.utf8);
+		});
+		CheckSame("codecvt_utf8_utf16", corpus.utf16, out);
+#endif // SIMPLEUTF_BENCH_HAS_CODECVT
+	}
+}
+
+SIMPLEUTF_BENCH(CompareUtf16ToUtf8)
+{
+	IconvConverter iconvConv("UTF-8", NativeUtf16Name());
+
+	for (const auto& corpus : GenCorpora())
+	{
+		const std::string group = std::string("Utf16ToUtf8/") + corpus.name;
+		const size_t bytes = corpus.utf16.size() * sizeof(char16_t);
+		std::string out;
+
+		Measure(config, group, "SimpleUtf", bytes, [&]()
+		{
+			out = SimpleUtf::Utf16ToUtf8(corpus.utf16);
+		});
+
+		Measure(config, group, "SimpleUtf (reused output)", bytes, [&]()
+		{
+			SimpleUtf::Utf16ToUtf8(corpus.utf16, out);
+		});
+
+		Measure(config, group, "iconv", bytes, [&]()
+		{
+			iconvConv.Convert(corpus.utf16, out, 3);
+		});
+		CheckSame("iconv", corpus.utf8, out);
+
+#ifdef SIMPLEUTF_BENCH_HAS_CODECVT
+		CodecvtConverter codecvtConv;
+		Measure(config, group, "codecvt_utf8_utf16", bytes, [&]()
+		{
+			out = codecvtConv.to_bytes(corpus.utf16);
+		});
+		CheckSame("codecvt_utf8_utf16", corpus.utf8, out);
+#endif // SIMPLEUTF_BENCH_HAS_CODECVT
+	}
+}
+
+SIMPLEUTF_BENCH(CompareUtf8ErrorHandling)
+{
+	// many short strings, a quarter of which contain an invalid byte
+	const std::string src = GenUtf8Corpus(2 * 1024 * 1024, 10, 50, 2, 13);
+	std::vector<std::string> batch;
+	size_t bytes = 0;
+	for (size_t pos = 0; pos + 64 < src.size(); )
+	{
+		const char* end = SimpleUtf::Internal::Utf8SeqBegin(
+			src.data(), src.data() + pos + 32);
+		batch.emplace_back(src.data() + pos, end);
+		if (batch.size() % 4 == 0)
+		{
+			batch.back().insert(batch.back().size() / 2, 1, '\xFF');
+		}
+		bytes += batch.back().size();
+		pos = static_cast<size_t>(end - src.data());
+	}
+
+	const std::string group = "Utf8ToUtf16/invalid-25pct";
+	std::u16string out;
+	size_t numFailed = 0;
+
+	Measure(config, group, "SimpleUtf (exceptions)", bytes, [&]()
+	{
+		numFailed = 0;
+		for (const auto& str : batch)
+		{
+			try
+			{
+				SimpleUtf::Utf8ToUtf16(str, out);
+			}
+			catch (const SimpleUtf::UtfConversionException&)
+			{
+				++numFailed;
+			}
+		}
+	});
+	std::cout << "    failed: " << numFailed << "/" << batch.size()
+		<< std::endl;
+
+	IconvConverter iconvConv(NativeUtf16Name(), "UTF-8");
+	Measure(config, group, "iconv (EILSEQ)", bytes, [&]()
+	{
+		numFailed = 0;
+		for (const auto& str : batch)
+		{
+			numFailed += iconvConv.Convert(str, out, 1) ? 0 : 1;
+		}
+	});
+	std::cout << "    failed: " << numFailed << "/" << batch.size()
+		<< std::endl;
+
+#ifdef SIMPLEUTF_BENCH_HAS_CODECVT
+	CodecvtConverter codecvtConv;
+	Measure(config, group, "codecvt_utf8_utf16 (exceptions)", bytes, [&]()
+	{
+		numFailed = 0;
+		for (const auto& str : batch)
+		{
+			try
+			{
+				out = codecvtConv.from_bytes(str);
+			}
+			catch (const std::range_error&)
+			{
+				++numFailed;
+			}
+		}
+	});
+	std::cout << "    failed: " << numFailed << "/" << batch.size()
+		<< std::endl;
+#endif // SIMPLEUTF_BENCH_HAS_CODECVT
+}
+
+#ifdef SIMPLEUTF_BENCH_HAS_CODECVT
+#	if defined(__GNUC__)
+#		pragma GCC diagnostic pop
+#	endif
+#endif // SIMPLEUTF_BENCH_HAS_CODECVT
+
+#endif // SIMPLEUTF_BENCH_COMPARE
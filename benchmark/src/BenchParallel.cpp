@@ -0,0 +1,85 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include "Bench.hpp"
+
+#include <SimpleUtf/UtfParallel.hpp>
+
+using namespace SimpleUtf_Bench;
+
+namespace
+{
+
+/**
+ * @brief A batch with very uneven string sizes: many short strings, with a
+ *        few multi-MiB documents in between.
+ *
+ */
+std::vector<std::string> GenHeterogeneousBatch(size_t& totalBytes)
+{
+	const std::string doc = GenUtf8Corpus(4 * 1024 * 1024, 10, 20, 2, 7);
+	const std::string small = GenUtf8Corpus(256 * 1024, 10, 20, 2, 11);
+
+	std::vector<std::string> res;
+	totalBytes = 0;
+	size_t pos = 0;
+	for (size_t i = 0; i < 500000; ++i)
+	{
+		// short strings of 0 to 31 bytes, cut at code point boundaries
+		const size_t len = i % 32;
+		auto begin = small.data() + pos;
+		auto end = SimpleUtf::Internal::Utf8SeqBegin(
+			small.data(), begin + len);
+		res.emplace_back(begin, end);
+		totalBytes += res.back().size();
+
+		pos = static_cast<size_t>(end - small.data());
+		pos = pos + 64 < small.size() ? pos : 0;
+
+		if (i % 100000 == 0)
+		{
+			res.push_back(doc);
+			totalBytes += doc.size();
+		}
+	}
+	return res;
+}
+
+} // namespace
+
+SIMPLEUTF_BENCH(ParallelBatchUtf8ToUtf16)
+{
+	size_t totalBytes = 0;
+	const auto batch = GenHeterogeneousBatch(totalBytes);
+
+	SimpleUtf::UtfBatch<char16_t> out;
+
+	const double serial = TimeIt(config.minTime, [&]()
+	{
+		SimpleUtf::Utf8ToUtf16Batch(batch.begin(), batch.end(), out);
+	});
+	PrintResult("Utf8ToUtf16Batch", "serial", serial, totalBytes);
+
+	for (size_t numThreads = 1; ; numThreads *= 2)
+	{
+		numThreads = numThreads < config.maxThreads ?
+			numThreads : config.maxThreads;
+
+		SimpleUtf::UtfBatchExecutor executor(numThreads);
+		const double parallel = TimeIt(config.minTime, [&]()
+		{
+			executor.Utf8ToUtf16Batch(batch.begin(), batch.end(), out);
+		});
+		PrintResult("UtfBatchExecutor::Utf8ToUtf16Batch",
+			std::to_string(numThreads) + " threads", parallel, totalBytes);
+		std::cout << "    speedup over serial: " << (serial / parallel)
+			<< std::endl;
+
+		if (numThreads == config.maxThreads)
+		{
+			break;
+		}
+	}
+}
@@ -0,0 +1,115 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+// Compares the sizes of texts in different scripts encoded in UTF-8,
+// UTF-16, and SCSU, and the speed of compressing and decompressing SCSU
+// against converting between UTF-8 and UTF-16.
+
+#include "Bench.hpp"
+
+#include <SimpleUtf/Scsu.hpp>
+
+using namespace SimpleUtf_Bench;
+
+namespace
+{
+
+struct ScriptCorpus
+{
+	const char* name;
+	// the letters are picked from [first, first + numLetters)
+	char32_t first;
+	uint32_t numLetters;
+	// the portion of ASCII letters (in percent), e.g., in Latin scripts
+	unsigned pctAscii;
+}; // struct ScriptCorpus
+
+/**
+ * @brief Generates a UTF-8 text of roughly `numBytes` bytes, made of
+ *        words of 2 to 9 letters separated by spaces and punctuation
+ *
+ */
+std::string GenScriptCorpus(const ScriptCorpus& script, size_t numBytes)
+{
+	std::string res;
+	res.reserve(numBytes + 64);
+
+	uint32_t state = 1;
+	auto next = [&state]()
+	{
+		state = state * 1664525U + 1013904223U;
+		return state >> 8;
+	};
+
+	while (res.size() < numBytes)
+	{
+		const size_t wordLen = 2 + (next() % 8);
+		for (size_t i = 0; i < wordLen; ++i)
+		{
+			const char32_t codePt = ((next() % 100) < script.pctAscii) ?
+				static_cast<char32_t>('a' + (next() % 26)) :
+				static_cast<char32_t>(script.first + (next() % script.numLetters));
+			SimpleUtf::CodePtToUtf8Once(codePt, std::back_inserter(res));
+		}
+		res += ((next() % 10) == 0) ? ". " : " ";
+	}
+
+	return res;
+}
+
+} // namespace
+
+SIMPLEUTF_BENCH(ScsuSizeAndSpeed)
+{
+	static const ScriptCorpus sk_scripts[] = {
+		{ "Latin-1",    0x00E0U,   32, 90 },
+		{ "Greek",      0x03B1U,   25,  0 },
+		{ "Cyrillic",   0x0430U,   32,  0 },
+		{ "Hebrew",     0x05D0U,   27,  0 },
+		{ "Devanagari", 0x0905U,   53,  0 },
+		{ "Hiragana",   0x3041U,   86,  0 },
+		{ "Chinese",    0x4E00U, 8000,  0 },
+		{ "Korean",     0xAC00U, 2000,  0 },
+		{ "Emoji",     0x1F600U,   80,  0 },
+	};
+
+	for (const ScriptCorpus& script : sk_scripts)
+	{
+		const std::string utf8 = GenScriptCorpus(script, 4 * 1024 * 1024);
+		const std::u16string utf16 = SimpleUtf::Utf8ToUtf16(utf8);
+		const size_t numCodePts = SimpleUtf::Utf8ToUtf32GetSize(
+			utf8.begin(), utf8.end());
+
+		std::string scsu;
+		SimpleUtf::Utf8ToScsu(utf8, scsu);
+
+		std::cout << script.name << ": "
+			<< "UTF-8 " << (static_cast<double>(utf8.size()) / numCodePts)
+			<< ", UTF-16 "
+			<< (static_cast<double>(utf16.size() * 2) / numCodePts)
+			<< ", SCSU " << (static_cast<double>(scsu.size()) / numCodePts)
+			<< " bytes/char" << std::endl;
+
+		std::u16string out16;
+		const double utf8ToUtf16 = TimeIt(config.minTime, [&]()
+		{
+			SimpleUtf::Utf8ToUtf16(utf8, out16);
+		});
+		PrintResult(script.name, "Utf8ToUtf16", utf8ToUtf16, utf8.size());
+
+		const double compress = TimeIt(config.minTime, [&]()
+		{
+			SimpleUtf::Utf8ToScsu(utf8, scsu);
+		});
+		PrintResult(script.name, "Utf8ToScsu", compress, utf8.size());
+
+		std::string out8;
+		const double decompress = TimeIt(config.minTime, [&]()
+		{
+			SimpleUtf::ScsuToUtf8(scsu, out8);
+		});
+		PrintResult(script.name, "ScsuToUtf8", decompress, utf8.size());
+	}
+}
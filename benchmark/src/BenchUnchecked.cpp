@@ -0,0 +1,75 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+// Compares the checked conversions against the unchecked ones (which skip
+// validation for input that is assumed to be valid), and the conversions
+// of validated `Utf8String`s; the numbers are only meaningful in release
+// builds, where `SIMPLEUTF_CHECK_ASSUME_VALID` is not defined.
+
+#include "Bench.hpp"
+
+#include <SimpleUtf/Utf.hpp>
+
+using namespace SimpleUtf_Bench;
+
+SIMPLEUTF_BENCH(UncheckedConversions)
+{
+	struct Mix
+	{
+		const char* name;
+		unsigned pct2B;
+		unsigned pct3B;
+		unsigned pct4B;
+	}; // struct Mix
+
+	static const Mix sk_mixes[] = {
+		{ "Ascii",  0,  0,  0 },
+		{ "Latin", 10,  0,  0 },
+		{ "Cjk",    0, 80,  0 },
+		{ "Mixed", 20, 20, 10 },
+	};
+
+	for (const Mix& mix : sk_mixes)
+	{
+		const std::string utf8 = GenUtf8Corpus(
+			4 * 1024 * 1024, mix.pct2B, mix.pct3B, mix.pct4B);
+		const std::u16string utf16 = SimpleUtf::Utf8ToUtf16(utf8);
+		const SimpleUtf::Utf8String valid8(utf8);
+
+		std::u16string out16;
+		const double checked8 = TimeIt(config.minTime, [&]()
+		{
+			SimpleUtf::Utf8ToUtf16(utf8, out16);
+		});
+		PrintResult(mix.name, "Utf8ToUtf16", checked8, utf8.size());
+
+		const double unchecked8 = TimeIt(config.minTime, [&]()
+		{
+			SimpleUtf::Utf8ToUtf16Unchecked(utf8, out16);
+		});
+		PrintResult(mix.name, "Utf8ToUtf16Unchecked", unchecked8, utf8.size());
+
+		const double validated8 = TimeIt(config.minTime, [&]()
+		{
+			SimpleUtf::Utf8ToUtf16(valid8, out16);
+		});
+		PrintResult(mix.name, "Utf8ToUtf16(Utf8String)", validated8,
+			utf8.size());
+
+		std::string out8;
+		const double checked16 = TimeIt(config.minTime, [&]()
+		{
+			SimpleUtf::Utf16ToUtf8(utf16, out8);
+		});
+		PrintResult(mix.name, "Utf16ToUtf8", checked16, utf8.size());
+
+		const double unchecked16 = TimeIt(config.minTime, [&]()
+		{
+			SimpleUtf::Utf16ToUtf8Unchecked(utf16, out8);
+		});
+		PrintResult(mix.name, "Utf16ToUtf8Unchecked", unchecked16,
+			utf8.size());
+	}
+}
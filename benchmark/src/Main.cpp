@@ -0,0 +1,124 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include "Bench.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+#include <thread>
+#include <utility>
+
+#include <SimpleUtf/Utf.hpp>
+
+namespace SimpleUtf_Bench
+{
+
+static std::vector<std::pair<const char*, BenchFunc> >& GetRegistry()
+{
+	static std::vector<std::pair<const char*, BenchFunc> > registry;
+	return registry;
+}
+
+int RegisterBench(const char* name, BenchFunc func)
+{
+	GetRegistry().emplace_back(name, func);
+	return 0;
+}
+
+std::string GenUtf8Corpus(
+	size_t numBytes, unsigned pct2B, unsigned pct3B, unsigned pct4B,
+	uint32_t seed)
+{
+	std::string res;
+	res.reserve(numBytes + 4);
+
+	// a simple LCG, so the corpus is the same on all platforms
+	uint32_t state = seed;
+	auto next = [&state]()
+	{
+		state = state * 1664525U + 1013904223U;
+		return state >> 8;
+	};
+
+	while (res.size() < numBytes)
+	{
+		const unsigned pick = next() % 100;
+		char32_t codePt = 0;
+		if (pick < pct4B)
+		{
+			codePt = 0x10000U + (next() % 0x2000U);
+		}
+		else if (pick < pct4B + pct3B)
+		{
+			codePt = 0x4E00U + (next() % 0x5000U);
+		}
+		else if (pick < pct4B + pct3B + pct2B)
+		{
+			codePt = 0x0400U + (next() % 0x0100U);
+		}
+		else
+		{
+			codePt = 0x20U + (next() % 0x5FU);
+		}
+		SimpleUtf::CodePtToUtf8Once(codePt, std::back_inserter(res));
+	}
+
+	return res;
+}
+
+} // namespace SimpleUtf_Bench
+
+int main(int argc, char** argv)
+{
+	using namespace SimpleUtf_Bench;
+
+	const char* filter = nullptr;
+	BenchConfig config;
+	config.maxThreads = std::thread::hardware_concurrency();
+	config.maxThreads = config.maxThreads != 0 ? config.maxThreads : 1;
+	config.minTime = 0.5;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strncmp(argv[i], "--filter=", 9) == 0)
+		{
+			filter = argv[i] + 9;
+		}
+		else if (std::strncmp(argv[i], "--max-threads=", 14) == 0)
+		{
+			config.maxThreads = std::strtoul(argv[i] + 14, nullptr, 10);
+		}
+		else if (std::strncmp(argv[i], "--min-time=", 11) == 0)
+		{
+			config.minTime = std::strtod(argv[i] + 11, nullptr);
+		}
+		else
+		{
+			std::cout << "Usage: " << argv[0]
+				<< " [--filter=<substr>] [--max-threads=<n>]"
+				<< " [--min-time=<seconds>]" << std::endl;
+			return -1;
+		}
+	}
+
+	std::cout << "===== SimpleUtf benchmark program =====" << std::endl;
+	std::cout << "__cplusplus = " << __cplusplus << std::endl;
+	std::cout << "max threads = " << config.maxThreads << std::endl;
+	std::cout << std::endl;
+
+	for (const auto& bench : GetRegistry())
+	{
+		if ((filter != nullptr) && (std::strstr(bench.first, filter) == nullptr))
+		{
+			continue;
+		}
+		std::cout << "===== " << bench.first << std::endl;
+		bench.second(config);
+		std::cout << std::endl;
+	}
+
+	return 0;
+}
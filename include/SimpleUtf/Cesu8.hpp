@@ -0,0 +1,528 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include "Utf.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+// CESU-8 encodes each UTF-16 code unit separately, in 1 to 3 bytes, so a
+// supplementary character (a surrogate pair) takes two 3-byte sequences;
+// the 4-byte form of UTF-8 is not used.
+// Java's Modified UTF-8 (MUTF-8) is CESU-8 with NUL encoded as `C0 80`,
+// so encoded strings never contain a zero byte.
+
+namespace Internal
+{
+
+/**
+ * @brief Decodes a single UTF-16 code unit (which may be a surrogate) from
+ *        CESU-8, or MUTF-8 if `_IsMutf8` is true (which also accepts `C0 80`
+ *        for NUL).
+ *
+ */
+template<bool _IsMutf8, typename InputIt>
+inline std::pair<char16_t, InputIt> Cesu8ToUtf16UnitOnce(
+	InputIt begin, InputIt end)
+{
+	if (begin == end)
+	{
+		SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
+		throw UtfConversionException("Unexpected Ending" " - "
+			"String ends unexpected while reading the next CESU-8 char.");
+	}
+
+	const auto leading = EnsureByteSize<1>(*begin);
+	const uint8_t uval = static_cast<uint8_t>(BitCast2Unsigned(leading));
+	++begin;
+
+	// 0xxxxxxx
+	if (uval < 0x80U)
+	{
+		SIMPLEUTF_STATS_ADD(BytesIn, 1);
+		return std::make_pair(static_cast<char16_t>(uval), begin);
+	}
+
+	size_t numCont = 0;
+	char16_t res = 0;
+	// 110xxxxx  10xxxxxx
+	if ((uval & 0xE0U) == 0xC0U)
+	{
+		numCont = 1;
+		res = static_cast<char16_t>(uval & 0x1FU);
+	}
+	// 1110xxxx  10xxxxxx  10xxxxxx
+	else if ((uval & 0xF0U) == 0xE0U)
+	{
+		numCont = 2;
+		res = static_cast<char16_t>(uval & 0x0FU);
+	}
+	else
+	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+		throw UtfConversionException("Invalid Encoding" " - "
+			"Invalid CESU-8 leading byte.");
+	}
+
+	for (size_t i = 0; i < numCont; ++i)
+	{
+		if (begin == end)
+		{
+			SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
+			throw UtfConversionException("Unexpected Ending" " - "
+				"String ends unexpected while reading the next CESU-8 char.");
+		}
+
+		res = static_cast<char16_t>((res << 6) | Utf8ReadCont(*begin));
+		++begin;
+	}
+
+	// overlong encodings, except for NUL in MUTF-8
+	const bool isMutf8Nul = _IsMutf8 && (numCont == 1) && (res == 0);
+	if (((numCont == 1) && (res < 0x80U) && !isMutf8Nul) ||
+		((numCont == 2) && (res < 0x800U)))
+	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+		throw UtfConversionException("Invalid Encoding" " - "
+			"Overlong CESU-8 encoding.");
+	}
+
+	SIMPLEUTF_STATS_ADD(BytesIn, 1 + numCont);
+
+	return std::make_pair(res, begin);
+}
+
+/**
+ * @brief Encodes a single UTF-16 code unit (which may be a surrogate) into
+ *        CESU-8, or MUTF-8 if `_IsMutf8` is true.
+ *
+ */
+template<bool _IsMutf8, typename OutputIt>
+inline OutputIt Utf16UnitToCesu8Once(char16_t unit, OutputIt oit)
+{
+	char res[3] = { 0, 0, 0 };
+	size_t size = 0;
+
+	if ((unit < 0x80U) && ((unit != 0) || !_IsMutf8))
+	{
+		res[0] = static_cast<char>(unit);
+		size = 1;
+	}
+	else if (unit < 0x800U)
+	{
+		res[0] = BitCast<char>(static_cast<uint8_t>(0xC0U | (unit >> 6)));
+		res[1] = BitCast<char>(static_cast<uint8_t>(0x80U | (unit & 0x3FU)));
+		size = 2;
+	}
+	else
+	{
+		res[0] = BitCast<char>(static_cast<uint8_t>(0xE0U | (unit >> 12)));
+		res[1] = BitCast<char>(
+			static_cast<uint8_t>(0x80U | ((unit >> 6) & 0x3FU)));
+		res[2] = BitCast<char>(static_cast<uint8_t>(0x80U | (unit & 0x3FU)));
+		size = 3;
+	}
+
+	SIMPLEUTF_STATS_ADD(BytesOut, size);
+
+	return std::copy(std::begin(res), std::begin(res) + size, oit);
+}
+
+template<bool _IsMutf8>
+inline size_t Utf16UnitToCesu8OnceGetSize(char16_t unit)
+{
+	return ((unit < 0x80U) && ((unit != 0) || !_IsMutf8)) ? 1 :
+		(unit < 0x800U) ? 2 : 3;
+}
+
+/**
+ * @brief Decodes a code point from CESU-8 / MUTF-8, joining the two halves
+ *        of a surrogate pair; unpaired surrogates are only accepted under
+ *        `WtfPolicy`.
+ *
+ */
+template<bool _IsMutf8, typename _Policy, typename InputIt>
+inline std::pair<char32_t, InputIt> Cesu8ToCodePtOnceImpl(
+	InputIt begin, InputIt end)
+{
+	auto unitRes = Cesu8ToUtf16UnitOnce<_IsMutf8>(begin, end);
+	const char16_t unit = unitRes.first;
+
+	// only decode the next unit if it's going to be used, so it's neither
+	// counted in the stats twice nor rejected here instead of on its own
+	if (IsUtf16SurrogateFirst(unit) &&
+		Utf8IsLowSurrogateAt(unitRes.second, end))
+	{
+		auto secondRes = Cesu8ToUtf16UnitOnce<_IsMutf8>(unitRes.second, end);
+		char32_t res = 0x10000U;
+		res += static_cast<char32_t>((unit & 0x03FFU) << 10);
+		res += static_cast<char32_t>((secondRes.first & 0x03FFU));
+		return std::make_pair(res, secondRes.second);
+	}
+
+	if (IsUtf16Surrogate(unit) && !_Policy::AllowLoneSurrogates())
+	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+		throw UtfConversionException("Invalid Encoding" " - "
+			"Unpaired surrogate in CESU-8.");
+	}
+
+	return std::make_pair(static_cast<char32_t>(unit), unitRes.second);
+}
+
+template<bool _IsMutf8, typename _Policy, typename OutputIt>
+inline OutputIt CodePtToCesu8OnceImpl(char32_t val, OutputIt oit)
+{
+	if (!_Policy::IsValidCodePt(val))
+	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidCodePoint, 1);
+		throw UtfConversionException("Invalid UTF Code Point" " - "
+			+ std::to_string(val) + " is not a valid UTF code point.");
+	}
+
+	if (val <= 0xFFFFU)
+	{
+		return Utf16UnitToCesu8Once<_IsMutf8>(static_cast<char16_t>(val), oit);
+	}
+
+	const char32_t code = (val - 0x10000U);
+	oit = Utf16UnitToCesu8Once<_IsMutf8>(
+		static_cast<char16_t>(0xD800U | (code >> 10)), oit);
+	return Utf16UnitToCesu8Once<_IsMutf8>(
+		static_cast<char16_t>(0xDC00U | (code & 0x3FFU)), oit);
+}
+
+template<bool _IsMutf8, typename _Policy>
+inline size_t CodePtToCesu8OnceGetSizeImpl(char32_t val)
+{
+	if (!_Policy::IsValidCodePt(val))
+	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidCodePoint, 1);
+		throw UtfConversionException("Invalid UTF Code Point" " - "
+			+ std::to_string(val) + " is not a valid UTF code point.");
+	}
+
+	return val <= 0xFFFFU ?
+		Utf16UnitToCesu8OnceGetSize<_IsMutf8>(static_cast<char16_t>(val)) :
+		6;
+}
+
+/**
+ * @brief Direct conversions between MUTF-8 and UTF-16, one code unit at a
+ *        time; runs of ASCII characters are copied directly.
+ *
+ */
+template<typename _ValType, typename OutputIt>
+inline OutputIt Mutf8ToUtf16AsciiFast(
+	const _ValType* begin, const _ValType* end, OutputIt dest)
+{
+	while (begin != end)
+	{
+		const size_t numAscii = CountAsciiPrefix(begin, end);
+		dest = std::copy(begin, begin + numAscii, dest);
+		begin += numAscii;
+
+		if (begin != end)
+		{
+			auto unitRes = Cesu8ToUtf16UnitOnce<true>(begin, end);
+			*dest = unitRes.first;
+			++dest;
+			begin = unitRes.second;
+		}
+	}
+	return dest;
+}
+
+/**
+ * @brief Converts one code unit at a time, for iterators other than
+ *        pointers to bytes
+ *
+ */
+template<typename InputIt, typename OutputIt>
+inline OutputIt Mutf8ToUtf16Impl(InputIt begin, InputIt end, OutputIt dest)
+{
+	while (begin != end)
+	{
+		auto unitRes = Cesu8ToUtf16UnitOnce<true>(begin, end);
+		*dest = unitRes.first;
+		++dest;
+		begin = unitRes.second;
+	}
+	return dest;
+}
+
+/**
+ * @brief Pointers to bytes can be scanned by `CountAsciiPrefix`, so they
+ *        take the ASCII fast path
+ *
+ */
+template<typename _ValType, typename OutputIt,
+	EnableIfT<
+		IsIntegral<_ValType>::value &&
+		(sizeof(_ValType) == 1)
+		, int> = 0>
+inline OutputIt Mutf8ToUtf16Impl(_ValType* begin, _ValType* end, OutputIt dest)
+{
+	return Mutf8ToUtf16AsciiFast(begin, end, dest);
+}
+
+} // namespace Internal
+
+// ==========  CESU-8 <--> code points
+
+template<typename InputIt, typename _Policy = UtfStrictPolicy,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline std::pair<char32_t, InputIt> Cesu8ToCodePtOnce(
+	InputIt begin, InputIt end)
+{
+	return Internal::Cesu8ToCodePtOnceImpl<false, _Policy>(begin, end);
+}
+
+template<typename OutputIt, typename _Policy = UtfStrictPolicy>
+inline OutputIt CodePtToCesu8Once(char32_t val, OutputIt oit)
+{
+	return Internal::CodePtToCesu8OnceImpl<false, _Policy>(val, oit);
+}
+
+template<typename _Policy = UtfStrictPolicy>
+inline size_t CodePtToCesu8OnceGetSize(char32_t val)
+{
+	return Internal::CodePtToCesu8OnceGetSizeImpl<false, _Policy>(val);
+}
+
+// ==========  MUTF-8 <--> code points
+
+template<typename InputIt, typename _Policy = UtfStrictPolicy,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline std::pair<char32_t, InputIt> Mutf8ToCodePtOnce(
+	InputIt begin, InputIt end)
+{
+	return Internal::Cesu8ToCodePtOnceImpl<true, _Policy>(begin, end);
+}
+
+template<typename OutputIt, typename _Policy = UtfStrictPolicy>
+inline OutputIt CodePtToMutf8Once(char32_t val, OutputIt oit)
+{
+	return Internal::CodePtToCesu8OnceImpl<true, _Policy>(val, oit);
+}
+
+template<typename _Policy = UtfStrictPolicy>
+inline size_t CodePtToMutf8OnceGetSize(char32_t val)
+{
+	return Internal::CodePtToCesu8OnceGetSizeImpl<true, _Policy>(val);
+}
+
+// ==========  CESU-8 <--> UTF-8
+
+inline void Cesu8ToUtf8(Internal::StrInputT<char> in, std::string& out)
+{
+	out.clear();
+
+	UtfConvert(Cesu8ToCodePtOnce<const char*>,
+		CodePtToUtf8Once<std::back_insert_iterator<std::string> >,
+		in.data(), in.data() + in.size(), std::back_inserter(out));
+}
+
+inline std::string Cesu8ToUtf8(Internal::StrInputT<char> in)
+{
+	std::string resUtfStr;
+
+	Cesu8ToUtf8(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+inline void Utf8ToCesu8(Internal::StrInputT<char> in, std::string& out)
+{
+	out.clear();
+
+	UtfConvert(Utf8ToCodePtOnce<const char*>,
+		CodePtToCesu8Once<std::back_insert_iterator<std::string> >,
+		in.data(), in.data() + in.size(), std::back_inserter(out));
+}
+
+inline std::string Utf8ToCesu8(Internal::StrInputT<char> in)
+{
+	std::string resUtfStr;
+
+	Utf8ToCesu8(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+// ==========  CESU-8 <--> UTF-16
+
+inline void Cesu8ToUtf16(Internal::StrInputT<char> in, std::u16string& out)
+{
+	out.clear();
+
+	UtfConvert(Cesu8ToCodePtOnce<const char*>,
+		CodePtToUtf16Once<std::back_insert_iterator<std::u16string> >,
+		in.data(), in.data() + in.size(), std::back_inserter(out));
+}
+
+inline std::u16string Cesu8ToUtf16(Internal::StrInputT<char> in)
+{
+	std::u16string resUtfStr;
+
+	Cesu8ToUtf16(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+inline void Utf16ToCesu8(Internal::StrInputT<char16_t> in, std::string& out)
+{
+	out.clear();
+
+	UtfConvert(Utf16ToCodePtOnce<const char16_t*>,
+		CodePtToCesu8Once<std::back_insert_iterator<std::string> >,
+		in.data(), in.data() + in.size(), std::back_inserter(out));
+}
+
+inline std::string Utf16ToCesu8(Internal::StrInputT<char16_t> in)
+{
+	std::string resUtfStr;
+
+	Utf16ToCesu8(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+// ==========  MUTF-8 <--> UTF-8
+
+inline void Mutf8ToUtf8(Internal::StrInputT<char> in, std::string& out)
+{
+	out.clear();
+
+	UtfConvert(Mutf8ToCodePtOnce<const char*>,
+		CodePtToUtf8Once<std::back_insert_iterator<std::string> >,
+		in.data(), in.data() + in.size(), std::back_inserter(out));
+}
+
+inline std::string Mutf8ToUtf8(Internal::StrInputT<char> in)
+{
+	std::string resUtfStr;
+
+	Mutf8ToUtf8(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+inline void Utf8ToMutf8(Internal::StrInputT<char> in, std::string& out)
+{
+	out.clear();
+
+	UtfConvert(Utf8ToCodePtOnce<const char*>,
+		CodePtToMutf8Once<std::back_insert_iterator<std::string> >,
+		in.data(), in.data() + in.size(), std::back_inserter(out));
+}
+
+inline std::string Utf8ToMutf8(Internal::StrInputT<char> in)
+{
+	std::string resUtfStr;
+
+	Utf8ToMutf8(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+// ==========  MUTF-8 <--> UTF-16
+// MUTF-8 maps 1:1 onto UTF-16 code units, so these convert one code unit at
+// a time, without going through code points; like in Java, unpaired
+// surrogates are carried over as they are.
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline OutputIt Mutf8ToUtf16(InputIt begin, InputIt end, OutputIt dest)
+{
+	return Internal::Mutf8ToUtf16Impl(begin, end, dest);
+}
+
+inline void Mutf8ToUtf16(Internal::StrInputT<char> in, std::u16string& out)
+{
+	out.clear();
+
+	Internal::Mutf8ToUtf16AsciiFast(in.data(), in.data() + in.size(),
+		std::back_inserter(out));
+}
+
+inline std::u16string Mutf8ToUtf16(Internal::StrInputT<char> in)
+{
+	std::u16string resUtfStr;
+
+	Mutf8ToUtf16(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+template<typename InputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline size_t Mutf8ToUtf16GetSize(InputIt begin, InputIt end)
+{
+	size_t size = 0;
+	while (begin != end)
+	{
+		begin = Internal::Cesu8ToUtf16UnitOnce<true>(begin, end).second;
+		++size;
+	}
+	return size;
+}
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 2>::value, int> = 0>
+inline OutputIt Utf16ToMutf8(InputIt begin, InputIt end, OutputIt dest)
+{
+	for (; begin != end; ++begin)
+	{
+		const auto unit = Internal::EnsureByteSize<2>(*begin);
+		dest = Internal::Utf16UnitToCesu8Once<true>(
+			static_cast<char16_t>(Internal::BitCast2Unsigned(unit)), dest);
+	}
+	return dest;
+}
+
+inline void Utf16ToMutf8(Internal::StrInputT<char16_t> in, std::string& out)
+{
+	out.clear();
+
+	Utf16ToMutf8(in.data(), in.data() + in.size(), std::back_inserter(out));
+}
+
+inline std::string Utf16ToMutf8(Internal::StrInputT<char16_t> in)
+{
+	std::string resUtfStr;
+
+	Utf16ToMutf8(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+template<typename InputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 2>::value, int> = 0>
+inline size_t Utf16ToMutf8GetSize(InputIt begin, InputIt end)
+{
+	size_t size = 0;
+	for (; begin != end; ++begin)
+	{
+		const auto unit = Internal::EnsureByteSize<2>(*begin);
+		size += Internal::Utf16UnitToCesu8OnceGetSize<true>(
+			static_cast<char16_t>(Internal::BitCast2Unsigned(unit)));
+	}
+	return size;
+}
+
+} // namespace SimpleUtf
@@ -0,0 +1,678 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include <new>
+
+#include "Utf.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+/**
+ * @brief The storage classes of `CompactString`; the value is the number of
+ *        bytes per code point.
+ *
+ */
+enum class CompactStorage : uint8_t
+{
+	// U+0000 - U+00FF
+	Latin1 = 1,
+	// U+0000 - U+FFFF
+	Ucs2 = 2,
+	// all code points
+	Utf32 = 4,
+}; // enum class CompactStorage
+
+namespace Internal
+{
+
+/**
+ * @brief Finds the narrowest storage for a UTF-8 string by its leading
+ *        bytes only, 8 bytes at a time (SWAR); nothing is decoded.
+ *
+ */
+template<typename _ValType>
+inline CompactStorage CompactScanUtf8(const _ValType* begin, const _ValType* end)
+{
+	static constexpr uint64_t sk_highs = 0x8080808080808080ULL;
+
+	bool isWide = false;
+	const _ValType* ptr = begin;
+	for (; (end - ptr) >= 8; ptr += 8)
+	{
+		uint64_t word = 0;
+		std::memcpy(&word, ptr, sizeof(word));
+
+		// the high bit of a byte is set if the byte is 1111xxxx
+		const uint64_t four =
+			word & (word << 1) & (word << 2) & (word << 3) & sk_highs;
+		if (four != 0)
+		{
+			return CompactStorage::Utf32;
+		}
+
+		// ... if the byte is 11xxxxxx, but not 110000xx (U+0080 - U+00FF)
+		const uint64_t wide = word & (word << 1) &
+			((word << 2) | (word << 3) | (word << 4) | (word << 5)) &
+			sk_highs;
+		isWide = isWide || (wide != 0);
+	}
+	for (; ptr != end; ++ptr)
+	{
+		const uint8_t uval = static_cast<uint8_t>(BitCast2Unsigned(*ptr));
+		if (uval >= 0xF0U)
+		{
+			return CompactStorage::Utf32;
+		}
+		isWide = isWide || (uval >= 0xC4U);
+	}
+
+	return isWide ? CompactStorage::Ucs2 : CompactStorage::Latin1;
+}
+
+/**
+ * @brief Finds the narrowest storage for a UTF-16 string, 4 code units at a
+ *        time (SWAR); any surrogate means supplementary code points.
+ *
+ */
+inline CompactStorage CompactScanUtf16(
+	const char16_t* begin, const char16_t* end)
+{
+	static constexpr uint64_t sk_ones = 0x0001000100010001ULL;
+	static constexpr uint64_t sk_highs = 0x8000800080008000ULL;
+	static constexpr uint64_t sk_surrogateMask = 0xF800F800F800F800ULL;
+	static constexpr uint64_t sk_surrogates = 0xD800D800D800D800ULL;
+	static constexpr uint64_t sk_nonLatin1Mask = 0xFF00FF00FF00FF00ULL;
+
+	uint64_t bits = 0;
+	const char16_t* ptr = begin;
+	for (; (end - ptr) >= 4; ptr += 4)
+	{
+		uint64_t word = 0;
+		std::memcpy(&word, ptr, sizeof(word));
+		bits |= word;
+
+		// a lane is zero where the code unit is a surrogate
+		const uint64_t x = (word & sk_surrogateMask) ^ sk_surrogates;
+		if (((x - sk_ones) & ~x & sk_highs) != 0)
+		{
+			return CompactStorage::Utf32;
+		}
+	}
+	for (; ptr != end; ++ptr)
+	{
+		if ((*ptr & 0xF800U) == 0xD800U)
+		{
+			return CompactStorage::Utf32;
+		}
+		bits |= *ptr;
+	}
+
+	return ((bits & sk_nonLatin1Mask) != 0) ?
+		CompactStorage::Ucs2 : CompactStorage::Latin1;
+}
+
+/**
+ * @brief Finds the narrowest storage for a UTF-32 string, and validates it
+ *
+ */
+inline CompactStorage CompactScanUtf32(
+	const char32_t* begin, const char32_t* end)
+{
+	char32_t bits = 0;
+	for (const char32_t* ptr = begin; ptr != end; ++ptr)
+	{
+		if (!IsValidUtfCodePt(*ptr))
+		{
+			SIMPLEUTF_STATS_ADD(ErrInvalidCodePoint, 1);
+			throw UtfConversionException("Invalid Code Point" " - "
+				"The given UTF-32 string contains an invalid code point.");
+		}
+		bits |= *ptr;
+	}
+
+	return (bits > 0xFFFFU) ? CompactStorage::Utf32 :
+		((bits > 0xFFU) ? CompactStorage::Ucs2 : CompactStorage::Latin1);
+}
+
+/**
+ * @brief Stores a code point that fits in the storage unit
+ *
+ */
+template<typename _UnitType>
+inline _UnitType CompactNarrow(char32_t val)
+{
+	return static_cast<_UnitType>(val);
+}
+
+template<>
+inline char CompactNarrow<char>(char32_t val)
+{
+	return BitCast<char>(static_cast<uint8_t>(val));
+}
+
+template<typename _UnitType>
+inline char32_t CompactWiden(_UnitType val)
+{
+	return static_cast<char32_t>(BitCast2Unsigned(val));
+}
+
+/**
+ * @brief Decodes UTF-8 into a storage that is wide enough (see
+ *        `CompactScanUtf8`); runs of ASCII characters are copied directly.
+ *
+ */
+template<typename _UnitType, typename _ValType>
+inline void CompactFromUtf8(const _ValType* begin, const _ValType* end,
+	std::basic_string<_UnitType>& out)
+{
+	// each code point takes at least one byte
+	out.resize(static_cast<size_t>(end - begin));
+	_UnitType* dest = &out[0];
+
+	while (begin != end)
+	{
+		const size_t numAscii = CountAsciiPrefix(begin, end);
+		for (size_t i = 0; i < numAscii; ++i)
+		{
+			dest[i] = static_cast<_UnitType>(begin[i]);
+		}
+		begin += numAscii;
+		dest += numAscii;
+
+		if (begin != end)
+		{
+			auto codePtRes = Utf8ToCodePtOnce(begin, end);
+			*dest = CompactNarrow<_UnitType>(codePtRes.first);
+			++dest;
+			begin = codePtRes.second;
+		}
+	}
+
+	out.resize(static_cast<size_t>(dest - out.data()));
+}
+
+/**
+ * @brief Narrows code units or code points that are known to fit into the
+ *        storage, without decoding them
+ *
+ */
+template<typename _UnitType, typename _ValType>
+inline void CompactNarrowCopy(const _ValType* begin, const _ValType* end,
+	std::basic_string<_UnitType>& out)
+{
+	out.resize(static_cast<size_t>(end - begin));
+	_UnitType* dest = &out[0];
+	for (; begin != end; ++begin, ++dest)
+	{
+		*dest = CompactNarrow<_UnitType>(*begin);
+	}
+}
+
+/**
+ * @brief Encodes the stored code points into UTF-8, in two passes: the
+ *        size of the output first, and then the output, with no validation,
+ *        since the stored code points are all valid.
+ *
+ */
+template<typename _UnitType>
+inline void CompactToUtf8(const _UnitType* begin, const _UnitType* end,
+	std::string& out)
+{
+	size_t size = 0;
+	for (const _UnitType* ptr = begin; ptr != end; ++ptr)
+	{
+		const char32_t val = CompactWiden(*ptr);
+		size += 1 +
+			static_cast<size_t>(val >= 0x80U) +
+			static_cast<size_t>(val >= 0x800U) +
+			static_cast<size_t>(val >= 0x10000U);
+	}
+
+	out.resize(size);
+	char* dest = &out[0];
+	auto putByte = [&dest](char32_t val)
+	{
+		*dest = BitCast<char>(static_cast<uint8_t>(val));
+		++dest;
+	};
+	for (const _UnitType* ptr = begin; ptr != end; ++ptr)
+	{
+		const char32_t val = CompactWiden(*ptr);
+		if (val < 0x80U)
+		{
+			putByte(val);
+		}
+		else if (val < 0x800U)
+		{
+			putByte(0xC0U | (val >> 6));
+			putByte(0x80U | (val & 0x3FU));
+		}
+		else if (val < 0x10000U)
+		{
+			putByte(0xE0U | (val >> 12));
+			putByte(0x80U | ((val >> 6) & 0x3FU));
+			putByte(0x80U | (val & 0x3FU));
+		}
+		else
+		{
+			putByte(0xF0U | (val >> 18));
+			putByte(0x80U | ((val >> 12) & 0x3FU));
+			putByte(0x80U | ((val >> 6) & 0x3FU));
+			putByte(0x80U | (val & 0x3FU));
+		}
+	}
+}
+
+/**
+ * @brief Encodes the stored code points into UTF-16; for Latin-1 and UCS-2
+ *        storages, it's a plain widening copy.
+ *
+ */
+template<typename _UnitType>
+inline void CompactToUtf16(const _UnitType* begin, const _UnitType* end,
+	std::u16string& out)
+{
+	size_t size = static_cast<size_t>(end - begin);
+	for (const _UnitType* ptr = begin; ptr != end; ++ptr)
+	{
+		size += static_cast<size_t>(CompactWiden(*ptr) >= 0x10000U);
+	}
+
+	out.resize(size);
+	char16_t* dest = &out[0];
+	for (const _UnitType* ptr = begin; ptr != end; ++ptr)
+	{
+		const char32_t val = CompactWiden(*ptr);
+		if (val < 0x10000U)
+		{
+			*dest++ = static_cast<char16_t>(val);
+		}
+		else
+		{
+			const char32_t sup = val - 0x10000U;
+			*dest++ = static_cast<char16_t>(0xD800U + (sup >> 10));
+			*dest++ = static_cast<char16_t>(0xDC00U + (sup & 0x3FFU));
+		}
+	}
+}
+
+template<typename _UnitType>
+inline void CompactToUtf32(const _UnitType* begin, const _UnitType* end,
+	std::u32string& out)
+{
+	out.resize(static_cast<size_t>(end - begin));
+	char32_t* dest = &out[0];
+	for (; begin != end; ++begin, ++dest)
+	{
+		*dest = CompactWiden(*begin);
+	}
+}
+
+} // namespace Internal
+
+/**
+ * @brief An immutable string of code points, stored in the narrowest
+ *        fixed-width form that can hold all of them - 1, 2, or 4 bytes per
+ *        code point (like the strings in CPython, PEP 393) - so the code
+ *        points can be indexed in constant time.
+ *
+ */
+class CompactString
+{
+public:
+
+	CompactString() :
+		m_storage(CompactStorage::Latin1),
+		m_latin1()
+	{}
+
+	/**
+	 * @brief Builds from UTF-8; the storage is chosen by a scan of the
+	 *        leading bytes, before the string is decoded into it.
+	 *
+	 * @exception UtfConversionException if the input is not valid UTF-8
+	 */
+	explicit CompactString(Internal::StrInputT<char> utf8) :
+		CompactString()
+	{
+		const char* begin = utf8.data();
+		const char* end = begin + utf8.size();
+
+		Reset(Internal::CompactScanUtf8(begin, end));
+		switch (m_storage)
+		{
+		case CompactStorage::Latin1:
+			Internal::CompactFromUtf8(begin, end, m_latin1);
+			break;
+		case CompactStorage::Ucs2:
+			Internal::CompactFromUtf8(begin, end, m_ucs2);
+			break;
+		case CompactStorage::Utf32:
+		default:
+			Utf8ToUtf32(utf8, m_utf32);
+			break;
+		}
+	}
+
+	/**
+	 * @brief Builds from UTF-16; only strings with surrogates are decoded.
+	 *
+	 * @exception UtfConversionException if the input is not valid UTF-16
+	 */
+	explicit CompactString(Internal::StrInputT<char16_t> utf16) :
+		CompactString()
+	{
+		const char16_t* begin = utf16.data();
+		const char16_t* end = begin + utf16.size();
+
+		Reset(Internal::CompactScanUtf16(begin, end));
+		switch (m_storage)
+		{
+		case CompactStorage::Latin1:
+			Internal::CompactNarrowCopy(begin, end, m_latin1);
+			break;
+		case CompactStorage::Ucs2:
+			m_ucs2.assign(begin, end);
+			break;
+		case CompactStorage::Utf32:
+		default:
+			Utf16ToUtf32(utf16, m_utf32);
+			break;
+		}
+	}
+
+	/**
+	 * @brief Builds from UTF-32
+	 *
+	 * @exception UtfConversionException if the input contains invalid code
+	 *            points
+	 */
+	explicit CompactString(Internal::StrInputT<char32_t> utf32) :
+		CompactString()
+	{
+		const char32_t* begin = utf32.data();
+		const char32_t* end = begin + utf32.size();
+
+		Reset(Internal::CompactScanUtf32(begin, end));
+		switch (m_storage)
+		{
+		case CompactStorage::Latin1:
+			Internal::CompactNarrowCopy(begin, end, m_latin1);
+			break;
+		case CompactStorage::Ucs2:
+			Internal::CompactNarrowCopy(begin, end, m_ucs2);
+			break;
+		case CompactStorage::Utf32:
+		default:
+			m_utf32.assign(begin, end);
+			break;
+		}
+	}
+
+	CompactString(const CompactString& other) :
+		CompactString()
+	{
+		*this = other;
+	}
+
+	CompactString(CompactString&& other) noexcept :
+		CompactString()
+	{
+		*this = std::move(other);
+	}
+
+	~CompactString()
+	{
+		Destroy();
+	}
+
+	CompactString& operator=(const CompactString& other)
+	{
+		if (this != &other)
+		{
+			Reset(other.m_storage);
+			switch (m_storage)
+			{
+			case CompactStorage::Latin1:
+				m_latin1 = other.m_latin1;
+				break;
+			case CompactStorage::Ucs2:
+				m_ucs2 = other.m_ucs2;
+				break;
+			case CompactStorage::Utf32:
+			default:
+				m_utf32 = other.m_utf32;
+				break;
+			}
+		}
+		return *this;
+	}
+
+	CompactString& operator=(CompactString&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset(other.m_storage);
+			switch (m_storage)
+			{
+			case CompactStorage::Latin1:
+				m_latin1 = std::move(other.m_latin1);
+				break;
+			case CompactStorage::Ucs2:
+				m_ucs2 = std::move(other.m_ucs2);
+				break;
+			case CompactStorage::Utf32:
+			default:
+				m_utf32 = std::move(other.m_utf32);
+				break;
+			}
+		}
+		return *this;
+	}
+
+	CompactStorage GetStorage() const
+	{
+		return m_storage;
+	}
+
+	/**
+	 * @brief The number of code points
+	 *
+	 */
+	size_t GetSize() const
+	{
+		switch (m_storage)
+		{
+		case CompactStorage::Latin1:
+			return m_latin1.size();
+		case CompactStorage::Ucs2:
+			return m_ucs2.size();
+		case CompactStorage::Utf32:
+		default:
+			return m_utf32.size();
+		}
+	}
+
+	bool IsEmpty() const
+	{
+		return GetSize() == 0;
+	}
+
+	/**
+	 * @brief The number of bytes used to store the code points
+	 *
+	 */
+	size_t GetStorageSize() const
+	{
+		return GetSize() * static_cast<size_t>(m_storage);
+	}
+
+	/**
+	 * @brief The code point at the given index; it's not bound-checked.
+	 *
+	 */
+	char32_t operator[](size_t idx) const
+	{
+		switch (m_storage)
+		{
+		case CompactStorage::Latin1:
+			return Internal::CompactWiden(m_latin1[idx]);
+		case CompactStorage::Ucs2:
+			return m_ucs2[idx];
+		case CompactStorage::Utf32:
+		default:
+			return m_utf32[idx];
+		}
+	}
+
+	void ToUtf8(std::string& out) const
+	{
+		switch (m_storage)
+		{
+		case CompactStorage::Latin1:
+			Internal::CompactToUtf8(m_latin1.data(),
+				m_latin1.data() + m_latin1.size(), out);
+			break;
+		case CompactStorage::Ucs2:
+			Internal::CompactToUtf8(m_ucs2.data(),
+				m_ucs2.data() + m_ucs2.size(), out);
+			break;
+		case CompactStorage::Utf32:
+		default:
+			Internal::CompactToUtf8(m_utf32.data(),
+				m_utf32.data() + m_utf32.size(), out);
+			break;
+		}
+	}
+
+	std::string ToUtf8() const
+	{
+		std::string resUtfStr;
+
+		ToUtf8(resUtfStr);
+
+		return resUtfStr;
+	}
+
+	void ToUtf16(std::u16string& out) const
+	{
+		switch (m_storage)
+		{
+		case CompactStorage::Latin1:
+			Internal::CompactToUtf16(m_latin1.data(),
+				m_latin1.data() + m_latin1.size(), out);
+			break;
+		case CompactStorage::Ucs2:
+			out = m_ucs2;
+			break;
+		case CompactStorage::Utf32:
+		default:
+			Internal::CompactToUtf16(m_utf32.data(),
+				m_utf32.data() + m_utf32.size(), out);
+			break;
+		}
+	}
+
+	std::u16string ToUtf16() const
+	{
+		std::u16string resUtfStr;
+
+		ToUtf16(resUtfStr);
+
+		return resUtfStr;
+	}
+
+	void ToUtf32(std::u32string& out) const
+	{
+		switch (m_storage)
+		{
+		case CompactStorage::Latin1:
+			Internal::CompactToUtf32(m_latin1.data(),
+				m_latin1.data() + m_latin1.size(), out);
+			break;
+		case CompactStorage::Ucs2:
+			Internal::CompactToUtf32(m_ucs2.data(),
+				m_ucs2.data() + m_ucs2.size(), out);
+			break;
+		case CompactStorage::Utf32:
+		default:
+			out = m_utf32;
+			break;
+		}
+	}
+
+	std::u32string ToUtf32() const
+	{
+		std::u32string resUtfStr;
+
+		ToUtf32(resUtfStr);
+
+		return resUtfStr;
+	}
+
+private:
+
+	using Latin1Str = std::string;
+	using Ucs2Str = std::u16string;
+	using Utf32Str = std::u32string;
+
+	void Destroy() noexcept
+	{
+		switch (m_storage)
+		{
+		case CompactStorage::Latin1:
+			m_latin1.~Latin1Str();
+			break;
+		case CompactStorage::Ucs2:
+			m_ucs2.~Ucs2Str();
+			break;
+		case CompactStorage::Utf32:
+		default:
+			m_utf32.~Utf32Str();
+			break;
+		}
+	}
+
+	/**
+	 * @brief Replaces the content with an empty string of the given storage
+	 *
+	 */
+	void Reset(CompactStorage storage) noexcept
+	{
+		Destroy();
+		m_storage = storage;
+		switch (m_storage)
+		{
+		case CompactStorage::Latin1:
+			new (&m_latin1) Latin1Str();
+			break;
+		case CompactStorage::Ucs2:
+			new (&m_ucs2) Ucs2Str();
+			break;
+		case CompactStorage::Utf32:
+		default:
+			new (&m_utf32) Utf32Str();
+			break;
+		}
+	}
+
+	CompactStorage m_storage;
+	// only the member for `m_storage` is alive
+	union
+	{
+		Latin1Str m_latin1;
+		Ucs2Str m_ucs2;
+		Utf32Str m_utf32;
+	};
+}; // class CompactString
+
+} // namespace SimpleUtf
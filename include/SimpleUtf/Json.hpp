@@ -0,0 +1,412 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include "Utf.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+// Conversions between UTF-8 and the content of JSON string literals
+// (without the surrounding quotes), as defined in RFC 8259.
+// Both directions validate the UTF-8 in the same pass, and copy runs of
+// characters that need no escaping directly.
+
+namespace Internal
+{
+
+/**
+ * @brief Is the given byte one that can be copied as it is between a JSON
+ *        string and UTF-8? i.e., an ASCII character other than `"`, `\`,
+ *        and the control characters.
+ *
+ */
+template<typename _ValType>
+inline bool IsJsonPlain(const _ValType& val)
+{
+	const auto uval = BitCast2Unsigned(val);
+	return (0x20U <= uval) && (uval < 0x80U) &&
+		(uval != 0x22U) && (uval != 0x5CU);
+}
+
+/**
+ * @brief Skips the characters at the beginning of [begin, end) that need no
+ *        escaping (see `IsJsonPlain`).
+ *
+ */
+template<typename InputIt>
+inline InputIt SkipJsonPlain(InputIt begin, InputIt end)
+{
+	while ((begin != end) && IsJsonPlain(*begin))
+	{
+		++begin;
+	}
+	return begin;
+}
+
+/**
+ * @brief `SkipJsonPlain` for 1-byte code units in contiguous memory;
+ *        the input is tested 8 bytes at a time while there is nothing to
+ *        escape (SWAR - SIMD within a register), and then byte by byte.
+ *
+ */
+template<typename _ValType,
+	EnableIfT<
+		IsIntegral<_ValType>::value &&
+		(sizeof(_ValType) == 1)
+		, int> = 0>
+inline const _ValType* SkipJsonPlain(const _ValType* begin, const _ValType* end)
+{
+	static constexpr uint64_t sk_ones = 0x0101010101010101ULL;
+	static constexpr uint64_t sk_highs = 0x8080808080808080ULL;
+
+	const _ValType* ptr = begin;
+	for (; (end - ptr) >= 8; ptr += 8)
+	{
+		uint64_t word = 0;
+		std::memcpy(&word, ptr, sizeof(word));
+
+		const uint64_t quote = word ^ (sk_ones * 0x22U);
+		const uint64_t backslash = word ^ (sk_ones * 0x5CU);
+		// the high bit of a byte is set if the byte is less than 0x20, is
+		// zero after the XOR above, or is not ASCII
+		// (false positives only happen after a true positive)
+		const uint64_t special =
+			((word - (sk_ones * 0x20U)) & ~word) |
+			((quote - sk_ones) & ~quote) |
+			((backslash - sk_ones) & ~backslash) |
+			word;
+		if ((special & sk_highs) != 0)
+		{
+			break;
+		}
+	}
+	while ((ptr != end) && IsJsonPlain(*ptr))
+	{
+		++ptr;
+	}
+
+	SIMPLEUTF_STATS_ADD(AsciiFastPathBytes, ptr - begin);
+
+	return ptr;
+}
+
+inline uint8_t JsonReadHexDigit(uint8_t c)
+{
+	if ('0' <= c && c <= '9')
+	{
+		return static_cast<uint8_t>(c - '0');
+	}
+	if ('a' <= c && c <= 'f')
+	{
+		return static_cast<uint8_t>(c - 'a' + 10);
+	}
+	if ('A' <= c && c <= 'F')
+	{
+		return static_cast<uint8_t>(c - 'A' + 10);
+	}
+
+	SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+	throw UtfConversionException("Invalid JSON String" " - "
+		"Invalid hex digit in a \\u escape.");
+}
+
+/**
+ * @brief Reads the 4 hex digits of a `\uXXXX` escape
+ *
+ */
+template<typename InputIt>
+inline std::pair<char16_t, InputIt> JsonReadHex4(InputIt begin, InputIt end)
+{
+	char16_t res = 0;
+	for (size_t i = 0; i < 4; ++i)
+	{
+		if (begin == end)
+		{
+			SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
+			throw UtfConversionException("Unexpected Ending" " - "
+				"String ends unexpected while reading a \\u escape.");
+		}
+
+		const auto c = EnsureByteSize<1>(*begin);
+		++begin;
+		res = static_cast<char16_t>((res << 4) |
+			JsonReadHexDigit(static_cast<uint8_t>(BitCast2Unsigned(c))));
+	}
+	return std::make_pair(res, begin);
+}
+
+template<typename OutputIt>
+inline OutputIt JsonWriteUnitEscape(char16_t unit, OutputIt dest)
+{
+	static constexpr char sk_hex[] = "0123456789abcdef";
+
+	const char res[6] = {
+		'\\', 'u',
+		sk_hex[(unit >> 12) & 0xFU],
+		sk_hex[(unit >> 8) & 0xFU],
+		sk_hex[(unit >> 4) & 0xFU],
+		sk_hex[unit & 0xFU],
+	};
+	return std::copy(std::begin(res), std::end(res), dest);
+}
+
+/**
+ * @brief Writes out the high surrogate left over from the last `\uXXXX`
+ *        escape, if there is any; it's only accepted under `WtfPolicy`.
+ *
+ */
+template<typename _Policy, typename OutputIt>
+inline OutputIt JsonFlushHighSurrogate(char16_t& pending, OutputIt dest)
+{
+	if (pending != 0)
+	{
+		dest = CodePtToUtf8Once<OutputIt, _Policy>(pending, dest);
+		pending = 0;
+	}
+	return dest;
+}
+
+} // namespace Internal
+
+// ==========  JSON string --> UTF-8
+
+/**
+ * @brief Unescapes the content of a JSON string literal into UTF-8.
+ *        `\uXXXX` escapes of surrogate pairs are joined, and encoded
+ *        directly into UTF-8; raw UTF-8 sequences are validated as they are
+ *        copied.
+ *        Unpaired surrogates (escaped, or in the UTF-8) are only accepted
+ *        under `WtfPolicy`, and are written out as WTF-8.
+ *
+ */
+template<typename InputIt, typename OutputIt, typename _Policy = UtfStrictPolicy,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline OutputIt JsonUnescapeToUtf8(InputIt begin, InputIt end, OutputIt dest)
+{
+	char16_t pendingHigh = 0;
+
+	while (true)
+	{
+		InputIt plainEnd = Internal::SkipJsonPlain(begin, end);
+		if ((plainEnd != begin) || (plainEnd == end))
+		{
+			dest = Internal::JsonFlushHighSurrogate<_Policy>(pendingHigh, dest);
+			dest = std::copy(begin, plainEnd, dest);
+			begin = plainEnd;
+		}
+
+		if (begin == end)
+		{
+			return dest;
+		}
+
+		const auto leading = Internal::EnsureByteSize<1>(*begin);
+		const uint8_t uval =
+			static_cast<uint8_t>(Internal::BitCast2Unsigned(leading));
+
+		if (uval >= 0x80U)
+		{
+			dest = Internal::JsonFlushHighSurrogate<_Policy>(pendingHigh, dest);
+			auto res = Utf8ToCodePtOnce<InputIt, _Policy>(begin, end);
+			dest = CodePtToUtf8Once<OutputIt, _Policy>(res.first, dest);
+			begin = res.second;
+			continue;
+		}
+
+		if (uval != '\\')
+		{
+			SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+			throw UtfConversionException("Invalid JSON String" " - "
+				"Unescaped quotation mark or control character.");
+		}
+
+		++begin;
+		if (begin == end)
+		{
+			SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
+			throw UtfConversionException("Unexpected Ending" " - "
+				"String ends unexpected while reading an escape.");
+		}
+		const auto escaped = Internal::EnsureByteSize<1>(*begin);
+		++begin;
+
+		char simple = 0;
+		switch (Internal::BitCast2Unsigned(escaped))
+		{
+		case '"':  simple = '"';  break;
+		case '\\': simple = '\\'; break;
+		case '/':  simple = '/';  break;
+		case 'b':  simple = '\b'; break;
+		case 'f':  simple = '\f'; break;
+		case 'n':  simple = '\n'; break;
+		case 'r':  simple = '\r'; break;
+		case 't':  simple = '\t'; break;
+		case 'u':
+		{
+			auto hexRes = Internal::JsonReadHex4(begin, end);
+			const char16_t unit = hexRes.first;
+			begin = hexRes.second;
+
+			if ((pendingHigh != 0) && Internal::IsUtf16SurrogateSecond(unit))
+			{
+				char32_t codePt = 0x10000U;
+				codePt += static_cast<char32_t>((pendingHigh & 0x03FFU) << 10);
+				codePt += static_cast<char32_t>((unit & 0x03FFU));
+				pendingHigh = 0;
+				dest = CodePtToUtf8Once<OutputIt, _Policy>(codePt, dest);
+			}
+			else
+			{
+				dest = Internal::JsonFlushHighSurrogate<_Policy>(
+					pendingHigh, dest);
+				if (Internal::IsUtf16SurrogateFirst(unit))
+				{
+					pendingHigh = unit;
+				}
+				else
+				{
+					dest = CodePtToUtf8Once<OutputIt, _Policy>(unit, dest);
+				}
+			}
+			continue;
+		}
+		default:
+			SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+			throw UtfConversionException("Invalid JSON String" " - "
+				"Invalid escape sequence.");
+		}
+
+		dest = Internal::JsonFlushHighSurrogate<_Policy>(pendingHigh, dest);
+		*dest = simple;
+		++dest;
+	}
+}
+
+inline void JsonUnescapeToUtf8(Internal::StrInputT<char> in, std::string& out)
+{
+	out.clear();
+	out.reserve(in.size());
+
+	JsonUnescapeToUtf8(in.data(), in.data() + in.size(),
+		std::back_inserter(out));
+}
+
+inline std::string JsonUnescapeToUtf8(Internal::StrInputT<char> in)
+{
+	std::string resUtfStr;
+
+	JsonUnescapeToUtf8(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+// ==========  UTF-8 --> JSON string
+
+/**
+ * @brief Escapes UTF-8 into the content of a JSON string literal.
+ *        `"`, `\`, and the control characters are always escaped;
+ *        if `escapeNonAscii` is true, characters outside of ASCII are
+ *        written as `\uXXXX` escapes (surrogate pairs for supplementary
+ *        characters), computed directly from the decoded code points.
+ *
+ */
+template<typename InputIt, typename OutputIt, typename _Policy = UtfStrictPolicy,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline OutputIt Utf8ToJsonEscaped(InputIt begin, InputIt end, OutputIt dest,
+	bool escapeNonAscii = false)
+{
+	while (true)
+	{
+		InputIt plainEnd = Internal::SkipJsonPlain(begin, end);
+		dest = std::copy(begin, plainEnd, dest);
+		begin = plainEnd;
+
+		if (begin == end)
+		{
+			return dest;
+		}
+
+		const auto leading = Internal::EnsureByteSize<1>(*begin);
+		const uint8_t uval =
+			static_cast<uint8_t>(Internal::BitCast2Unsigned(leading));
+
+		if (uval >= 0x80U)
+		{
+			auto res = Utf8ToCodePtOnce<InputIt, _Policy>(begin, end);
+			begin = res.second;
+
+			if (!escapeNonAscii)
+			{
+				dest = CodePtToUtf8Once<OutputIt, _Policy>(res.first, dest);
+			}
+			else if (res.first <= 0xFFFFU)
+			{
+				dest = Internal::JsonWriteUnitEscape(
+					static_cast<char16_t>(res.first), dest);
+			}
+			else
+			{
+				const char32_t code = (res.first - 0x10000U);
+				dest = Internal::JsonWriteUnitEscape(
+					static_cast<char16_t>(0xD800U | (code >> 10)), dest);
+				dest = Internal::JsonWriteUnitEscape(
+					static_cast<char16_t>(0xDC00U | (code & 0x3FFU)), dest);
+			}
+			continue;
+		}
+
+		++begin;
+
+		char simple = 0;
+		switch (uval)
+		{
+		case '"':  simple = '"'; break;
+		case '\\': simple = '\\'; break;
+		case '\b': simple = 'b'; break;
+		case '\f': simple = 'f'; break;
+		case '\n': simple = 'n'; break;
+		case '\r': simple = 'r'; break;
+		case '\t': simple = 't'; break;
+		default:
+			dest = Internal::JsonWriteUnitEscape(uval, dest);
+			continue;
+		}
+
+		*dest = '\\';
+		++dest;
+		*dest = simple;
+		++dest;
+	}
+}
+
+inline void Utf8ToJsonEscaped(Internal::StrInputT<char> in, std::string& out,
+	bool escapeNonAscii = false)
+{
+	out.clear();
+	out.reserve(in.size());
+
+	Utf8ToJsonEscaped(in.data(), in.data() + in.size(),
+		std::back_inserter(out), escapeNonAscii);
+}
+
+inline std::string Utf8ToJsonEscaped(Internal::StrInputT<char> in,
+	bool escapeNonAscii = false)
+{
+	std::string resUtfStr;
+
+	Utf8ToJsonEscaped(in, resUtfStr, escapeNonAscii);
+
+	return resUtfStr;
+}
+
+} // namespace SimpleUtf
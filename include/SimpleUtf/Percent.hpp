@@ -0,0 +1,419 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include "Utf.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+// Percent-encoding (RFC 3986) of UTF-8 strings, as used in URLs.
+// Decoding validates the decoded UTF-8 in the same pass; encoding escapes
+// every byte outside of the unreserved set (ALPHA / DIGIT / "-" / "." /
+// "_" / "~").
+// If `plusAsSpace` is true, "+" stands for a space, as in
+// application/x-www-form-urlencoded.
+
+namespace Internal
+{
+
+inline bool IsUrlUnreserved(uint8_t c)
+{
+	return (('A' <= c) && (c <= 'Z')) ||
+		(('a' <= c) && (c <= 'z')) ||
+		(('0' <= c) && (c <= '9')) ||
+		(c == '-') || (c == '.') || (c == '_') || (c == '~');
+}
+
+/**
+ * @brief Is the given byte one that can be copied as it is while decoding?
+ *        i.e., an ASCII character other than `%` (and `+`, if
+ *        `plusAsSpace` is true).
+ *
+ */
+template<typename _ValType>
+inline bool IsPercentPlain(const _ValType& val, bool plusAsSpace)
+{
+	const auto uval = BitCast2Unsigned(val);
+	return (uval < 0x80U) && (uval != '%') && (!plusAsSpace || (uval != '+'));
+}
+
+template<typename InputIt>
+inline InputIt SkipPercentPlain(InputIt begin, InputIt end, bool plusAsSpace)
+{
+	while ((begin != end) && IsPercentPlain(*begin, plusAsSpace))
+	{
+		++begin;
+	}
+	return begin;
+}
+
+/**
+ * @brief `SkipPercentPlain` for 1-byte code units in contiguous memory;
+ *        the input is tested 8 bytes at a time while there is nothing to
+ *        decode (SWAR - SIMD within a register), and then byte by byte.
+ *
+ */
+template<typename _ValType,
+	EnableIfT<
+		IsIntegral<_ValType>::value &&
+		(sizeof(_ValType) == 1)
+		, int> = 0>
+inline const _ValType* SkipPercentPlain(
+	const _ValType* begin, const _ValType* end, bool plusAsSpace)
+{
+	static constexpr uint64_t sk_ones = 0x0101010101010101ULL;
+	static constexpr uint64_t sk_highs = 0x8080808080808080ULL;
+
+	const uint64_t plus = sk_ones * (plusAsSpace ? 0x2BU : 0x25U);
+
+	const _ValType* ptr = begin;
+	for (; (end - ptr) >= 8; ptr += 8)
+	{
+		uint64_t word = 0;
+		std::memcpy(&word, ptr, sizeof(word));
+
+		const uint64_t percent = word ^ (sk_ones * 0x25U);
+		const uint64_t plusDiff = word ^ plus;
+		// the high bit of a byte is set if the byte is zero after the XOR
+		// above, or is not ASCII
+		// (false positives only happen after a true positive)
+		const uint64_t special =
+			((percent - sk_ones) & ~percent) |
+			((plusDiff - sk_ones) & ~plusDiff) |
+			word;
+		if ((special & sk_highs) != 0)
+		{
+			break;
+		}
+	}
+	while ((ptr != end) && IsPercentPlain(*ptr, plusAsSpace))
+	{
+		++ptr;
+	}
+
+	SIMPLEUTF_STATS_ADD(AsciiFastPathBytes, ptr - begin);
+
+	return ptr;
+}
+
+inline uint8_t PercentReadHexDigit(uint8_t c)
+{
+	if ('0' <= c && c <= '9')
+	{
+		return static_cast<uint8_t>(c - '0');
+	}
+	if ('a' <= c && c <= 'f')
+	{
+		return static_cast<uint8_t>(c - 'a' + 10);
+	}
+	if ('A' <= c && c <= 'F')
+	{
+		return static_cast<uint8_t>(c - 'A' + 10);
+	}
+
+	SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+	throw UtfConversionException("Invalid Percent-Encoding" " - "
+		"Invalid hex digit after %.");
+}
+
+/**
+ * @brief An iterator that reads the bytes of a percent-encoded string,
+ *        decoding `%XX` triplets on the fly, so the UTF-8 decoder can read
+ *        a sequence that mixes raw and escaped bytes directly.
+ *
+ */
+template<typename _ItType>
+class PercentDecodeIt
+{
+public:
+
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = char;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const char*;
+	using reference = char;
+
+	PercentDecodeIt(_ItType it, _ItType end) :
+		m_it(it),
+		m_end(end)
+	{}
+
+	char operator*() const
+	{
+		_ItType it = m_it;
+		const uint8_t c = ReadByte(it);
+		if (c != '%')
+		{
+			return BitCast<char>(c);
+		}
+
+		const uint8_t high = PercentReadHexDigit(ReadByte(++it));
+		const uint8_t low = PercentReadHexDigit(ReadByte(++it));
+		return BitCast<char>(static_cast<uint8_t>((high << 4) | low));
+	}
+
+	PercentDecodeIt& operator++()
+	{
+		const bool isEscaped = (ReadByte(m_it) == '%');
+		++m_it;
+		if (isEscaped)
+		{
+			// the two hex digits have been checked by operator*
+			++m_it;
+			++m_it;
+		}
+		return *this;
+	}
+
+	bool operator==(const PercentDecodeIt& other) const
+	{
+		return m_it == other.m_it;
+	}
+
+	bool operator!=(const PercentDecodeIt& other) const
+	{
+		return m_it != other.m_it;
+	}
+
+	const _ItType& Base() const
+	{
+		return m_it;
+	}
+
+private:
+
+	uint8_t ReadByte(const _ItType& it) const
+	{
+		if (it == m_end)
+		{
+			SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
+			throw UtfConversionException("Unexpected Ending" " - "
+				"String ends unexpected while reading a % escape.");
+		}
+		return static_cast<uint8_t>(BitCast2Unsigned(EnsureByteSize<1>(*it)));
+	}
+
+	_ItType m_it;
+	_ItType m_end;
+}; // class PercentDecodeIt
+
+template<typename OutputIt>
+inline OutputIt PercentWriteByte(uint8_t c, OutputIt dest)
+{
+	static constexpr char sk_hex[] = "0123456789ABCDEF";
+
+	const char res[3] = { '%', sk_hex[c >> 4], sk_hex[c & 0xFU] };
+	return std::copy(std::begin(res), std::end(res), dest);
+}
+
+/**
+ * @brief Percent-encodes the UTF-8 encoding of a single code point
+ *
+ */
+template<typename _Policy, typename OutputIt>
+inline OutputIt PercentEncodeCodePt(char32_t val, OutputIt dest)
+{
+	char buf[4] = { 0, 0, 0, 0 };
+	char* bufEnd = CodePtToUtf8Once<char*, _Policy>(val, buf);
+	for (const char* it = buf; it != bufEnd; ++it)
+	{
+		dest = PercentWriteByte(BitCast<uint8_t>(*it), dest);
+	}
+	return dest;
+}
+
+template<typename OutputIt>
+inline OutputIt PercentEncodeAscii(uint8_t c, OutputIt dest, bool plusAsSpace)
+{
+	if (IsUrlUnreserved(c))
+	{
+		*dest = static_cast<char>(c);
+		++dest;
+	}
+	else if (plusAsSpace && (c == ' '))
+	{
+		*dest = '+';
+		++dest;
+	}
+	else
+	{
+		dest = PercentWriteByte(c, dest);
+	}
+	return dest;
+}
+
+} // namespace Internal
+
+// ==========  Percent-encoded --> UTF-8
+
+/**
+ * @brief Decodes a percent-encoded string, and validates the decoded UTF-8
+ *        in the same pass; UTF-8 sequences may be any mix of raw and `%XX`
+ *        bytes.
+ *
+ */
+template<typename InputIt, typename OutputIt, typename _Policy = UtfStrictPolicy,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline OutputIt PercentDecodeUtf8(InputIt begin, InputIt end, OutputIt dest,
+	bool plusAsSpace = false)
+{
+	using DecodeIt = Internal::PercentDecodeIt<InputIt>;
+
+	while (true)
+	{
+		InputIt plainEnd = Internal::SkipPercentPlain(begin, end, plusAsSpace);
+		dest = std::copy(begin, plainEnd, dest);
+		begin = plainEnd;
+
+		if (begin == end)
+		{
+			return dest;
+		}
+
+		if (Internal::BitCast2Unsigned(*begin) == '+')
+		{
+			*dest = ' ';
+			++dest;
+			++begin;
+			continue;
+		}
+
+		auto res = Utf8ToCodePtOnce<DecodeIt, _Policy>(
+			DecodeIt(begin, end), DecodeIt(end, end));
+		dest = CodePtToUtf8Once<OutputIt, _Policy>(res.first, dest);
+		begin = res.second.Base();
+	}
+}
+
+inline void PercentDecodeUtf8(Internal::StrInputT<char> in, std::string& out,
+	bool plusAsSpace = false)
+{
+	out.clear();
+	out.reserve(in.size());
+
+	PercentDecodeUtf8(in.data(), in.data() + in.size(),
+		std::back_inserter(out), plusAsSpace);
+}
+
+inline std::string PercentDecodeUtf8(Internal::StrInputT<char> in,
+	bool plusAsSpace = false)
+{
+	std::string resUtfStr;
+
+	PercentDecodeUtf8(in, resUtfStr, plusAsSpace);
+
+	return resUtfStr;
+}
+
+// ==========  UTF-8 --> Percent-encoded
+
+/**
+ * @brief Percent-encodes a UTF-8 string, validating it in the same pass.
+ *
+ */
+template<typename InputIt, typename OutputIt, typename _Policy = UtfStrictPolicy,
+	Internal::EnableIfT<
+		sizeof(Internal::ItValType<InputIt>) == 1, int> = 0>
+inline OutputIt PercentEncodeUtf8(InputIt begin, InputIt end, OutputIt dest,
+	bool plusAsSpace = false)
+{
+	while (begin != end)
+	{
+		const uint8_t uval =
+			static_cast<uint8_t>(Internal::BitCast2Unsigned(*begin));
+		if (uval < 0x80U)
+		{
+			dest = Internal::PercentEncodeAscii(uval, dest, plusAsSpace);
+			++begin;
+		}
+		else
+		{
+			auto res = Utf8ToCodePtOnce<InputIt, _Policy>(begin, end);
+			dest = Internal::PercentEncodeCodePt<_Policy>(res.first, dest);
+			begin = res.second;
+		}
+	}
+	return dest;
+}
+
+inline void PercentEncodeUtf8(Internal::StrInputT<char> in, std::string& out,
+	bool plusAsSpace = false)
+{
+	out.clear();
+	out.reserve(in.size());
+
+	PercentEncodeUtf8(in.data(), in.data() + in.size(),
+		std::back_inserter(out), plusAsSpace);
+}
+
+inline std::string PercentEncodeUtf8(Internal::StrInputT<char> in,
+	bool plusAsSpace = false)
+{
+	std::string resUtfStr;
+
+	PercentEncodeUtf8(in, resUtfStr, plusAsSpace);
+
+	return resUtfStr;
+}
+
+// ==========  UTF-16 --> Percent-encoded (UTF-8)
+
+/**
+ * @brief Percent-encodes the UTF-8 encoding of a UTF-16 string, without
+ *        converting it into a UTF-8 string first.
+ *
+ */
+template<typename InputIt, typename OutputIt, typename _Policy = UtfStrictPolicy,
+	Internal::EnableIfT<
+		sizeof(Internal::ItValType<InputIt>) == 2, int> = 0>
+inline OutputIt PercentEncodeUtf8(InputIt begin, InputIt end, OutputIt dest,
+	bool plusAsSpace = false)
+{
+	while (begin != end)
+	{
+		auto res = Utf16ToCodePtOnce<InputIt, _Policy>(begin, end);
+		begin = res.second;
+
+		if (res.first < 0x80U)
+		{
+			dest = Internal::PercentEncodeAscii(
+				static_cast<uint8_t>(res.first), dest, plusAsSpace);
+		}
+		else
+		{
+			dest = Internal::PercentEncodeCodePt<_Policy>(res.first, dest);
+		}
+	}
+	return dest;
+}
+
+inline void PercentEncodeUtf8(Internal::StrInputT<char16_t> in,
+	std::string& out, bool plusAsSpace = false)
+{
+	out.clear();
+	out.reserve(in.size());
+
+	PercentEncodeUtf8(in.data(), in.data() + in.size(),
+		std::back_inserter(out), plusAsSpace);
+}
+
+inline std::string PercentEncodeUtf8(Internal::StrInputT<char16_t> in,
+	bool plusAsSpace = false)
+{
+	std::string resUtfStr;
+
+	PercentEncodeUtf8(in, resUtfStr, plusAsSpace);
+
+	return resUtfStr;
+}
+
+} // namespace SimpleUtf
@@ -0,0 +1,800 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include "Utf.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+// The Standard Compression Scheme for Unicode (SCSU, Unicode Technical
+// Standard #6).
+// In its single-byte mode, characters in one of 8 "dynamic windows" of 128
+// code points are encoded in one byte each, so texts in small alphabets
+// (e.g., Greek, Cyrillic, Hebrew, Kana) take about one byte per character;
+// in its Unicode mode, characters are encoded in UTF-16BE, so CJK texts
+// take two bytes per character instead of three in UTF-8.
+// The decoder accepts any SCSU input; the encoder makes its choices based on
+// the current and the next code point.
+
+/**
+ * @brief The state of an SCSU encoder or decoder; a default-constructed
+ *        state is the initial state.
+ *
+ */
+struct ScsuState
+{
+	ScsuState() :
+		isUnicodeMode(false),
+		window(0),
+		nextWindow(0),
+		offsets{
+			0x0080U, 0x00C0U, 0x0400U, 0x0600U,
+			0x0900U, 0x3040U, 0x30A0U, 0xFF00U
+		}
+	{}
+
+	bool isUnicodeMode;
+	// the active dynamic window
+	uint8_t window;
+	// the dynamic window to be redefined next (only used by the encoder)
+	uint8_t nextWindow;
+	char32_t offsets[8];
+}; // struct ScsuState
+
+namespace Internal
+{
+
+// ==========  Tags in the single-byte mode
+
+static constexpr uint8_t sk_scsuSQ0 = 0x01U;
+static constexpr uint8_t sk_scsuSDX = 0x0BU;
+static constexpr uint8_t sk_scsuSQU = 0x0EU;
+static constexpr uint8_t sk_scsuSCU = 0x0FU;
+static constexpr uint8_t sk_scsuSC0 = 0x10U;
+static constexpr uint8_t sk_scsuSD0 = 0x18U;
+
+// ==========  Tags in the Unicode mode
+
+static constexpr uint8_t sk_scsuUC0 = 0xE0U;
+static constexpr uint8_t sk_scsuUD0 = 0xE8U;
+static constexpr uint8_t sk_scsuUQU = 0xF0U;
+static constexpr uint8_t sk_scsuUDX = 0xF1U;
+static constexpr uint8_t sk_scsuURS = 0xF2U;
+
+inline char32_t ScsuStaticOffset(size_t window)
+{
+	static constexpr char32_t sk_offsets[8] = {
+		0x0000U, 0x0080U, 0x0100U, 0x0300U,
+		0x2000U, 0x2080U, 0x2100U, 0x3000U
+	};
+	return sk_offsets[window];
+}
+
+/**
+ * @brief The offset of a dynamic window defined by the given byte, or 0 if
+ *        the byte is reserved
+ *
+ */
+inline char32_t ScsuWindowOffset(uint8_t val)
+{
+	static constexpr char32_t sk_specialOffsets[7] = {
+		0x00C0U, 0x0250U, 0x0370U, 0x0530U, 0x3040U, 0x30A0U, 0xFF60U
+	};
+
+	return (val == 0x00U) ? 0 :
+		(val < 0x68U) ? (static_cast<char32_t>(val) * 0x80U) :
+		(val < 0xA8U) ? (static_cast<char32_t>(val) * 0x80U + 0xAC00U) :
+		(val < 0xF9U) ? 0 :
+		sk_specialOffsets[val - 0xF9U];
+}
+
+/**
+ * @brief Is the given code point passed through as is in the single-byte
+ *        mode (NUL, TAB, LF, CR, and printable ASCII)?
+ *
+ */
+inline bool IsScsuPassThrough(char32_t val)
+{
+	return ((0x20U <= val) && (val < 0x80U)) ||
+		(val == 0x00U) || (val == 0x09U) || (val == 0x0AU) || (val == 0x0DU);
+}
+
+/**
+ * @brief Can a dynamic window be defined for the given code point?
+ *        The BMP range [0x3400, 0xE000) (CJK ideographs, Hangul syllables,
+ *        and surrogates) is not covered by any window.
+ *
+ */
+inline bool IsScsuWindowable(char32_t val)
+{
+	return (val >= 0x80U) && ((val < 0x3400U) || (val >= 0xE000U));
+}
+
+/**
+ * @brief The byte defining a dynamic window that contains the given BMP
+ *        code point, which must be windowable
+ *
+ */
+inline uint8_t ScsuDefineByte(char32_t val)
+{
+	// the windows at special offsets cover some scripts better than the
+	// windows at multiples of 0x80
+	for (uint8_t i = 0xF9U; i != 0x00U; ++i)
+	{
+		const char32_t offset = ScsuWindowOffset(i);
+		if ((offset <= val) && (val < offset + 0x80U))
+		{
+			return i;
+		}
+	}
+
+	return static_cast<uint8_t>(
+		(val < 0x3400U) ? (val >> 7) : ((val - 0xAC00U) >> 7));
+}
+
+inline void ScsuThrowInvalid(const char* msg)
+{
+	SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+	throw UtfConversionException(std::string("Invalid Encoding" " - ") + msg);
+}
+
+template<typename InputIt>
+inline uint8_t ScsuReadByte(InputIt& begin, InputIt end)
+{
+	if (begin == end)
+	{
+		SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
+		throw UtfConversionException("Unexpected Ending" " - "
+			"String ends unexpected while reading the next SCSU bytes.");
+	}
+
+	const uint8_t res = static_cast<uint8_t>(BitCast2Unsigned(*begin));
+	++begin;
+	return res;
+}
+
+template<typename InputIt>
+inline char32_t ScsuReadUnit(InputIt& begin, InputIt end)
+{
+	const char32_t high = ScsuReadByte(begin, end);
+	return (high << 8) | ScsuReadByte(begin, end);
+}
+
+template<typename InputIt>
+inline void ScsuDefineExtended(ScsuState& state, InputIt& begin, InputIt end)
+{
+	const uint8_t high = ScsuReadByte(begin, end);
+	const uint8_t low = ScsuReadByte(begin, end);
+	state.window = static_cast<uint8_t>(high >> 5);
+	state.offsets[state.window] = 0x10000U +
+		(0x80U * ((static_cast<char32_t>(high & 0x1FU) << 8) | low));
+}
+
+template<typename InputIt>
+inline void ScsuDefine(ScsuState& state, size_t window,
+	InputIt& begin, InputIt end)
+{
+	const char32_t offset = ScsuWindowOffset(ScsuReadByte(begin, end));
+	if (offset == 0)
+	{
+		ScsuThrowInvalid("Reserved SCSU window offset.");
+	}
+	state.window = static_cast<uint8_t>(window);
+	state.offsets[window] = offset;
+}
+
+/**
+ * @brief Reads the next character, as a code point or a UTF-16 code unit
+ *        (which may be a surrogate), together with any tags before it.
+ *
+ * @return false if the input ends before a character
+ */
+template<typename InputIt>
+inline bool ScsuReadChar(ScsuState& state, InputIt& begin, InputIt end,
+	char32_t& val)
+{
+	while (begin != end)
+	{
+		const uint8_t tag = ScsuReadByte(begin, end);
+
+		if (state.isUnicodeMode)
+		{
+			if ((tag < sk_scsuUC0) || (tag > sk_scsuURS))
+			{
+				val = (static_cast<char32_t>(tag) << 8) |
+					ScsuReadByte(begin, end);
+				return true;
+			}
+			else if (tag < sk_scsuUD0)
+			{
+				state.window = static_cast<uint8_t>(tag - sk_scsuUC0);
+				state.isUnicodeMode = false;
+			}
+			else if (tag < sk_scsuUQU)
+			{
+				ScsuDefine(state, tag - sk_scsuUD0, begin, end);
+				state.isUnicodeMode = false;
+			}
+			else if (tag == sk_scsuUQU)
+			{
+				val = ScsuReadUnit(begin, end);
+				return true;
+			}
+			else if (tag == sk_scsuUDX)
+			{
+				ScsuDefineExtended(state, begin, end);
+				state.isUnicodeMode = false;
+			}
+			else
+			{
+				ScsuThrowInvalid("Reserved SCSU tag.");
+			}
+			continue;
+		}
+
+		if (tag >= 0x80U)
+		{
+			val = state.offsets[state.window] + (tag - 0x80U);
+			return true;
+		}
+		else if (IsScsuPassThrough(tag))
+		{
+			val = tag;
+			return true;
+		}
+		else if (tag < sk_scsuSC0)
+		{
+			switch (tag)
+			{
+			case sk_scsuSDX:
+				ScsuDefineExtended(state, begin, end);
+				break;
+			case sk_scsuSQU:
+				val = ScsuReadUnit(begin, end);
+				return true;
+			case sk_scsuSCU:
+				state.isUnicodeMode = true;
+				break;
+			case 0x0CU:
+				ScsuThrowInvalid("Reserved SCSU tag.");
+				break;
+			default:
+			{
+				// SQ0 - SQ7
+				const size_t window = tag - sk_scsuSQ0;
+				const uint8_t quoted = ScsuReadByte(begin, end);
+				val = (quoted < 0x80U) ?
+					(ScsuStaticOffset(window) + quoted) :
+					(state.offsets[window] + (quoted - 0x80U));
+				return true;
+			}
+			}
+		}
+		else if (tag < sk_scsuSD0)
+		{
+			state.window = static_cast<uint8_t>(tag - sk_scsuSC0);
+		}
+		else
+		{
+			ScsuDefine(state, tag - sk_scsuSD0, begin, end);
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Decodes the next code point; surrogate pairs are combined, and
+ *        unpaired surrogates are rejected.
+ *
+ * @return false if the input ends before a code point
+ */
+template<typename InputIt>
+inline bool ScsuToCodePtOnce(ScsuState& state, InputIt& begin, InputIt end,
+	char32_t& val)
+{
+	if (!ScsuReadChar(state, begin, end, val))
+	{
+		return false;
+	}
+
+	if ((0xD800U <= val) && (val <= 0xDBFFU))
+	{
+		char32_t low = 0;
+		if (!ScsuReadChar(state, begin, end, low) ||
+			(low < 0xDC00U) || (low > 0xDFFFU))
+		{
+			ScsuThrowInvalid("Unpaired surrogate in SCSU.");
+		}
+		val = 0x10000U + ((val - 0xD800U) << 10) + (low - 0xDC00U);
+	}
+	else if (!IsValidUtfCodePt(val))
+	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidCodePoint, 1);
+		throw UtfConversionException("Invalid Code Point" " - "
+			"The SCSU input contains an invalid code point.");
+	}
+
+	return true;
+}
+
+template<typename OutputIt>
+inline OutputIt ScsuPutByte(uint32_t val, OutputIt dest)
+{
+	*dest = static_cast<char>(static_cast<uint8_t>(val));
+	++dest;
+	return dest;
+}
+
+/**
+ * @brief Finds the dynamic window containing the given code point,
+ *        starting from the active one
+ *
+ * @return the window, or 8 if there is none
+ */
+inline size_t ScsuFindWindow(const ScsuState& state, char32_t val)
+{
+	for (size_t i = 0; i < 8; ++i)
+	{
+		const size_t window = (state.window + i) % 8;
+		const char32_t offset = state.offsets[window];
+		if ((offset <= val) && (val < offset + 0x80U))
+		{
+			return window;
+		}
+	}
+	return 8;
+}
+
+inline size_t ScsuFindStaticWindow(char32_t val)
+{
+	for (size_t i = 1; i < 8; ++i)
+	{
+		const char32_t offset = ScsuStaticOffset(i);
+		if ((offset <= val) && (val < offset + 0x80U))
+		{
+			return i;
+		}
+	}
+	return 8;
+}
+
+/**
+ * @brief Defines a new dynamic window for the given windowable code point,
+ *        and selects it
+ *
+ * @param defineTag The tag SD0 or UD0
+ * @param extendedTag The tag SDX or UDX
+ */
+template<typename OutputIt>
+inline OutputIt ScsuDefineWindow(ScsuState& state, char32_t val,
+	uint8_t defineTag, uint8_t extendedTag, OutputIt dest)
+{
+	const uint8_t window = state.nextWindow;
+	state.nextWindow = static_cast<uint8_t>((window + 1) % 8);
+	state.window = window;
+
+	if (val >= 0x10000U)
+	{
+		const char32_t index = (val - 0x10000U) >> 7;
+		dest = ScsuPutByte(extendedTag, dest);
+		dest = ScsuPutByte((static_cast<uint32_t>(window) << 5) | (index >> 8),
+			dest);
+		dest = ScsuPutByte(index & 0xFFU, dest);
+		state.offsets[window] = 0x10000U + (index << 7);
+	}
+	else
+	{
+		const uint8_t defineByte = ScsuDefineByte(val);
+		dest = ScsuPutByte(defineTag + window, dest);
+		dest = ScsuPutByte(defineByte, dest);
+		state.offsets[window] = ScsuWindowOffset(defineByte);
+	}
+	return dest;
+}
+
+/**
+ * @brief Writes a BMP code point (or a surrogate) as a UTF-16 code unit in
+ *        the Unicode mode
+ *
+ */
+template<typename OutputIt>
+inline OutputIt ScsuPutUnicodeUnit(char32_t unit, OutputIt dest)
+{
+	const uint8_t high = static_cast<uint8_t>(unit >> 8);
+	if ((sk_scsuUC0 <= high) && (high <= sk_scsuURS))
+	{
+		// collides with a tag
+		dest = ScsuPutByte(sk_scsuUQU, dest);
+	}
+	dest = ScsuPutByte(high, dest);
+	return ScsuPutByte(unit & 0xFFU, dest);
+}
+
+/**
+ * @brief Encodes a code point in the single-byte mode
+ *
+ */
+template<typename OutputIt>
+inline OutputIt CodePtToScsuSingleByte(ScsuState& state, char32_t val,
+	bool hasNext, char32_t next, OutputIt dest)
+{
+	if (IsScsuPassThrough(val))
+	{
+		return ScsuPutByte(val, dest);
+	}
+	if (val < 0x20U)
+	{
+		// other control characters are quoted from the static window 0
+		dest = ScsuPutByte(sk_scsuSQ0, dest);
+		return ScsuPutByte(val, dest);
+	}
+
+	const size_t window = ScsuFindWindow(state, val);
+	if (window != 8)
+	{
+		const char32_t offset = state.offsets[window];
+		if (window != state.window)
+		{
+			// a single character is quoted, so the active window is kept
+			const bool nextInWindow = hasNext &&
+				(offset <= next) && (next < offset + 0x80U);
+			dest = ScsuPutByte(
+				(nextInWindow ? sk_scsuSC0 : sk_scsuSQ0) + window, dest);
+			state.window = static_cast<uint8_t>(
+				nextInWindow ? window : state.window);
+		}
+		return ScsuPutByte(0x80U + (val - offset), dest);
+	}
+
+	const size_t staticWindow = ScsuFindStaticWindow(val);
+	if (staticWindow != 8)
+	{
+		dest = ScsuPutByte(sk_scsuSQ0 + staticWindow, dest);
+		return ScsuPutByte(val - ScsuStaticOffset(staticWindow), dest);
+	}
+
+	if (IsScsuWindowable(val))
+	{
+		dest = ScsuDefineWindow(state, val, sk_scsuSD0, sk_scsuSDX, dest);
+		return ScsuPutByte(0x80U + (val - state.offsets[state.window]), dest);
+	}
+
+	if (hasNext && !IsScsuWindowable(next) && !IsScsuPassThrough(next))
+	{
+		// a run of characters without windows
+		state.isUnicodeMode = true;
+		dest = ScsuPutByte(sk_scsuSCU, dest);
+		return ScsuPutUnicodeUnit(val, dest);
+	}
+
+	dest = ScsuPutByte(sk_scsuSQU, dest);
+	dest = ScsuPutByte(val >> 8, dest);
+	return ScsuPutByte(val & 0xFFU, dest);
+}
+
+/**
+ * @brief Encodes a code point in the Unicode mode; the encoder switches
+ *        back to the single-byte mode, unless both the current and the
+ *        next code point are better encoded in the Unicode mode
+ *
+ */
+template<typename OutputIt>
+inline OutputIt CodePtToScsuUnicode(ScsuState& state, char32_t val,
+	bool hasNext, char32_t next, OutputIt dest)
+{
+	const bool isUnicode = (0x3400U <= val) && (val < 0xE000U);
+	const bool isNextUnicode = hasNext && (0x3400U <= next) && (next < 0xE000U);
+
+	if (isUnicode || isNextUnicode)
+	{
+		if (val >= 0x10000U)
+		{
+			const char32_t codePt = val - 0x10000U;
+			dest = ScsuPutUnicodeUnit(0xD800U + (codePt >> 10), dest);
+			return ScsuPutUnicodeUnit(0xDC00U + (codePt & 0x3FFU), dest);
+		}
+		return ScsuPutUnicodeUnit(val, dest);
+	}
+
+	state.isUnicodeMode = false;
+
+	const size_t window = ScsuFindWindow(state, val);
+	if ((window == 8) && IsScsuWindowable(val) &&
+		(ScsuFindStaticWindow(val) == 8))
+	{
+		dest = ScsuDefineWindow(state, val, sk_scsuUD0, sk_scsuUDX, dest);
+		return ScsuPutByte(0x80U + (val - state.offsets[state.window]), dest);
+	}
+
+	state.window = static_cast<uint8_t>((window == 8) ? state.window : window);
+	dest = ScsuPutByte(sk_scsuUC0 + state.window, dest);
+	return CodePtToScsuSingleByte(state, val, hasNext, next, dest);
+}
+
+/**
+ * @brief Encodes a code point, given the next code point (if any), which
+ *        is only used to make a better choice
+ *
+ */
+template<typename OutputIt>
+inline OutputIt CodePtToScsuOnce(ScsuState& state, char32_t val,
+	bool hasNext, char32_t next, OutputIt dest)
+{
+	return state.isUnicodeMode ?
+		CodePtToScsuUnicode(state, val, hasNext, next, dest) :
+		CodePtToScsuSingleByte(state, val, hasNext, next, dest);
+}
+
+template<typename InBoundFunc, typename InputIt, typename OutputIt>
+inline OutputIt UtfToScsu(InBoundFunc inFunc,
+	InputIt begin, InputIt end, OutputIt dest)
+{
+	ScsuState state;
+
+	if (begin == end)
+	{
+		return dest;
+	}
+
+	auto codePtRes = inFunc(begin, end);
+	while (true)
+	{
+		const bool hasNext = (codePtRes.second != end);
+		auto nextRes = hasNext ?
+			inFunc(codePtRes.second, end) :
+			std::make_pair(char32_t(0), end);
+
+		dest = CodePtToScsuOnce(state, codePtRes.first, hasNext, nextRes.first,
+			dest);
+		if (!hasNext)
+		{
+			return dest;
+		}
+		codePtRes = nextRes;
+	}
+}
+
+/**
+ * @brief Decodes SCSU; runs of characters passed through as is in the
+ *        single-byte mode are copied without going through `outFunc`.
+ *
+ */
+template<typename _OutCharType,
+	typename OutBoundFunc, typename InputIt, typename OutputIt>
+inline OutputIt ScsuToUtf(OutBoundFunc outFunc,
+	InputIt begin, InputIt end, OutputIt dest)
+{
+	ScsuState state;
+	char32_t val = 0;
+
+	while (begin != end)
+	{
+		if (!state.isUnicodeMode)
+		{
+			InputIt it = begin;
+			for (; (it != end) && IsScsuPassThrough(
+				static_cast<uint8_t>(BitCast2Unsigned(*it))); ++it, ++dest)
+			{
+				*dest = static_cast<_OutCharType>(*it);
+			}
+			if (it != begin)
+			{
+				begin = it;
+				continue;
+			}
+		}
+
+		if (!ScsuToCodePtOnce(state, begin, end, val))
+		{
+			break;
+		}
+		dest = outFunc(val, dest);
+	}
+	return dest;
+}
+
+/**
+ * @brief An output iterator that only counts what's written to it
+ *
+ */
+class ScsuCountIt
+{
+public:
+	using iterator_category = std::output_iterator_tag;
+	using value_type = void;
+	using difference_type = std::ptrdiff_t;
+	using pointer = void;
+	using reference = void;
+
+	ScsuCountIt() :
+		m_count(0)
+	{}
+
+	ScsuCountIt& operator*()
+	{
+		return *this;
+	}
+
+	template<typename _ValType>
+	ScsuCountIt& operator=(const _ValType&)
+	{
+		++m_count;
+		return *this;
+	}
+
+	ScsuCountIt& operator++()
+	{
+		return *this;
+	}
+
+	ScsuCountIt& operator++(int)
+	{
+		return *this;
+	}
+
+	size_t GetCount() const
+	{
+		return m_count;
+	}
+
+private:
+	size_t m_count;
+}; // class ScsuCountIt
+
+} // namespace Internal
+
+// ==========  UTF-8 --> SCSU
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline OutputIt Utf8ToScsu(InputIt begin, InputIt end, OutputIt dest)
+{
+	return Internal::UtfToScsu(Utf8ToCodePtOnce<InputIt>, begin, end, dest);
+}
+
+inline void Utf8ToScsu(Internal::StrInputT<char> utf8, std::string& out)
+{
+	out.clear();
+
+	Utf8ToScsu(utf8.data(), utf8.data() + utf8.size(), std::back_inserter(out));
+}
+
+inline std::string Utf8ToScsu(Internal::StrInputT<char> utf8)
+{
+	std::string resScsuStr;
+
+	Utf8ToScsu(utf8, resScsuStr);
+
+	return resScsuStr;
+}
+
+template<typename InputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline size_t Utf8ToScsuGetSize(InputIt begin, InputIt end)
+{
+	return Utf8ToScsu(begin, end, Internal::ScsuCountIt()).GetCount();
+}
+
+// ==========  UTF-16 --> SCSU
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 2>::value, int> = 0>
+inline OutputIt Utf16ToScsu(InputIt begin, InputIt end, OutputIt dest)
+{
+	return Internal::UtfToScsu(Utf16ToCodePtOnce<InputIt>, begin, end, dest);
+}
+
+inline void Utf16ToScsu(Internal::StrInputT<char16_t> in, std::string& out)
+{
+	out.clear();
+
+	Utf16ToScsu(in.data(), in.data() + in.size(), std::back_inserter(out));
+}
+
+inline std::string Utf16ToScsu(Internal::StrInputT<char16_t> in)
+{
+	std::string resScsuStr;
+
+	Utf16ToScsu(in, resScsuStr);
+
+	return resScsuStr;
+}
+
+template<typename InputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 2>::value, int> = 0>
+inline size_t Utf16ToScsuGetSize(InputIt begin, InputIt end)
+{
+	return Utf16ToScsu(begin, end, Internal::ScsuCountIt()).GetCount();
+}
+
+// ==========  SCSU --> UTF-8
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline OutputIt ScsuToUtf8(InputIt begin, InputIt end, OutputIt dest)
+{
+	return Internal::ScsuToUtf<char>(CodePtToUtf8Once<OutputIt>,
+		begin, end, dest);
+}
+
+inline void ScsuToUtf8(Internal::StrInputT<char> scsu, std::string& out)
+{
+	out.clear();
+
+	ScsuToUtf8(scsu.data(), scsu.data() + scsu.size(), std::back_inserter(out));
+}
+
+inline std::string ScsuToUtf8(Internal::StrInputT<char> scsu)
+{
+	std::string resUtfStr;
+
+	ScsuToUtf8(scsu, resUtfStr);
+
+	return resUtfStr;
+}
+
+template<typename InputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline size_t ScsuToUtf8GetSize(InputIt begin, InputIt end)
+{
+	Internal::ScsuCountIt res = Internal::ScsuToUtf<char>(
+		CodePtToUtf8Once<Internal::ScsuCountIt>, begin, end,
+		Internal::ScsuCountIt());
+	return res.GetCount();
+}
+
+// ==========  SCSU --> UTF-16
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline OutputIt ScsuToUtf16(InputIt begin, InputIt end, OutputIt dest)
+{
+	return Internal::ScsuToUtf<char16_t>(CodePtToUtf16Once<OutputIt>,
+		begin, end, dest);
+}
+
+inline void ScsuToUtf16(Internal::StrInputT<char> scsu, std::u16string& out)
+{
+	out.clear();
+
+	ScsuToUtf16(scsu.data(), scsu.data() + scsu.size(),
+		std::back_inserter(out));
+}
+
+inline std::u16string ScsuToUtf16(Internal::StrInputT<char> scsu)
+{
+	std::u16string resUtfStr;
+
+	ScsuToUtf16(scsu, resUtfStr);
+
+	return resUtfStr;
+}
+
+template<typename InputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline size_t ScsuToUtf16GetSize(InputIt begin, InputIt end)
+{
+	Internal::ScsuCountIt res = Internal::ScsuToUtf<char16_t>(
+		CodePtToUtf16Once<Internal::ScsuCountIt>, begin, end,
+		Internal::ScsuCountIt());
+	return res.GetCount();
+}
+
+} // namespace SimpleUtf
@@ -8,6 +8,8 @@
 #include "Utf8.hpp"
 #include "Utf16.hpp"
 #include "Utf32.hpp"
+#include "UtfNewline.hpp"
+#include "UtfString.hpp"
 
 #ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
 namespace SimpleUtf
@@ -16,27 +18,88 @@ namespace SIMPLEUtf_CUSTOMIZED_NAMESPACE
 #endif
 {
 
+/**
+ * @brief Converts a single code point
+ *
+ * @return The position after the code point in the input, and the position
+ *         after the code units written to the output (as returned by
+ *         `UtfConvert`); the `UtfXToUtfYOnce` functions below only
+ *         return the former.
+ */
 template<typename InBoundFunc, typename OutBoundFunc, typename InputIt, typename OutputIt>
-inline InputIt UtfConvertOnce(InBoundFunc inFunc, OutBoundFunc outFunc,
+inline std::pair<InputIt, OutputIt> UtfConvertOnce(InBoundFunc inFunc, OutBoundFunc outFunc,
 	InputIt begin, InputIt end,
 	OutputIt dest)
 {
 	auto codePtRes = inFunc(begin, end);
-	outFunc(codePtRes.first, dest);
-	return codePtRes.second;
+	dest = outFunc(codePtRes.first, dest);
+	return std::make_pair(codePtRes.second, dest);
 }
 
 template<typename InBoundFunc, typename OutBoundFunc, typename InputIt, typename OutputIt>
-inline void UtfConvert(InBoundFunc inFunc, OutBoundFunc outFunc,
+inline OutputIt UtfConvert(InBoundFunc inFunc, OutBoundFunc outFunc,
 	InputIt begin, InputIt end,
 	OutputIt dest)
 {
+	SIMPLEUTF_STATS_ADD(ConvertCalls, 1);
+
+	while (begin != end)
+	{
+		auto codePtRes = inFunc(begin, end);
+		dest = outFunc(codePtRes.first, dest);
+		begin = codePtRes.second;
+	}
+	return dest;
+}
+
+namespace Internal
+{
+
+/**
+ * @brief `UtfConvert` with line breaks normalized by `newlines`; runs of
+ *        ASCII characters other than CR and LF are copied without being
+ *        decoded and encoded (see `SkipNewlinePlain`).
+ *
+ */
+template<typename _OutCharType,
+	typename InBoundFunc, typename OutBoundFunc,
+	typename InputIt, typename OutputIt>
+inline OutputIt UtfConvertNewlines(InBoundFunc inFunc, OutBoundFunc outFunc,
+	InputIt begin, InputIt end,
+	OutputIt dest,
+	NewlineNormalizer& newlines)
+{
+	SIMPLEUTF_STATS_ADD(ConvertCalls, 1);
+
 	while (begin != end)
 	{
-		begin = UtfConvertOnce(inFunc, outFunc, begin, end, dest);
+		InputIt plainEnd = SkipNewlinePlain(begin, end);
+		if (plainEnd != begin)
+		{
+			newlines.PassPlain();
+			SIMPLEUTF_STATS_ADD(BytesIn, static_cast<size_t>(
+				std::distance(begin, plainEnd)) * sizeof(ItValType<InputIt>));
+			SIMPLEUTF_STATS_ADD(BytesOut, static_cast<size_t>(
+				std::distance(begin, plainEnd)) * sizeof(_OutCharType));
+			for (; begin != plainEnd; ++begin, ++dest)
+			{
+				*dest = static_cast<_OutCharType>(*begin);
+			}
+			continue;
+		}
+
+		auto codePtRes = inFunc(begin, end);
+		if (newlines.Filter(codePtRes.first))
+		{
+			dest = outFunc(codePtRes.first, dest);
+		}
+		begin = codePtRes.second;
 	}
+	return dest;
 }
 
+} // namespace Internal
+
 template<typename InBoundFunc, typename OutBoundFunc, typename InputIt>
 inline std::pair<size_t, InputIt> UtfConvertOnceGetSize(InBoundFunc inFunc, OutBoundFunc outFunc,
 	InputIt begin, InputIt end)
@@ -63,23 +126,33 @@ inline size_t UtfConvertGetSize(InBoundFunc inFunc, OutBoundFunc outFunc,
 	return size;
 }
 
+// NOTE: The `(in, out)` overloads below clear `out` and then write the result
+// into it, so the same output string (and its capacity) can be reused across
+// calls without reallocating.
 
 // ==========  UTF-8 --> UTF-16
 
 template<typename InputIt, typename OutputIt,
 	Internal::EnableIfT<
 		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
-inline void Utf8ToUtf16(InputIt begin, InputIt end, OutputIt dest)
+inline OutputIt Utf8ToUtf16(InputIt begin, InputIt end, OutputIt dest)
 {
 	return UtfConvert(Utf8ToCodePtOnce<InputIt>, CodePtToUtf16Once<OutputIt>,
 		begin, end, dest);
 }
 
-inline std::u16string Utf8ToUtf16(const std::string& utf8)
+inline void Utf8ToUtf16(Internal::StrInputT<char> utf8, std::u16string& out)
+{
+	out.clear();
+
+	Utf8ToUtf16(utf8.data(), utf8.data() + utf8.size(), std::back_inserter(out));
+}
+
+inline std::u16string Utf8ToUtf16(Internal::StrInputT<char> utf8)
 {
 	std::u16string resUtfStr;
 
-	Utf8ToUtf16(utf8.begin(), utf8.end(), std::back_inserter(resUtfStr));
+	Utf8ToUtf16(utf8, resUtfStr);
 
 	return resUtfStr;
 }
@@ -90,7 +163,7 @@ template<typename InputIt, typename OutputIt,
 inline InputIt Utf8ToUtf16Once(InputIt begin, InputIt end, OutputIt dest)
 {
 	return UtfConvertOnce(Utf8ToCodePtOnce<InputIt>, CodePtToUtf16Once<OutputIt>,
-		begin, end, dest);
+		begin, end, dest).first;
 }
 
 template<typename InputIt,
@@ -116,17 +189,24 @@ inline size_t Utf8ToUtf16GetSize(InputIt begin, InputIt end)
 template<typename InputIt, typename OutputIt,
 	Internal::EnableIfT<
 		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
-inline void Utf8ToUtf32(InputIt begin, InputIt end, OutputIt dest)
+inline OutputIt Utf8ToUtf32(InputIt begin, InputIt end, OutputIt dest)
 {
 	return UtfConvert(Utf8ToCodePtOnce<InputIt>, CodePtToUtf32Once<OutputIt>,
 		begin, end, dest);
 }
 
-inline std::u32string Utf8ToUtf32(const std::string& utf8)
+inline void Utf8ToUtf32(Internal::StrInputT<char> utf8, std::u32string& out)
+{
+	out.clear();
+
+	Utf8ToUtf32(utf8.data(), utf8.data() + utf8.size(), std::back_inserter(out));
+}
+
+inline std::u32string Utf8ToUtf32(Internal::StrInputT<char> utf8)
 {
 	std::u32string resUtfStr;
 
-	Utf8ToUtf32(utf8.begin(), utf8.end(), std::back_inserter(resUtfStr));
+	Utf8ToUtf32(utf8, resUtfStr);
 
 	return resUtfStr;
 }
@@ -137,7 +217,7 @@ template<typename InputIt, typename OutputIt,
 inline InputIt Utf8ToUtf32Once(InputIt begin, InputIt end, OutputIt dest)
 {
 	return UtfConvertOnce(Utf8ToCodePtOnce<InputIt>, CodePtToUtf32Once<OutputIt>,
-		begin, end, dest);
+		begin, end, dest).first;
 }
 
 template<typename InputIt,
@@ -163,17 +243,24 @@ inline size_t Utf8ToUtf32GetSize(InputIt begin, InputIt end)
 template<typename InputIt, typename OutputIt,
 	Internal::EnableIfT<
 		Internal::CanTHold<Internal::ItValType<InputIt>, 2>::value, int> = 0>
-inline void Utf16ToUtf8(InputIt begin, InputIt end, OutputIt dest)
+inline OutputIt Utf16ToUtf8(InputIt begin, InputIt end, OutputIt dest)
 {
 	return UtfConvert(Utf16ToCodePtOnce<InputIt>, CodePtToUtf8Once<OutputIt>,
 		begin, end, dest);
 }
 
-inline std::string Utf16ToUtf8(const std::u16string& in)
+inline void Utf16ToUtf8(Internal::StrInputT<char16_t> in, std::string& out)
+{
+	out.clear();
+
+	Utf16ToUtf8(in.data(), in.data() + in.size(), std::back_inserter(out));
+}
+
+inline std::string Utf16ToUtf8(Internal::StrInputT<char16_t> in)
 {
 	std::string resUtfStr;
 
-	Utf16ToUtf8(in.begin(), in.end(), std::back_inserter(resUtfStr));
+	Utf16ToUtf8(in, resUtfStr);
 
 	return resUtfStr;
 }
@@ -184,7 +271,7 @@ template<typename InputIt, typename OutputIt,
 inline InputIt Utf16ToUtf8Once(InputIt begin, InputIt end, OutputIt dest)
 {
 	return UtfConvertOnce(Utf16ToCodePtOnce<InputIt>, CodePtToUtf8Once<OutputIt>,
-		begin, end, dest);
+		begin, end, dest).first;
 }
 
 template<typename InputIt,
@@ -210,17 +297,24 @@ inline size_t Utf16ToUtf8GetSize(InputIt begin, InputIt end)
 template<typename InputIt, typename OutputIt,
 	Internal::EnableIfT<
 		Internal::CanTHold<Internal::ItValType<InputIt>, 2>::value, int> = 0>
-inline void Utf16ToUtf32(InputIt begin, InputIt end, OutputIt dest)
+inline OutputIt Utf16ToUtf32(InputIt begin, InputIt end, OutputIt dest)
 {
 	return UtfConvert(Utf16ToCodePtOnce<InputIt>, CodePtToUtf32Once<OutputIt>,
 		begin, end, dest);
 }
 
-inline std::u32string Utf16ToUtf32(const std::u16string& in)
+inline void Utf16ToUtf32(Internal::StrInputT<char16_t> in, std::u32string& out)
+{
+	out.clear();
+
+	Utf16ToUtf32(in.data(), in.data() + in.size(), std::back_inserter(out));
+}
+
+inline std::u32string Utf16ToUtf32(Internal::StrInputT<char16_t> in)
 {
 	std::u32string resUtfStr;
 
-	Utf16ToUtf32(in.begin(), in.end(), std::back_inserter(resUtfStr));
+	Utf16ToUtf32(in, resUtfStr);
 
 	return resUtfStr;
 }
@@ -231,7 +325,7 @@ template<typename InputIt, typename OutputIt,
 inline InputIt Utf16ToUtf32Once(InputIt begin, InputIt end, OutputIt dest)
 {
 	return UtfConvertOnce(Utf16ToCodePtOnce<InputIt>, CodePtToUtf32Once<OutputIt>,
-		begin, end, dest);
+		begin, end, dest).first;
 }
 
 template<typename InputIt,
@@ -257,17 +351,24 @@ inline size_t Utf16ToUtf32GetSize(InputIt begin, InputIt end)
 template<typename InputIt, typename OutputIt,
 	Internal::EnableIfT<
 		Internal::CanTHold<Internal::ItValType<InputIt>, 4>::value, int> = 0>
-inline void Utf32ToUtf8(InputIt begin, InputIt end, OutputIt dest)
+inline OutputIt Utf32ToUtf8(InputIt begin, InputIt end, OutputIt dest)
 {
 	return UtfConvert(Utf32ToCodePtOnce<InputIt>, CodePtToUtf8Once<OutputIt>,
 		begin, end, dest);
 }
 
-inline std::string Utf32ToUtf8(const std::u32string& in)
+inline void Utf32ToUtf8(Internal::StrInputT<char32_t> in, std::string& out)
+{
+	out.clear();
+
+	Utf32ToUtf8(in.data(), in.data() + in.size(), std::back_inserter(out));
+}
+
+inline std::string Utf32ToUtf8(Internal::StrInputT<char32_t> in)
 {
 	std::string resUtfStr;
 
-	Utf32ToUtf8(in.begin(), in.end(), std::back_inserter(resUtfStr));
+	Utf32ToUtf8(in, resUtfStr);
 
 	return resUtfStr;
 }
@@ -278,7 +379,7 @@ template<typename InputIt, typename OutputIt,
 inline InputIt Utf32ToUtf8Once(InputIt begin, InputIt end, OutputIt dest)
 {
 	return UtfConvertOnce(Utf32ToCodePtOnce<InputIt>, CodePtToUtf8Once<OutputIt>,
-		begin, end, dest);
+		begin, end, dest).first;
 }
 
 template<typename InputIt,
@@ -304,17 +405,24 @@ inline size_t Utf32ToUtf8GetSize(InputIt begin, InputIt end)
 template<typename InputIt, typename OutputIt,
 	Internal::EnableIfT<
 		Internal::CanTHold<Internal::ItValType<InputIt>, 4>::value, int> = 0>
-inline void Utf32ToUtf16(InputIt begin, InputIt end, OutputIt dest)
+inline OutputIt Utf32ToUtf16(InputIt begin, InputIt end, OutputIt dest)
 {
 	return UtfConvert(Utf32ToCodePtOnce<InputIt>, CodePtToUtf16Once<OutputIt>,
 		begin, end, dest);
 }
 
-inline std::u16string Utf32ToUtf16(const std::u32string& in)
+inline void Utf32ToUtf16(Internal::StrInputT<char32_t> in, std::u16string& out)
+{
+	out.clear();
+
+	Utf32ToUtf16(in.data(), in.data() + in.size(), std::back_inserter(out));
+}
+
+inline std::u16string Utf32ToUtf16(Internal::StrInputT<char32_t> in)
 {
 	std::u16string resUtfStr;
 
-	Utf32ToUtf16(in.begin(), in.end(), std::back_inserter(resUtfStr));
+	Utf32ToUtf16(in, resUtfStr);
 
 	return resUtfStr;
 }
@@ -325,7 +433,7 @@ template<typename InputIt, typename OutputIt,
 inline InputIt Utf32ToUtf16Once(InputIt begin, InputIt end, OutputIt dest)
 {
 	return UtfConvertOnce(Utf32ToCodePtOnce<InputIt>, CodePtToUtf16Once<OutputIt>,
-		begin, end, dest);
+		begin, end, dest).first;
 }
 
 template<typename InputIt,
@@ -346,4 +454,656 @@ inline size_t Utf32ToUtf16GetSize(InputIt begin, InputIt end)
 		begin, end);
 }
 
+// ==========  WTF-8 --> WTF-16
+// (see `WtfPolicy`; unpaired surrogates are preserved)
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline OutputIt Wtf8ToWtf16(InputIt begin, InputIt end, OutputIt dest)
+{
+	return UtfConvert(Utf8ToCodePtOnce<InputIt, WtfPolicy>,
+		CodePtToUtf16Once<OutputIt, WtfPolicy>,
+		begin, end, dest);
+}
+
+inline void Wtf8ToWtf16(Internal::StrInputT<char> wtf8, std::u16string& out)
+{
+	out.clear();
+
+	Wtf8ToWtf16(wtf8.data(), wtf8.data() + wtf8.size(), std::back_inserter(out));
+}
+
+inline std::u16string Wtf8ToWtf16(Internal::StrInputT<char> wtf8)
+{
+	std::u16string resUtfStr;
+
+	Wtf8ToWtf16(wtf8, resUtfStr);
+
+	return resUtfStr;
+}
+
+template<typename InputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline size_t Wtf8ToWtf16GetSize(InputIt begin, InputIt end)
+{
+	return UtfConvertGetSize(Utf8ToCodePtOnce<InputIt, WtfPolicy>,
+		Internal::CodePtToUtf16OnceGetSizeByPolicy<WtfPolicy>,
+		begin, end);
+}
+
+// ==========  WTF-16 --> WTF-8
+// (see `WtfPolicy`; unpaired surrogates are preserved)
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 2>::value, int> = 0>
+inline OutputIt Wtf16ToWtf8(InputIt begin, InputIt end, OutputIt dest)
+{
+	return UtfConvert(Utf16ToCodePtOnce<InputIt, WtfPolicy>,
+		CodePtToUtf8Once<OutputIt, WtfPolicy>,
+		begin, end, dest);
+}
+
+inline void Wtf16ToWtf8(Internal::StrInputT<char16_t> in, std::string& out)
+{
+	out.clear();
+
+	Wtf16ToWtf8(in.data(), in.data() + in.size(), std::back_inserter(out));
+}
+
+inline std::string Wtf16ToWtf8(Internal::StrInputT<char16_t> in)
+{
+	std::string resUtfStr;
+
+	Wtf16ToWtf8(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+template<typename InputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 2>::value, int> = 0>
+inline size_t Wtf16ToWtf8GetSize(InputIt begin, InputIt end)
+{
+	return UtfConvertGetSize(Utf16ToCodePtOnce<InputIt, WtfPolicy>,
+		Internal::CodePtToUtf8OnceGetSizeByPolicy<WtfPolicy>,
+		begin, end);
+}
+
+// ==================================================
+// Conversions with newline normalization
+// (see `NewlineNormalizer`)
+// ==================================================
+
+// ==========  UTF-8 --> UTF-16
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline OutputIt Utf8ToUtf16(InputIt begin, InputIt end, OutputIt dest,
+	NewlineNormalizer& newlines)
+{
+	return Internal::UtfConvertNewlines<char16_t>(
+		Utf8ToCodePtOnce<InputIt>, CodePtToUtf16Once<OutputIt>,
+		begin, end, dest, newlines);
+}
+
+inline void Utf8ToUtf16(Internal::StrInputT<char> utf8, std::u16string& out,
+	NewlineNormalizer& newlines)
+{
+	out.clear();
+
+	Utf8ToUtf16(utf8.data(), utf8.data() + utf8.size(), std::back_inserter(out),
+		newlines);
+}
+
+// ==========  UTF-8 --> UTF-32
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline OutputIt Utf8ToUtf32(InputIt begin, InputIt end, OutputIt dest,
+	NewlineNormalizer& newlines)
+{
+	return Internal::UtfConvertNewlines<char32_t>(
+		Utf8ToCodePtOnce<InputIt>, CodePtToUtf32Once<OutputIt>,
+		begin, end, dest, newlines);
+}
+
+inline void Utf8ToUtf32(Internal::StrInputT<char> utf8, std::u32string& out,
+	NewlineNormalizer& newlines)
+{
+	out.clear();
+
+	Utf8ToUtf32(utf8.data(), utf8.data() + utf8.size(), std::back_inserter(out),
+		newlines);
+}
+
+// ==========  UTF-16 --> UTF-8
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 2>::value, int> = 0>
+inline OutputIt Utf16ToUtf8(InputIt begin, InputIt end, OutputIt dest,
+	NewlineNormalizer& newlines)
+{
+	return Internal::UtfConvertNewlines<char>(
+		Utf16ToCodePtOnce<InputIt>, CodePtToUtf8Once<OutputIt>,
+		begin, end, dest, newlines);
+}
+
+inline void Utf16ToUtf8(Internal::StrInputT<char16_t> in, std::string& out,
+	NewlineNormalizer& newlines)
+{
+	out.clear();
+
+	Utf16ToUtf8(in.data(), in.data() + in.size(), std::back_inserter(out),
+		newlines);
+}
+
+// ==========  UTF-16 --> UTF-32
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 2>::value, int> = 0>
+inline OutputIt Utf16ToUtf32(InputIt begin, InputIt end, OutputIt dest,
+	NewlineNormalizer& newlines)
+{
+	return Internal::UtfConvertNewlines<char32_t>(
+		Utf16ToCodePtOnce<InputIt>, CodePtToUtf32Once<OutputIt>,
+		begin, end, dest, newlines);
+}
+
+inline void Utf16ToUtf32(Internal::StrInputT<char16_t> in, std::u32string& out,
+	NewlineNormalizer& newlines)
+{
+	out.clear();
+
+	Utf16ToUtf32(in.data(), in.data() + in.size(), std::back_inserter(out),
+		newlines);
+}
+
+// ==========  UTF-32 --> UTF-8
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 4>::value, int> = 0>
+inline OutputIt Utf32ToUtf8(InputIt begin, InputIt end, OutputIt dest,
+	NewlineNormalizer& newlines)
+{
+	return Internal::UtfConvertNewlines<char>(
+		Utf32ToCodePtOnce<InputIt>, CodePtToUtf8Once<OutputIt>,
+		begin, end, dest, newlines);
+}
+
+inline void Utf32ToUtf8(Internal::StrInputT<char32_t> in, std::string& out,
+	NewlineNormalizer& newlines)
+{
+	out.clear();
+
+	Utf32ToUtf8(in.data(), in.data() + in.size(), std::back_inserter(out),
+		newlines);
+}
+
+// ==========  UTF-32 --> UTF-16
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 4>::value, int> = 0>
+inline OutputIt Utf32ToUtf16(InputIt begin, InputIt end, OutputIt dest,
+	NewlineNormalizer& newlines)
+{
+	return Internal::UtfConvertNewlines<char16_t>(
+		Utf32ToCodePtOnce<InputIt>, CodePtToUtf16Once<OutputIt>,
+		begin, end, dest, newlines);
+}
+
+inline void Utf32ToUtf16(Internal::StrInputT<char32_t> in, std::u16string& out,
+	NewlineNormalizer& newlines)
+{
+	out.clear();
+
+	Utf32ToUtf16(in.data(), in.data() + in.size(), std::back_inserter(out),
+		newlines);
+}
+
+// ==================================================
+// Conversions of input that is assumed to be valid
+// (nothing is validated, unless `SIMPLEUTF_CHECK_ASSUME_VALID` is defined;
+// the output of invalid input is unspecified, but it's still bounded by the
+// input, e.g., a sequence cut off at the end is decoded as a shorter one)
+// ==================================================
+
+namespace Internal
+{
+
+/**
+ * @brief Converts [begin, end), which is assumed to be valid, into `out`,
+ *        which is resized to exactly `outSize` code units first.
+ *
+ */
+template<typename InBoundFunc, typename OutBoundFunc,
+	typename _InCharType, typename _OutCharType>
+inline void UtfConvertUncheckedSized(InBoundFunc inFunc, OutBoundFunc outFunc,
+	const _InCharType* begin, const _InCharType* end,
+	size_t outSize,
+	std::basic_string<_OutCharType>& out)
+{
+	out.resize(outSize);
+	UtfConvert(inFunc, outFunc, begin, end, &out[0]);
+}
+
+/**
+ * @brief Converts [begin, end), which is assumed to be valid, into `out`;
+ *        the exact size of the output is found by a (cheap) pass with
+ *        `outSizeFunc` first, so no memory is over-allocated.
+ *
+ */
+template<typename InBoundFunc, typename OutBoundFunc, typename OutSizeFunc,
+	typename _InCharType, typename _OutCharType>
+inline void UtfConvertUnchecked(InBoundFunc inFunc, OutBoundFunc outFunc,
+	OutSizeFunc outSizeFunc,
+	const _InCharType* begin, const _InCharType* end,
+	std::basic_string<_OutCharType>& out)
+{
+	UtfConvertUncheckedSized(inFunc, outFunc, begin, end,
+		UtfConvertGetSize(inFunc, outSizeFunc, begin, end), out);
+}
+
+} // namespace Internal
+
+// ==========  UTF-8 --> UTF-16
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline OutputIt Utf8ToUtf16Unchecked(InputIt begin, InputIt end, OutputIt dest)
+{
+	return UtfConvert(Internal::Utf8ToCodePtOnceUnchecked<InputIt>,
+		Internal::CodePtToUtf16OnceUnchecked<OutputIt>,
+		begin, end, dest);
+}
+
+inline void Utf8ToUtf16Unchecked(Internal::StrInputT<char> utf8, std::u16string& out)
+{
+	Internal::UtfConvertUnchecked(
+		Internal::Utf8ToCodePtOnceUnchecked<const char*>,
+		Internal::CodePtToUtf16OnceUnchecked<char16_t*>,
+		Internal::CodePtToUtf16OnceGetSizeUnchecked,
+		utf8.data(), utf8.data() + utf8.size(), out);
+}
+
+inline std::u16string Utf8ToUtf16Unchecked(Internal::StrInputT<char> utf8)
+{
+	std::u16string resUtfStr;
+
+	Utf8ToUtf16Unchecked(utf8, resUtfStr);
+
+	return resUtfStr;
+}
+
+template<typename InputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline size_t Utf8ToUtf16GetSizeUnchecked(InputIt begin, InputIt end)
+{
+	return UtfConvertGetSize(Internal::Utf8ToCodePtOnceUnchecked<InputIt>,
+		Internal::CodePtToUtf16OnceGetSizeUnchecked,
+		begin, end);
+}
+
+// ==========  UTF-8 --> UTF-32
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline OutputIt Utf8ToUtf32Unchecked(InputIt begin, InputIt end, OutputIt dest)
+{
+	return UtfConvert(Internal::Utf8ToCodePtOnceUnchecked<InputIt>,
+		Internal::CodePtToUtf32OnceUnchecked<OutputIt>,
+		begin, end, dest);
+}
+
+inline void Utf8ToUtf32Unchecked(Internal::StrInputT<char> utf8, std::u32string& out)
+{
+	Internal::UtfConvertUnchecked(
+		Internal::Utf8ToCodePtOnceUnchecked<const char*>,
+		Internal::CodePtToUtf32OnceUnchecked<char32_t*>,
+		Internal::CodePtToUtf32OnceGetSizeUnchecked,
+		utf8.data(), utf8.data() + utf8.size(), out);
+}
+
+inline std::u32string Utf8ToUtf32Unchecked(Internal::StrInputT<char> utf8)
+{
+	std::u32string resUtfStr;
+
+	Utf8ToUtf32Unchecked(utf8, resUtfStr);
+
+	return resUtfStr;
+}
+
+template<typename InputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 1>::value, int> = 0>
+inline size_t Utf8ToUtf32GetSizeUnchecked(InputIt begin, InputIt end)
+{
+	return UtfConvertGetSize(Internal::Utf8ToCodePtOnceUnchecked<InputIt>,
+		Internal::CodePtToUtf32OnceGetSizeUnchecked,
+		begin, end);
+}
+
+// ==========  UTF-16 --> UTF-8
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 2>::value, int> = 0>
+inline OutputIt Utf16ToUtf8Unchecked(InputIt begin, InputIt end, OutputIt dest)
+{
+	return UtfConvert(Internal::Utf16ToCodePtOnceUnchecked<InputIt>,
+		Internal::CodePtToUtf8OnceUnchecked<OutputIt>,
+		begin, end, dest);
+}
+
+inline void Utf16ToUtf8Unchecked(Internal::StrInputT<char16_t> in, std::string& out)
+{
+	Internal::UtfConvertUnchecked(
+		Internal::Utf16ToCodePtOnceUnchecked<const char16_t*>,
+		Internal::CodePtToUtf8OnceUnchecked<char*>,
+		Internal::CodePtToUtf8OnceGetSizeUnchecked,
+		in.data(), in.data() + in.size(), out);
+}
+
+inline std::string Utf16ToUtf8Unchecked(Internal::StrInputT<char16_t> in)
+{
+	std::string resUtfStr;
+
+	Utf16ToUtf8Unchecked(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+template<typename InputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 2>::value, int> = 0>
+inline size_t Utf16ToUtf8GetSizeUnchecked(InputIt begin, InputIt end)
+{
+	return UtfConvertGetSize(Internal::Utf16ToCodePtOnceUnchecked<InputIt>,
+		Internal::CodePtToUtf8OnceGetSizeUnchecked,
+		begin, end);
+}
+
+// ==========  UTF-16 --> UTF-32
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 2>::value, int> = 0>
+inline OutputIt Utf16ToUtf32Unchecked(InputIt begin, InputIt end, OutputIt dest)
+{
+	return UtfConvert(Internal::Utf16ToCodePtOnceUnchecked<InputIt>,
+		Internal::CodePtToUtf32OnceUnchecked<OutputIt>,
+		begin, end, dest);
+}
+
+inline void Utf16ToUtf32Unchecked(Internal::StrInputT<char16_t> in, std::u32string& out)
+{
+	Internal::UtfConvertUnchecked(
+		Internal::Utf16ToCodePtOnceUnchecked<const char16_t*>,
+		Internal::CodePtToUtf32OnceUnchecked<char32_t*>,
+		Internal::CodePtToUtf32OnceGetSizeUnchecked,
+		in.data(), in.data() + in.size(), out);
+}
+
+inline std::u32string Utf16ToUtf32Unchecked(Internal::StrInputT<char16_t> in)
+{
+	std::u32string resUtfStr;
+
+	Utf16ToUtf32Unchecked(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+template<typename InputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 2>::value, int> = 0>
+inline size_t Utf16ToUtf32GetSizeUnchecked(InputIt begin, InputIt end)
+{
+	return UtfConvertGetSize(Internal::Utf16ToCodePtOnceUnchecked<InputIt>,
+		Internal::CodePtToUtf32OnceGetSizeUnchecked,
+		begin, end);
+}
+
+// ==========  UTF-32 --> UTF-8
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 4>::value, int> = 0>
+inline OutputIt Utf32ToUtf8Unchecked(InputIt begin, InputIt end, OutputIt dest)
+{
+	return UtfConvert(Internal::Utf32ToCodePtOnceUnchecked<InputIt>,
+		Internal::CodePtToUtf8OnceUnchecked<OutputIt>,
+		begin, end, dest);
+}
+
+inline void Utf32ToUtf8Unchecked(Internal::StrInputT<char32_t> in, std::string& out)
+{
+	Internal::UtfConvertUnchecked(
+		Internal::Utf32ToCodePtOnceUnchecked<const char32_t*>,
+		Internal::CodePtToUtf8OnceUnchecked<char*>,
+		Internal::CodePtToUtf8OnceGetSizeUnchecked,
+		in.data(), in.data() + in.size(), out);
+}
+
+inline std::string Utf32ToUtf8Unchecked(Internal::StrInputT<char32_t> in)
+{
+	std::string resUtfStr;
+
+	Utf32ToUtf8Unchecked(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+template<typename InputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 4>::value, int> = 0>
+inline size_t Utf32ToUtf8GetSizeUnchecked(InputIt begin, InputIt end)
+{
+	return UtfConvertGetSize(Internal::Utf32ToCodePtOnceUnchecked<InputIt>,
+		Internal::CodePtToUtf8OnceGetSizeUnchecked,
+		begin, end);
+}
+
+// ==========  UTF-32 --> UTF-16
+
+template<typename InputIt, typename OutputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 4>::value, int> = 0>
+inline OutputIt Utf32ToUtf16Unchecked(InputIt begin, InputIt end, OutputIt dest)
+{
+	return UtfConvert(Internal::Utf32ToCodePtOnceUnchecked<InputIt>,
+		Internal::CodePtToUtf16OnceUnchecked<OutputIt>,
+		begin, end, dest);
+}
+
+inline void Utf32ToUtf16Unchecked(Internal::StrInputT<char32_t> in, std::u16string& out)
+{
+	Internal::UtfConvertUnchecked(
+		Internal::Utf32ToCodePtOnceUnchecked<const char32_t*>,
+		Internal::CodePtToUtf16OnceUnchecked<char16_t*>,
+		Internal::CodePtToUtf16OnceGetSizeUnchecked,
+		in.data(), in.data() + in.size(), out);
+}
+
+inline std::u16string Utf32ToUtf16Unchecked(Internal::StrInputT<char32_t> in)
+{
+	std::u16string resUtfStr;
+
+	Utf32ToUtf16Unchecked(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+template<typename InputIt,
+	Internal::EnableIfT<
+		Internal::CanTHold<Internal::ItValType<InputIt>, 4>::value, int> = 0>
+inline size_t Utf32ToUtf16GetSizeUnchecked(InputIt begin, InputIt end)
+{
+	return UtfConvertGetSize(Internal::Utf32ToCodePtOnceUnchecked<InputIt>,
+		Internal::CodePtToUtf16OnceGetSizeUnchecked,
+		begin, end);
+}
+
+// ==================================================
+// Conversions of validated strings
+// (see `Utf8String` and `Utf16String`; the input is not validated again)
+// ==================================================
+
+namespace Internal
+{
+
+/**
+ * @brief Copies ASCII-only [begin, end) into `out`, one code unit each
+ *
+ */
+template<typename _InCharType, typename _OutCharType>
+inline void UtfCopyAscii(const _InCharType* begin, const _InCharType* end,
+	std::basic_string<_OutCharType>& out)
+{
+	out.resize(static_cast<size_t>(end - begin));
+	_OutCharType* dest = &out[0];
+	for (; begin != end; ++begin, ++dest)
+	{
+		*dest = static_cast<_OutCharType>(*begin);
+	}
+}
+
+} // namespace Internal
+
+// ==========  UTF-8 --> UTF-16
+
+inline void Utf8ToUtf16(const Utf8String& utf8, std::u16string& out)
+{
+	if (utf8.IsAscii())
+	{
+		Internal::UtfCopyAscii(utf8.data(), utf8.data() + utf8.size(), out);
+		return;
+	}
+
+	Utf8ToUtf16Unchecked(utf8.Get(), out);
+}
+
+inline std::u16string Utf8ToUtf16(const Utf8String& utf8)
+{
+	std::u16string resUtfStr;
+
+	Utf8ToUtf16(utf8, resUtfStr);
+
+	return resUtfStr;
+}
+
+inline size_t Utf8ToUtf16GetSize(const Utf8String& utf8)
+{
+	if (utf8.IsAscii())
+	{
+		return utf8.size();
+	}
+
+	return Utf8ToUtf16GetSizeUnchecked(utf8.data(), utf8.data() + utf8.size());
+}
+
+// ==========  UTF-8 --> UTF-32
+
+inline void Utf8ToUtf32(const Utf8String& utf8, std::u32string& out)
+{
+	if (utf8.IsAscii())
+	{
+		Internal::UtfCopyAscii(utf8.data(), utf8.data() + utf8.size(), out);
+		return;
+	}
+
+	// the number of code points is known
+	Internal::UtfConvertUncheckedSized(
+		Internal::Utf8ToCodePtOnceUnchecked<const char*>,
+		Internal::CodePtToUtf32OnceUnchecked<char32_t*>,
+		utf8.data(), utf8.data() + utf8.size(), utf8.GetNumCodePts(), out);
+}
+
+inline std::u32string Utf8ToUtf32(const Utf8String& utf8)
+{
+	std::u32string resUtfStr;
+
+	Utf8ToUtf32(utf8, resUtfStr);
+
+	return resUtfStr;
+}
+
+inline size_t Utf8ToUtf32GetSize(const Utf8String& utf8)
+{
+	return utf8.GetNumCodePts();
+}
+
+// ==========  UTF-16 --> UTF-8
+
+inline void Utf16ToUtf8(const Utf16String& in, std::string& out)
+{
+	if (in.IsAscii())
+	{
+		Internal::UtfCopyAscii(in.data(), in.data() + in.size(), out);
+		return;
+	}
+
+	Utf16ToUtf8Unchecked(in.Get(), out);
+}
+
+inline std::string Utf16ToUtf8(const Utf16String& in)
+{
+	std::string resUtfStr;
+
+	Utf16ToUtf8(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+inline size_t Utf16ToUtf8GetSize(const Utf16String& in)
+{
+	if (in.IsAscii())
+	{
+		return in.size();
+	}
+
+	return Utf16ToUtf8GetSizeUnchecked(in.data(), in.data() + in.size());
+}
+
+// ==========  UTF-16 --> UTF-32
+
+inline void Utf16ToUtf32(const Utf16String& in, std::u32string& out)
+{
+	if (in.IsAscii())
+	{
+		Internal::UtfCopyAscii(in.data(), in.data() + in.size(), out);
+		return;
+	}
+
+	// the number of code points is known
+	Internal::UtfConvertUncheckedSized(
+		Internal::Utf16ToCodePtOnceUnchecked<const char16_t*>,
+		Internal::CodePtToUtf32OnceUnchecked<char32_t*>,
+		in.data(), in.data() + in.size(), in.GetNumCodePts(), out);
+}
+
+inline std::u32string Utf16ToUtf32(const Utf16String& in)
+{
+	std::u32string resUtfStr;
+
+	Utf16ToUtf32(in, resUtfStr);
+
+	return resUtfStr;
+}
+
+inline size_t Utf16ToUtf32GetSize(const Utf16String& in)
+{
+	return in.GetNumCodePts();
+}
+
 } // namespace SimpleUtf
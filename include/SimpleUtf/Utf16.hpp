@@ -56,9 +56,26 @@ inline bool IsUtf16SurrogateSecond(const _ValType& val)
 		(val & 0x0400U);            // 0000 0100 0000 0000
 }
 
+/**
+ * @brief Moves `pos` backward if it points to the second half of a
+ *        surrogate pair, so that it points to the beginning of a UTF-16
+ *        sequence; this doesn't validate the sequence.
+ *
+ */
+template<typename _ItType>
+inline _ItType Utf16SeqBegin(_ItType begin, _ItType pos)
+{
+	if ((pos != begin) && IsUtf16SurrogateSecond(BitCast2Unsigned(*pos)))
+	{
+		--pos;
+	}
+	return pos;
+}
+
 } // namespace Internal
 
 template<typename InputIt,
+	typename _Policy = UtfStrictPolicy,
 	Internal::EnableIfT<
 		Internal::CanTHold<
 			typename std::iterator_traits<InputIt>::value_type, 2>::value
@@ -67,6 +84,7 @@ inline std::pair<char32_t, InputIt> Utf16ToCodePtOnce(InputIt begin, InputIt end
 {
 	if (begin == end)
 	{
+		SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
 		throw UtfConversionException("Unexpected Ending" " - "
 			"String ends unexpected while reading the next UTF-16 bytes.");
 	}
@@ -80,69 +98,135 @@ inline std::pair<char32_t, InputIt> Utf16ToCodePtOnce(InputIt begin, InputIt end
 	{
 		if (begin == end)
 		{
+			if (_Policy::AllowLoneSurrogates())
+			{
+				SIMPLEUTF_STATS_ADD(BytesIn, 2);
+				return std::make_pair(static_cast<char32_t>(uval1), begin);
+			}
+
+			SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
 			throw UtfConversionException("Unexpected Ending" " - "
 				"String ends unexpected while reading the next UTF-16 bytes.");
 		}
 		auto uval2 = Internal::BitCast2Unsigned(*begin);
-		++begin;
 		Internal::EnsureByteSize<2>(uval2);
 
 		if (Internal::IsUtf16SurrogateSecond(uval2))
 		{
+			++begin;
+
 			char32_t res = 0x10000U;
 			res += static_cast<char32_t>((uval1 & 0x03FFU) << 10);
 			res += static_cast<char32_t>((uval2 & 0x03FFU));
 
-			if (!Internal::IsValidCodePt(res))
+			if (!_Policy::IsValidCodePt(res))
 			{
+				SIMPLEUTF_STATS_ADD(ErrInvalidCodePoint, 1);
 				throw UtfConversionException("Invalid Code Point" " - "
 					"The code point read from the given UTF-16 encoding is invalid.");
 			}
 
+			SIMPLEUTF_STATS_ADD(BytesIn, 4);
+			SIMPLEUTF_STATS_ADD(Utf16DecodedSurrogatePairs, 1);
+
 			return std::make_pair(
 				res,
 				begin
 			);
 		}
+		else if (_Policy::AllowLoneSurrogates())
+		// unpaired high surrogate; the next unit is left unread
+		{
+			SIMPLEUTF_STATS_ADD(BytesIn, 2);
+			return std::make_pair(static_cast<char32_t>(uval1), begin);
+		}
 	}
-	else if (!Internal::IsUtf16SurrogateSecond(uval1))
-	// !Surrogate First && !Surrogate Second
+	else if (_Policy::AllowLoneSurrogates() ||
+		!Internal::IsUtf16SurrogateSecond(uval1))
+	// !Surrogate First && (!Surrogate Second || lone surrogates allowed)
 	{
 		char32_t res = static_cast<char32_t>(uval1);;
 
-		if (!Internal::IsValidCodePt(res))
+		if (!_Policy::IsValidCodePt(res))
 		{
+			SIMPLEUTF_STATS_ADD(ErrInvalidCodePoint, 1);
 			throw UtfConversionException("Invalid Code Point" " - "
 				"The code point read from the given UTF-16 encoding is invalid.");
 		}
 
+		SIMPLEUTF_STATS_ADD(BytesIn, 2);
+
 		return std::make_pair(
 			res,
 			begin
 		);
 	}
 
+	SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
 	throw UtfConversionException("Invalid Encoding" " - "
 		"Invalid UTF-16 leading bytes.");
 }
 
-template<typename OutputIt>
-inline void CodePtToUtf16Once(char32_t val, OutputIt oit)
+/**
+ * @brief Decodes the code point that ends right before `pos`, walking back
+ *        over the second half of a surrogate pair; the sequence is validated
+ *        the same way as by `Utf16ToCodePtOnce`.
+ *
+ * @return the code point, and the iterator to the beginning of its sequence
+ */
+template<typename InputIt,
+	typename _Policy = UtfStrictPolicy,
+	Internal::EnableIfT<
+		Internal::CanTHold<
+			typename std::iterator_traits<InputIt>::value_type, 2>::value
+	, int> = 0>
+inline std::pair<char32_t, InputIt> Utf16PrevCodePt(InputIt begin, InputIt pos)
 {
-	if (!Internal::IsValidCodePt(val))
+	if (pos == begin)
 	{
+		SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
+		throw UtfConversionException("Unexpected Ending" " - "
+			"String begins unexpected while reading the previous UTF-16 bytes.");
+	}
+
+	InputIt last = pos;
+	--last;
+	InputIt seqBegin = Internal::Utf16SeqBegin(begin, last);
+
+	// if the unit before an unpaired second half is not a first half, the
+	// first decode stops before the second half
+	auto res = Utf16ToCodePtOnce<InputIt, _Policy>(seqBegin, pos);
+	if (res.second != pos)
+	{
+		seqBegin = res.second;
+		res = Utf16ToCodePtOnce<InputIt, _Policy>(seqBegin, pos);
+	}
+
+	return std::make_pair(res.first, seqBegin);
+}
+
+template<typename OutputIt, typename _Policy = UtfStrictPolicy>
+inline OutputIt CodePtToUtf16Once(char32_t val, OutputIt oit)
+{
+	if (!_Policy::IsValidCodePt(val))
+	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidCodePoint, 1);
 		throw UtfConversionException("Invalid UTF Code Point" " - "
 			+ std::to_string(val) + " is not a valid UTF code point.");
 	}
 
 	char16_t resUtf[2] = { 0 };
 
-	if ((/* 0x0000U <= val && */ val <= 0xD7FFU) ||
-		(0xE000U <= val && val <= 0xFFFFU))
+	// Surrogate code points (0xD800 ~ 0xDFFF) only pass the check above
+	// if lone surrogates are allowed, and they are kept as a single unit
+	if (/* 0x0000U <= val && */ val <= 0xFFFFU)
 	// Single 16 bits encoding
 	{
 		resUtf[0] = static_cast<char16_t>(val);
-		std::copy(std::begin(resUtf), std::begin(resUtf) + 1, oit);
+
+		SIMPLEUTF_STATS_ADD(BytesOut, 2);
+
+		return std::copy(std::begin(resUtf), std::begin(resUtf) + 1, oit);
 	}
 	else
 	// Surrogate Pairs
@@ -152,20 +236,32 @@ inline void CodePtToUtf16Once(char32_t val, OutputIt oit)
 		resUtf[0] = static_cast<char16_t>(0xD800U | (code >> 10));
 		resUtf[1] = static_cast<char16_t>(0xDC00U | (code & 0x3FFU));
 
-		std::copy(std::begin(resUtf), std::end(resUtf), oit);
+		SIMPLEUTF_STATS_ADD(BytesOut, 4);
+		SIMPLEUTF_STATS_ADD(Utf16EncodedSurrogatePairs, 1);
+
+		return std::copy(std::begin(resUtf), std::end(resUtf), oit);
 	}
 }
 
-inline size_t CodePtToUtf16OnceGetSize(char32_t val)
+namespace Internal
+{
+
+/**
+ * @brief `CodePtToUtf16OnceGetSize` under the given policy; it's a separate
+ *        function, so `CodePtToUtf16OnceGetSize` can still be passed by name.
+ *
+ */
+template<typename _Policy>
+inline size_t CodePtToUtf16OnceGetSizeByPolicy(char32_t val)
 {
-	if (!Internal::IsValidCodePt(val))
+	if (!_Policy::IsValidCodePt(val))
 	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidCodePoint, 1);
 		throw UtfConversionException("Invalid UTF Code Point" " - "
 			+ std::to_string(val) + " is not a valid UTF code point.");
 	}
 
-	if ((/* 0x0000U <= val && */ val <= 0xD7FFU) ||
-		(0xE000U <= val && val <= 0xFFFFU))
+	if (/* 0x0000U <= val && */ val <= 0xFFFFU)
 	// Single 16 bits encoding
 	{
 		return 1;
@@ -177,4 +273,82 @@ inline size_t CodePtToUtf16OnceGetSize(char32_t val)
 	}
 }
 
+} // namespace Internal
+
+inline size_t CodePtToUtf16OnceGetSize(char32_t val)
+{
+	return Internal::CodePtToUtf16OnceGetSizeByPolicy<UtfStrictPolicy>(val);
+}
+
+// ==================================================
+// Unchecked decoding and encoding, for input that is known to be valid
+// (e.g., `Utf16String`); invalid input is not detected (unless
+// `SIMPLEUTF_CHECK_ASSUME_VALID` is defined), and the results of it are
+// unspecified, but nothing is read beyond the end of the input
+// ==================================================
+
+namespace Internal
+{
+
+template<typename InputIt>
+inline std::pair<char32_t, InputIt> Utf16ToCodePtOnceUnchecked(
+	InputIt begin, InputIt end)
+{
+#ifdef SIMPLEUTF_CHECK_ASSUME_VALID
+	return Utf16ToCodePtOnce(begin, end);
+#else
+	const char32_t uval1 = static_cast<char32_t>(BitCast2Unsigned(*begin));
+	++begin;
+	// 1101 10xx xxxx xxxx, and not cut off at the end
+	if (((uval1 & 0xFC00U) != 0xD800U) || (begin == end))
+	{
+		SIMPLEUTF_STATS_ADD(BytesIn, 2);
+		return std::make_pair(uval1, begin);
+	}
+
+	const char32_t uval2 = static_cast<char32_t>(BitCast2Unsigned(*begin));
+	++begin;
+
+	SIMPLEUTF_STATS_ADD(BytesIn, 4);
+	SIMPLEUTF_STATS_ADD(Utf16DecodedSurrogatePairs, 1);
+
+	return std::make_pair(
+		0x10000U + ((uval1 & 0x03FFU) << 10) + (uval2 & 0x03FFU),
+		begin
+	);
+#endif // SIMPLEUTF_CHECK_ASSUME_VALID
+}
+
+template<typename OutputIt>
+inline OutputIt CodePtToUtf16OnceUnchecked(char32_t val, OutputIt oit)
+{
+	if (val <= 0xFFFFU)
+	{
+		*oit = static_cast<char16_t>(val);
+		++oit;
+
+		SIMPLEUTF_STATS_ADD(BytesOut, 2);
+	}
+	else
+	{
+		const char32_t code = (val - 0x10000U);
+		*oit = static_cast<char16_t>(0xD800U | (code >> 10));
+		++oit;
+		*oit = static_cast<char16_t>(0xDC00U | (code & 0x3FFU));
+		++oit;
+
+		SIMPLEUTF_STATS_ADD(BytesOut, 4);
+		SIMPLEUTF_STATS_ADD(Utf16EncodedSurrogatePairs, 1);
+	}
+
+	return oit;
+}
+
+inline size_t CodePtToUtf16OnceGetSizeUnchecked(char32_t val)
+{
+	return 1 + static_cast<size_t>(val > 0xFFFFU);
+}
+
+} // namespace Internal
+
 } // namespace SimpleUtf
@@ -14,7 +14,24 @@ namespace SIMPLEUtf_CUSTOMIZED_NAMESPACE
 #endif
 {
 
+namespace Internal
+{
+
+/**
+ * @brief Every UTF-32 code unit is the beginning of a sequence;
+ *        this is here for symmetry with `Utf8SeqBegin` and `Utf16SeqBegin`.
+ *
+ */
+template<typename _ItType>
+inline _ItType Utf32SeqBegin(_ItType, _ItType pos)
+{
+	return pos;
+}
+
+} // namespace Internal
+
 template<typename InputIt,
+	typename _Policy = UtfStrictPolicy,
 	Internal::EnableIfT<
 		Internal::CanTHold<
 			typename std::iterator_traits<InputIt>::value_type, 4>::value
@@ -23,6 +40,7 @@ inline std::pair<char32_t, InputIt> Utf32ToCodePtOnce(InputIt begin, InputIt end
 {
 	if (begin == end)
 	{
+		SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
 		throw UtfConversionException("Unexpected Ending" " - "
 			"String ends unexpected while reading the next UTF-32 bytes.");
 	}
@@ -31,36 +49,52 @@ inline std::pair<char32_t, InputIt> Utf32ToCodePtOnce(InputIt begin, InputIt end
 	Internal::EnsureByteSize<4>(uval);
 	char32_t uval4B = static_cast<char32_t>(uval);
 
-	if(!Internal::IsValidCodePt(uval4B))
+	if(!_Policy::IsValidCodePt(uval4B))
 	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
 		throw UtfConversionException("Invalid Encoding" " - "
 			"Invalid UTF-32 bytes.");
 	}
 
+	SIMPLEUTF_STATS_ADD(BytesIn, 4);
+
 	return std::make_pair(
 		uval4B,
 		begin
 	);
 }
 
-template<typename OutputIt>
-inline void CodePtToUtf32Once(char32_t val, OutputIt oit)
+template<typename OutputIt, typename _Policy = UtfStrictPolicy>
+inline OutputIt CodePtToUtf32Once(char32_t val, OutputIt oit)
 {
-	if (!Internal::IsValidCodePt(val))
+	if (!_Policy::IsValidCodePt(val))
 	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidCodePoint, 1);
 		throw UtfConversionException("Invalid UTF Code Point" " - "
 			+ std::to_string(val) + " is not a valid UTF code point.");
 	}
 
 	char32_t resUtf[1] = { static_cast<char32_t>(val) };
 
-	std::copy(std::begin(resUtf), std::end(resUtf), oit);
+	SIMPLEUTF_STATS_ADD(BytesOut, 4);
+
+	return std::copy(std::begin(resUtf), std::end(resUtf), oit);
 }
 
-inline size_t CodePtToUtf32OnceGetSize(char32_t val)
+namespace Internal
 {
-	if (!Internal::IsValidCodePt(val))
+
+/**
+ * @brief `CodePtToUtf32OnceGetSize` under the given policy; it's a separate
+ *        function, so `CodePtToUtf32OnceGetSize` can still be passed by name.
+ *
+ */
+template<typename _Policy>
+inline size_t CodePtToUtf32OnceGetSizeByPolicy(char32_t val)
+{
+	if (!_Policy::IsValidCodePt(val))
 	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidCodePoint, 1);
 		throw UtfConversionException("Invalid UTF Code Point" " - "
 			+ std::to_string(val) + " is not a valid UTF code point.");
 	}
@@ -68,4 +102,55 @@ inline size_t CodePtToUtf32OnceGetSize(char32_t val)
 	return 1;
 }
 
+} // namespace Internal
+
+inline size_t CodePtToUtf32OnceGetSize(char32_t val)
+{
+	return Internal::CodePtToUtf32OnceGetSizeByPolicy<UtfStrictPolicy>(val);
+}
+
+// ==================================================
+// Unchecked decoding and encoding, for input that is known to be valid
+// (see `SIMPLEUTF_CHECK_ASSUME_VALID`)
+// ==================================================
+
+namespace Internal
+{
+
+template<typename InputIt>
+inline std::pair<char32_t, InputIt> Utf32ToCodePtOnceUnchecked(
+	InputIt begin, InputIt end)
+{
+#ifdef SIMPLEUTF_CHECK_ASSUME_VALID
+	return Utf32ToCodePtOnce(begin, end);
+#else
+	(void)end;
+
+	const char32_t uval = static_cast<char32_t>(BitCast2Unsigned(*begin));
+	++begin;
+
+	SIMPLEUTF_STATS_ADD(BytesIn, 4);
+
+	return std::make_pair(uval, begin);
+#endif // SIMPLEUTF_CHECK_ASSUME_VALID
+}
+
+template<typename OutputIt>
+inline OutputIt CodePtToUtf32OnceUnchecked(char32_t val, OutputIt oit)
+{
+	*oit = val;
+	++oit;
+
+	SIMPLEUTF_STATS_ADD(BytesOut, 4);
+
+	return oit;
+}
+
+inline size_t CodePtToUtf32OnceGetSizeUnchecked(char32_t)
+{
+	return 1;
+}
+
+} // namespace Internal
+
 } // namespace SimpleUtf
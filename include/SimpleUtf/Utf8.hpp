@@ -17,10 +17,12 @@ namespace SIMPLEUtf_CUSTOMIZED_NAMESPACE
 namespace Internal
 {
 
+template<typename _Policy = UtfStrictPolicy>
 inline size_t CalcUtf8NumContNeeded(char32_t val)
 {
-	if (!IsValidCodePt(val))
+	if (!_Policy::IsValidCodePt(val))
 	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidCodePoint, 1);
 		throw UtfConversionException("Invalid UTF Code Point" " - "
 			+ std::to_string(val) + " is not a valid UTF code point.");
 	}
@@ -57,6 +59,7 @@ inline std::pair<size_t, uint8_t> Utf8ReadLeading(const ValType& val)
 {
 	if(!AsciiTraits<ValType>::IsAByte(val))
 	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
 		throw UtfConversionException("Invalid Encoding" " - "
 			"The given value is bigger than a byte");
 	}
@@ -107,6 +110,7 @@ inline std::pair<size_t, uint8_t> Utf8ReadLeading(const ValType& val)
 	}
 	else
 	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
 		throw UtfConversionException("Invalid Encoding" " - "
 		"Invalid UTF-8 leading byte.");
 	}
@@ -117,6 +121,7 @@ inline uint8_t Utf8ReadCont(const ValType& val)
 {
 	if(!AsciiTraits<ValType>::IsAByte(val))
 	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
 		throw UtfConversionException("Invalid Encoding" " - "
 			"The given value is bigger than a byte");
 	}
@@ -130,22 +135,87 @@ inline uint8_t Utf8ReadCont(const ValType& val)
 	}
 	else
 	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
 		throw UtfConversionException("Invalid Encoding" " - "
 		"Invalid UTF-8 continuation byte.");
 	}
 }
 
+/**
+ * @brief Moves `pos` backward over continuation bytes (at most 3, and not
+ *        before `begin`), so that it points to the beginning of a UTF-8
+ *        sequence; this doesn't validate the sequence.
+ *
+ */
+template<typename _ItType>
+inline _ItType Utf8SeqBegin(_ItType begin, _ItType pos)
+{
+	for (size_t i = 0; (i < 3) && (pos != begin); ++i)
+	{
+		const auto uval = BitCast2Unsigned(*pos);
+		// 10xxxxxx
+		if ((uval & 0xC0U) != 0x80U)
+		{
+			break;
+		}
+		--pos;
+	}
+	return pos;
+}
+
+/**
+ * @brief Does an encoded low surrogate (U+DC00 ~ U+DFFF, i.e.,
+ *        ED B0 80 ~ ED BF BF) begin at `it`? Only the first 2 bytes are
+ *        checked, since they are enough to tell.
+ *
+ */
+template<typename _ItType>
+inline bool Utf8IsLowSurrogateAt(_ItType it, const _ItType& end)
+{
+	if ((it == end) || (BitCast2Unsigned(*it) != 0xEDU))
+	{
+		return false;
+	}
+	++it;
+	return (it != end) && ((BitCast2Unsigned(*it) & 0xF0U) == 0xB0U);
+}
+
+/**
+ * @brief Does an encoded high surrogate (U+D800 ~ U+DBFF, i.e.,
+ *        ED A0 80 ~ ED AF BF) end right before `pos`?
+ *
+ */
+template<typename _ItType>
+inline bool Utf8IsHighSurrogateBefore(const _ItType& begin, _ItType pos)
+{
+	for (size_t i = 0; i < 3; ++i)
+	{
+		if (pos == begin)
+		{
+			return false;
+		}
+		--pos;
+	}
+	_ItType second = pos;
+	++second;
+	return (BitCast2Unsigned(*pos) == 0xEDU) &&
+		((BitCast2Unsigned(*second) & 0xF0U) == 0xA0U);
+}
+
 } // namespace Internal
 
-template<typename InputIt>
+template<typename InputIt, typename _Policy = UtfStrictPolicy>
 inline std::pair<char32_t, InputIt> Utf8ToCodePtOnce(InputIt begin, InputIt end)
 {
 	if (begin == end)
 	{
+		SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
 		throw UtfConversionException("Unexpected Ending" " - "
 			"String ends unexpected while reading the next UTF-8 char.");
 	}
 
+	using BoundCheck = Internal::ItBoundCheck<InputIt>;
+
 	char32_t res = 0;
 
 	uint8_t leading = 0;
@@ -154,8 +224,22 @@ inline std::pair<char32_t, InputIt> Utf8ToCodePtOnce(InputIt begin, InputIt end)
 	++begin;
 	res |= leading;
 
+	if (!BoundCheck::HasAtLeast(begin, end, numCont))
+	{
+		SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
+		throw UtfConversionException("Unexpected Ending" " - "
+			"String ends unexpected while reading the next UTF-8 char.");
+	}
+
 	for (size_t i = 0; i < numCont; ++i)
 	{
+		if (BoundCheck::IsEnd(begin, end))
+		{
+			SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
+			throw UtfConversionException("Unexpected Ending" " - "
+				"String ends unexpected while reading the next UTF-8 char.");
+		}
+
 		uint8_t b = Internal::Utf8ReadCont(*begin);
 		++begin;
 
@@ -168,25 +252,84 @@ inline std::pair<char32_t, InputIt> Utf8ToCodePtOnce(InputIt begin, InputIt end)
 			if ((numCont == 2 && res < 0x20U) ||
 				(numCont == 3 && res < 0x10U))
 			{
+				SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
 				throw UtfConversionException("Invalid Encoding" " - "
 					"Invalid UTF-8 continuation byte.");
 			}
 		}
 	}
 
-	if (!Internal::IsValidCodePt(res))
+	if (!_Policy::IsValidCodePt(res))
 	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidCodePoint, 1);
 		throw UtfConversionException("Invalid Code Point" " - "
 			"The code point read from the given UTF-8 encoding is invalid.");
 	}
 
+	// surrogate code points are only allowed when they are unpaired; a pair
+	// must be encoded as one 4-byte sequence
+	if (_Policy::AllowLoneSurrogates() &&
+		((res & 0xFC00U) == 0xD800U) &&
+		Internal::Utf8IsLowSurrogateAt(begin, end))
+	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+		throw UtfConversionException("Invalid Encoding" " - "
+			"A surrogate pair is encoded as two UTF-8 sequences.");
+	}
+
+	SIMPLEUTF_STATS_ADD(BytesIn, 1 + numCont);
+	SIMPLEUTF_STATS_ADD_NTH(Utf8Decoded1B, numCont, 1);
+
 	return std::make_pair(res, begin);
 }
 
-template<typename OutputIt>
-inline void CodePtToUtf8Once(char32_t val, OutputIt oit)
+/**
+ * @brief Decodes the code point that ends right before `pos`, walking back
+ *        over its continuation bytes; the sequence is validated the same
+ *        way as by `Utf8ToCodePtOnce`.
+ *
+ * @return the code point, and the iterator to the beginning of its sequence
+ */
+template<typename InputIt, typename _Policy = UtfStrictPolicy>
+inline std::pair<char32_t, InputIt> Utf8PrevCodePt(InputIt begin, InputIt pos)
+{
+	if (pos == begin)
+	{
+		SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
+		throw UtfConversionException("Unexpected Ending" " - "
+			"String begins unexpected while reading the previous UTF-8 char.");
+	}
+
+	InputIt last = pos;
+	--last;
+	InputIt seqBegin = Internal::Utf8SeqBegin(begin, last);
+
+	// decode forward up to `pos`; if there are more continuation bytes than
+	// the leading byte asks for, the next decode fails on the stray one
+	auto res = Utf8ToCodePtOnce<InputIt, _Policy>(seqBegin, pos);
+	while (res.second != pos)
+	{
+		seqBegin = res.second;
+		res = Utf8ToCodePtOnce<InputIt, _Policy>(seqBegin, pos);
+	}
+
+	// the same check as in `Utf8ToCodePtOnce`, from the other side
+	if (_Policy::AllowLoneSurrogates() &&
+		((res.first & 0xFC00U) == 0xDC00U) &&
+		Internal::Utf8IsHighSurrogateBefore(begin, seqBegin))
+	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+		throw UtfConversionException("Invalid Encoding" " - "
+			"A surrogate pair is encoded as two UTF-8 sequences.");
+	}
+
+	return std::make_pair(res.first, seqBegin);
+}
+
+template<typename OutputIt, typename _Policy = UtfStrictPolicy>
+inline OutputIt CodePtToUtf8Once(char32_t val, OutputIt oit)
 {
-	size_t numCont = Internal::CalcUtf8NumContNeeded(val);
+	size_t numCont = Internal::CalcUtf8NumContNeeded<_Policy>(val);
 	char res[4]{0, 0, 0, 0};
 
 	for (size_t i = numCont; i > 0; --i)
@@ -229,7 +372,10 @@ inline void CodePtToUtf8Once(char32_t val, OutputIt oit)
 		break;
 	}
 
-	std::copy(std::begin(res), std::begin(res) + 1 + numCont, oit);
+	SIMPLEUTF_STATS_ADD(BytesOut, 1 + numCont);
+	SIMPLEUTF_STATS_ADD_NTH(Utf8Encoded1B, numCont, 1);
+
+	return std::copy(std::begin(res), std::begin(res) + 1 + numCont, oit);
 }
 
 inline size_t CodePtToUtf8OnceGetSize(char32_t val)
@@ -237,4 +383,119 @@ inline size_t CodePtToUtf8OnceGetSize(char32_t val)
 	return 1 + Internal::CalcUtf8NumContNeeded(val);
 }
 
+namespace Internal
+{
+
+/**
+ * @brief `CodePtToUtf8OnceGetSize` under the given policy; it's a separate
+ *        function, so `CodePtToUtf8OnceGetSize` can still be passed by name.
+ *
+ */
+template<typename _Policy>
+inline size_t CodePtToUtf8OnceGetSizeByPolicy(char32_t val)
+{
+	return 1 + CalcUtf8NumContNeeded<_Policy>(val);
+}
+
+} // namespace Internal
+
+// ==================================================
+// Unchecked decoding and encoding, for input that is known to be valid
+// (e.g., `Utf8String`); invalid input is not detected (unless
+// `SIMPLEUTF_CHECK_ASSUME_VALID` is defined), and the results of it are
+// unspecified, but nothing is read beyond the end of the input
+// ==================================================
+
+namespace Internal
+{
+
+template<typename InputIt>
+inline std::pair<char32_t, InputIt> Utf8ToCodePtOnceUnchecked(
+	InputIt begin, InputIt end)
+{
+#ifdef SIMPLEUTF_CHECK_ASSUME_VALID
+	return Utf8ToCodePtOnce(begin, end);
+#else
+	const uint8_t leading = static_cast<uint8_t>(BitCast2Unsigned(*begin));
+	++begin;
+	if (leading < 0x80U)
+	{
+		SIMPLEUTF_STATS_ADD(BytesIn, 1);
+		SIMPLEUTF_STATS_ADD_NTH(Utf8Decoded1B, 0, 1);
+		return std::make_pair(static_cast<char32_t>(leading), begin);
+	}
+
+	// 110xxxxx, 1110xxxx, or 11110xxx
+	const size_t numCont = (leading >= 0xF0U) ? 3 :
+		((leading >= 0xE0U) ? 2 : 1);
+	char32_t res = leading & (0x3FU >> numCont);
+	// a truncated sequence is cut short at `end`, so the reading never
+	// passes `end`, even if the input is not valid
+	for (size_t i = 0; (i < numCont) && (begin != end); ++i)
+	{
+		res <<= 6;
+		res |= static_cast<char32_t>(BitCast2Unsigned(*begin) & 0x3FU);
+		++begin;
+	}
+
+	SIMPLEUTF_STATS_ADD(BytesIn, 1 + numCont);
+	SIMPLEUTF_STATS_ADD_NTH(Utf8Decoded1B, numCont, 1);
+
+	return std::make_pair(res, begin);
+#endif // SIMPLEUTF_CHECK_ASSUME_VALID
+}
+
+template<typename OutputIt>
+inline OutputIt CodePtToUtf8OnceUnchecked(char32_t val, OutputIt oit)
+{
+	auto putByte = [&oit](char32_t b)
+	{
+		*oit = BitCast<char>(static_cast<uint8_t>(b));
+		++oit;
+	};
+
+	if (val < 0x80U)
+	{
+		putByte(val);
+		SIMPLEUTF_STATS_ADD(BytesOut, 1);
+		SIMPLEUTF_STATS_ADD_NTH(Utf8Encoded1B, 0, 1);
+	}
+	else if (val < 0x800U)
+	{
+		putByte(0xC0U | (val >> 6));
+		putByte(0x80U | (val & 0x3FU));
+		SIMPLEUTF_STATS_ADD(BytesOut, 2);
+		SIMPLEUTF_STATS_ADD_NTH(Utf8Encoded1B, 1, 1);
+	}
+	else if (val < 0x10000U)
+	{
+		putByte(0xE0U | (val >> 12));
+		putByte(0x80U | ((val >> 6) & 0x3FU));
+		putByte(0x80U | (val & 0x3FU));
+		SIMPLEUTF_STATS_ADD(BytesOut, 3);
+		SIMPLEUTF_STATS_ADD_NTH(Utf8Encoded1B, 2, 1);
+	}
+	else
+	{
+		putByte(0xF0U | (val >> 18));
+		putByte(0x80U | ((val >> 12) & 0x3FU));
+		putByte(0x80U | ((val >> 6) & 0x3FU));
+		putByte(0x80U | (val & 0x3FU));
+		SIMPLEUTF_STATS_ADD(BytesOut, 4);
+		SIMPLEUTF_STATS_ADD_NTH(Utf8Encoded1B, 3, 1);
+	}
+
+	return oit;
+}
+
+inline size_t CodePtToUtf8OnceGetSizeUnchecked(char32_t val)
+{
+	return 1 +
+		static_cast<size_t>(val >= 0x80U) +
+		static_cast<size_t>(val >= 0x800U) +
+		static_cast<size_t>(val >= 0x10000U);
+}
+
+} // namespace Internal
+
 } // namespace SimpleUtf
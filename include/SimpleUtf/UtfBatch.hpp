@@ -0,0 +1,421 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "Utf.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+/**
+ * @brief A batch of strings stored back to back in a single buffer, in a
+ *        columnar layout (as the one used by Apache Arrow); the i-th string
+ *        is `data[offsets[i], offsets[i + 1])`, and `offsets` has one more
+ *        item than the number of strings, starting with 0.
+ *
+ * @tparam _CharType The type of the code units
+ */
+template<typename _CharType>
+struct UtfBatch
+{
+	using value_type = _CharType;
+
+	std::vector<_CharType> data;
+	std::vector<size_t> offsets;
+
+	size_t Count() const
+	{
+		return offsets.empty() ? 0 : offsets.size() - 1;
+	}
+
+	const _CharType* Begin(size_t i) const
+	{
+		return data.data() + offsets[i];
+	}
+
+	const _CharType* End(size_t i) const
+	{
+		return data.data() + offsets[i + 1];
+	}
+
+	std::basic_string<_CharType> Get(size_t i) const
+	{
+		return std::basic_string<_CharType>(Begin(i), End(i));
+	}
+
+	void Clear()
+	{
+		data.clear();
+		offsets.clear();
+	}
+}; // struct UtfBatch
+
+namespace Internal
+{
+
+/**
+ * @brief Calculates the size of the output of a conversion from UTF-8,
+ *        skipping over runs of ASCII characters (which are always converted
+ *        into a single code unit) with `CountAsciiPrefix`.
+ *
+ */
+template<typename OutBoundGetSizeFunc, typename _ValType>
+inline size_t Utf8ConvertGetSizeAsciiFast(OutBoundGetSizeFunc outFunc,
+	const _ValType* begin, const _ValType* end)
+{
+	size_t size = 0;
+	while (begin != end)
+	{
+		size_t numAscii = CountAsciiPrefix(begin, end);
+		// counted the same as if they were decoded one by one
+		SIMPLEUTF_STATS_ADD(BytesIn, numAscii * sizeof(_ValType));
+		SIMPLEUTF_STATS_ADD(Utf8Decoded1B, numAscii);
+		size += numAscii;
+		begin += numAscii;
+
+		if (begin != end)
+		{
+			size_t tmp = 0;
+			std::tie(tmp, begin) = UtfConvertOnceGetSize(
+				Utf8ToCodePtOnce<const _ValType*>, outFunc, begin, end);
+			size += tmp;
+		}
+	}
+	return size;
+}
+
+/**
+ * @brief Converts from UTF-8, copying runs of ASCII characters directly
+ *        into the output.
+ *
+ */
+template<typename OutBoundFunc, typename _ValType, typename OutputIt>
+inline OutputIt Utf8ConvertAsciiFast(OutBoundFunc outFunc,
+	const _ValType* begin, const _ValType* end,
+	OutputIt dest)
+{
+	while (begin != end)
+	{
+		size_t numAscii = CountAsciiPrefix(begin, end);
+		// counted the same as if they were decoded and encoded one by one
+		SIMPLEUTF_STATS_ADD(BytesIn, numAscii * sizeof(_ValType));
+		SIMPLEUTF_STATS_ADD(BytesOut, numAscii * sizeof(*dest));
+		SIMPLEUTF_STATS_ADD(Utf8Decoded1B, numAscii);
+		dest = std::copy(begin, begin + numAscii, dest);
+		begin += numAscii;
+
+		if (begin != end)
+		{
+			auto codePtRes = Utf8ToCodePtOnce(begin, end);
+			dest = outFunc(codePtRes.first, dest);
+			begin = codePtRes.second;
+		}
+	}
+	return dest;
+}
+
+/**
+ * @brief The type of code units in the strings pointed by `_ItType`
+ *
+ */
+template<typename _ItType>
+using BatchInCharT = typename std::remove_cv<
+	typename std::remove_pointer<
+		decltype(std::declval<_ItType>()->data())
+	>::type
+>::type;
+
+/**
+ * @brief Converts a batch of strings in two passes: the first pass
+ *        calculates the exact size of each output to build the offsets, so
+ *        that the output buffer is only allocated once, and then the
+ *        second pass writes each output directly into its slot.
+ *
+ * @tparam _BatchImpl One of the `UtfXToUtfYBatchImpl` types below
+ * @param begin       Iterator to the first input string; the input string
+ *                    type must provide `data()` and `size()`.
+ * @param end         Iterator past the last input string
+ * @param out         The output batch; its buffers are reused.
+ *
+ * @exception UtfConversionException if any of the input strings is invalid;
+ *            `out` is left as it was on entry (and so it is if the
+ *            allocation fails).
+ */
+template<typename _BatchImpl, typename InputIt>
+inline void UtfConvertBatch(InputIt begin, InputIt end,
+	UtfBatch<typename _BatchImpl::OutCharType>& out)
+{
+	using OutCharType = typename _BatchImpl::OutCharType;
+
+	// the first pass validates all the input, so the second pass can't
+	// throw; until then, the new offsets are kept after the old ones, so
+	// they can be rolled back
+	const size_t numOldOffsets = out.offsets.size();
+	size_t totalSize = 0;
+	try
+	{
+		out.offsets.push_back(0);
+		for (InputIt it = begin; it != end; ++it)
+		{
+			totalSize +=
+				_BatchImpl::GetSize(it->data(), it->data() + it->size());
+			out.offsets.push_back(totalSize);
+		}
+
+		out.data.resize(totalSize);
+	}
+	catch (...)
+	{
+		out.offsets.resize(numOldOffsets);
+		throw;
+	}
+	out.offsets.erase(out.offsets.begin(),
+		out.offsets.begin() + numOldOffsets);
+
+	OutCharType* dest = out.data.data();
+	for (InputIt it = begin; it != end; ++it)
+	{
+		dest = _BatchImpl::Convert(it->data(), it->data() + it->size(), dest);
+	}
+}
+
+/**
+ * @brief The size calculation, conversion, and sequence alignment (see
+ *        `Utf8SeqBegin`) functions used for batch conversions, for each
+ *        direction.
+ *
+ */
+template<typename _InCharType>
+struct Utf8ToUtf16BatchImpl
+{
+	using OutCharType = char16_t;
+
+	// the maximum number of output code units per input code unit
+	static constexpr size_t sk_maxOutPerIn = 1;
+
+	static size_t GetSize(const _InCharType* begin, const _InCharType* end)
+	{
+		return Utf8ConvertGetSizeAsciiFast(CodePtToUtf16OnceGetSize,
+			begin, end);
+	}
+
+	static OutCharType* Convert(
+		const _InCharType* begin, const _InCharType* end, OutCharType* dest)
+	{
+		return Utf8ConvertAsciiFast(CodePtToUtf16Once<OutCharType*>,
+			begin, end, dest);
+	}
+
+	static const _InCharType* SeqBegin(
+		const _InCharType* begin, const _InCharType* pos)
+	{
+		return Utf8SeqBegin(begin, pos);
+	}
+}; // struct Utf8ToUtf16BatchImpl
+
+template<typename _InCharType>
+struct Utf8ToUtf32BatchImpl
+{
+	using OutCharType = char32_t;
+
+	static constexpr size_t sk_maxOutPerIn = 1;
+
+	static size_t GetSize(const _InCharType* begin, const _InCharType* end)
+	{
+		return Utf8ConvertGetSizeAsciiFast(CodePtToUtf32OnceGetSize,
+			begin, end);
+	}
+
+	static OutCharType* Convert(
+		const _InCharType* begin, const _InCharType* end, OutCharType* dest)
+	{
+		return Utf8ConvertAsciiFast(CodePtToUtf32Once<OutCharType*>,
+			begin, end, dest);
+	}
+
+	static const _InCharType* SeqBegin(
+		const _InCharType* begin, const _InCharType* pos)
+	{
+		return Utf8SeqBegin(begin, pos);
+	}
+}; // struct Utf8ToUtf32BatchImpl
+
+template<typename _InCharType>
+struct Utf16ToUtf8BatchImpl
+{
+	using OutCharType = char;
+
+	static constexpr size_t sk_maxOutPerIn = 3;
+
+	static size_t GetSize(const _InCharType* begin, const _InCharType* end)
+	{
+		return Utf16ToUtf8GetSize(begin, end);
+	}
+
+	static OutCharType* Convert(
+		const _InCharType* begin, const _InCharType* end, OutCharType* dest)
+	{
+		return Utf16ToUtf8(begin, end, dest);
+	}
+
+	static const _InCharType* SeqBegin(
+		const _InCharType* begin, const _InCharType* pos)
+	{
+		return Utf16SeqBegin(begin, pos);
+	}
+}; // struct Utf16ToUtf8BatchImpl
+
+template<typename _InCharType>
+struct Utf16ToUtf32BatchImpl
+{
+	using OutCharType = char32_t;
+
+	static constexpr size_t sk_maxOutPerIn = 1;
+
+	static size_t GetSize(const _InCharType* begin, const _InCharType* end)
+	{
+		return Utf16ToUtf32GetSize(begin, end);
+	}
+
+	static OutCharType* Convert(
+		const _InCharType* begin, const _InCharType* end, OutCharType* dest)
+	{
+		return Utf16ToUtf32(begin, end, dest);
+	}
+
+	static const _InCharType* SeqBegin(
+		const _InCharType* begin, const _InCharType* pos)
+	{
+		return Utf16SeqBegin(begin, pos);
+	}
+}; // struct Utf16ToUtf32BatchImpl
+
+template<typename _InCharType>
+struct Utf32ToUtf8BatchImpl
+{
+	using OutCharType = char;
+
+	static constexpr size_t sk_maxOutPerIn = 4;
+
+	static size_t GetSize(const _InCharType* begin, const _InCharType* end)
+	{
+		return Utf32ToUtf8GetSize(begin, end);
+	}
+
+	static OutCharType* Convert(
+		const _InCharType* begin, const _InCharType* end, OutCharType* dest)
+	{
+		return Utf32ToUtf8(begin, end, dest);
+	}
+
+	static const _InCharType* SeqBegin(
+		const _InCharType* begin, const _InCharType* pos)
+	{
+		return Utf32SeqBegin(begin, pos);
+	}
+}; // struct Utf32ToUtf8BatchImpl
+
+template<typename _InCharType>
+struct Utf32ToUtf16BatchImpl
+{
+	using OutCharType = char16_t;
+
+	static constexpr size_t sk_maxOutPerIn = 2;
+
+	static size_t GetSize(const _InCharType* begin, const _InCharType* end)
+	{
+		return Utf32ToUtf16GetSize(begin, end);
+	}
+
+	static OutCharType* Convert(
+		const _InCharType* begin, const _InCharType* end, OutCharType* dest)
+	{
+		return Utf32ToUtf16(begin, end, dest);
+	}
+
+	static const _InCharType* SeqBegin(
+		const _InCharType* begin, const _InCharType* pos)
+	{
+		return Utf32SeqBegin(begin, pos);
+	}
+}; // struct Utf32ToUtf16BatchImpl
+
+} // namespace Internal
+
+// ==========  UTF-8 --> UTF-16
+
+template<typename InputIt>
+inline void Utf8ToUtf16Batch(InputIt begin, InputIt end,
+	UtfBatch<char16_t>& out)
+{
+	Internal::UtfConvertBatch<
+		Internal::Utf8ToUtf16BatchImpl<Internal::BatchInCharT<InputIt> > >(
+			begin, end, out);
+}
+
+// ==========  UTF-8 --> UTF-32
+
+template<typename InputIt>
+inline void Utf8ToUtf32Batch(InputIt begin, InputIt end,
+	UtfBatch<char32_t>& out)
+{
+	Internal::UtfConvertBatch<
+		Internal::Utf8ToUtf32BatchImpl<Internal::BatchInCharT<InputIt> > >(
+			begin, end, out);
+}
+
+// ==========  UTF-16 --> UTF-8
+
+template<typename InputIt>
+inline void Utf16ToUtf8Batch(InputIt begin, InputIt end,
+	UtfBatch<char>& out)
+{
+	Internal::UtfConvertBatch<
+		Internal::Utf16ToUtf8BatchImpl<Internal::BatchInCharT<InputIt> > >(
+			begin, end, out);
+}
+
+// ==========  UTF-16 --> UTF-32
+
+template<typename InputIt>
+inline void Utf16ToUtf32Batch(InputIt begin, InputIt end,
+	UtfBatch<char32_t>& out)
+{
+	Internal::UtfConvertBatch<
+		Internal::Utf16ToUtf32BatchImpl<Internal::BatchInCharT<InputIt> > >(
+			begin, end, out);
+}
+
+// ==========  UTF-32 --> UTF-8
+
+template<typename InputIt>
+inline void Utf32ToUtf8Batch(InputIt begin, InputIt end,
+	UtfBatch<char>& out)
+{
+	Internal::UtfConvertBatch<
+		Internal::Utf32ToUtf8BatchImpl<Internal::BatchInCharT<InputIt> > >(
+			begin, end, out);
+}
+
+// ==========  UTF-32 --> UTF-16
+
+template<typename InputIt>
+inline void Utf32ToUtf16Batch(InputIt begin, InputIt end,
+	UtfBatch<char16_t>& out)
+{
+	Internal::UtfConvertBatch<
+		Internal::Utf32ToUtf16BatchImpl<Internal::BatchInCharT<InputIt> > >(
+			begin, end, out);
+}
+
+} // namespace SimpleUtf
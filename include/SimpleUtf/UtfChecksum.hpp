@@ -0,0 +1,228 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include "UtfBatch.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+/**
+ * @brief CRC-32C (Castagnoli), computed in software 8 bytes at a time
+ *        (slicing-by-8); it can be passed as the hasher of the
+ *        `UtfXToUtfYHashed` functions below.
+ *
+ */
+class Crc32c
+{
+public:
+
+	Crc32c() :
+		m_crc(0xFFFFFFFFU)
+	{}
+
+	void Update(const void* data, size_t size)
+	{
+		const Tables& t = GetTables();
+		const uint8_t* ptr = static_cast<const uint8_t*>(data);
+		uint32_t crc = m_crc;
+
+		for (; size >= 8; ptr += 8, size -= 8)
+		{
+			crc ^= static_cast<uint32_t>(ptr[0]) |
+				(static_cast<uint32_t>(ptr[1]) << 8) |
+				(static_cast<uint32_t>(ptr[2]) << 16) |
+				(static_cast<uint32_t>(ptr[3]) << 24);
+			crc =
+				t[7][crc & 0xFFU] ^
+				t[6][(crc >> 8) & 0xFFU] ^
+				t[5][(crc >> 16) & 0xFFU] ^
+				t[4][crc >> 24] ^
+				t[3][ptr[4]] ^
+				t[2][ptr[5]] ^
+				t[1][ptr[6]] ^
+				t[0][ptr[7]];
+		}
+		for (; size > 0; ++ptr, --size)
+		{
+			crc = t[0][(crc ^ *ptr) & 0xFFU] ^ (crc >> 8);
+		}
+
+		m_crc = crc;
+	}
+
+	template<typename _CharType>
+	void operator()(const _CharType* data, size_t len)
+	{
+		Update(data, len * sizeof(_CharType));
+	}
+
+	uint32_t Value() const
+	{
+		return m_crc ^ 0xFFFFFFFFU;
+	}
+
+private:
+
+	using Tables = uint32_t[8][256];
+
+	static const Tables& GetTables()
+	{
+		struct TablesHolder
+		{
+			TablesHolder()
+			{
+				// reflected 0x1EDC6F41
+				static constexpr uint32_t sk_poly = 0x82F63B78U;
+				for (uint32_t i = 0; i < 256; ++i)
+				{
+					uint32_t crc = i;
+					for (size_t j = 0; j < 8; ++j)
+					{
+						crc = (crc >> 1) ^ ((crc & 1U) ? sk_poly : 0U);
+					}
+					tables[0][i] = crc;
+				}
+				for (size_t k = 1; k < 8; ++k)
+				{
+					for (size_t i = 0; i < 256; ++i)
+					{
+						const uint32_t prev = tables[k - 1][i];
+						tables[k][i] = (prev >> 8) ^ tables[0][prev & 0xFFU];
+					}
+				}
+			}
+
+			Tables tables;
+		}; // struct TablesHolder
+
+		static const TablesHolder sk_holder;
+		return sk_holder.tables;
+	}
+
+	uint32_t m_crc;
+}; // class Crc32c
+
+namespace Internal
+{
+
+/**
+ * @brief Converts [begin, end) into `out`, in chunks aligned to sequences;
+ *        each chunk is converted into a small scratch buffer and passed to
+ *        `hasher(const OutCharType* data, size_t len)` while it's still in
+ *        the cache, so no separate pass over the output is needed, and
+ *        then appended to `out`.
+ *
+ * @exception UtfConversionException if the input is invalid; `out` is left
+ *            empty, while the hasher has been given the output of the
+ *            chunks before the invalid one, so its state is unspecified.
+ */
+template<typename _BatchImpl, typename _InCharType, typename _HasherType>
+inline void UtfConvertHashed(const _InCharType* begin, const _InCharType* end,
+	std::basic_string<typename _BatchImpl::OutCharType>& out,
+	_HasherType& hasher)
+{
+	using OutCharType = typename _BatchImpl::OutCharType;
+
+	// small enough for a chunk and its output to stay in L1
+	static constexpr size_t sk_chunkSize = 2048;
+
+	OutCharType chunkOut[sk_chunkSize * _BatchImpl::sk_maxOutPerIn];
+
+	out.clear();
+	try
+	{
+		while (begin != end)
+		{
+			const _InCharType* chunkEnd =
+				(static_cast<size_t>(end - begin) > sk_chunkSize) ?
+					_BatchImpl::SeqBegin(begin, begin + sk_chunkSize) :
+					end;
+
+			const OutCharType* chunkOutEnd =
+				_BatchImpl::Convert(begin, chunkEnd, chunkOut);
+			const size_t outSize =
+				static_cast<size_t>(chunkOutEnd - chunkOut);
+
+			hasher(static_cast<const OutCharType*>(chunkOut), outSize);
+			out.append(chunkOut, outSize);
+			begin = chunkEnd;
+		}
+	}
+	catch (...)
+	{
+		out.clear();
+		throw;
+	}
+}
+
+} // namespace Internal
+
+// ==========  UTF-8 --> UTF-16
+
+template<typename _HasherType>
+inline void Utf8ToUtf16Hashed(Internal::StrInputT<char> in,
+	std::u16string& out, _HasherType&& hasher)
+{
+	Internal::UtfConvertHashed<Internal::Utf8ToUtf16BatchImpl<char> >(
+		in.data(), in.data() + in.size(), out, hasher);
+}
+
+// ==========  UTF-8 --> UTF-32
+
+template<typename _HasherType>
+inline void Utf8ToUtf32Hashed(Internal::StrInputT<char> in,
+	std::u32string& out, _HasherType&& hasher)
+{
+	Internal::UtfConvertHashed<Internal::Utf8ToUtf32BatchImpl<char> >(
+		in.data(), in.data() + in.size(), out, hasher);
+}
+
+// ==========  UTF-16 --> UTF-8
+
+template<typename _HasherType>
+inline void Utf16ToUtf8Hashed(Internal::StrInputT<char16_t> in,
+	std::string& out, _HasherType&& hasher)
+{
+	Internal::UtfConvertHashed<Internal::Utf16ToUtf8BatchImpl<char16_t> >(
+		in.data(), in.data() + in.size(), out, hasher);
+}
+
+// ==========  UTF-16 --> UTF-32
+
+template<typename _HasherType>
+inline void Utf16ToUtf32Hashed(Internal::StrInputT<char16_t> in,
+	std::u32string& out, _HasherType&& hasher)
+{
+	Internal::UtfConvertHashed<Internal::Utf16ToUtf32BatchImpl<char16_t> >(
+		in.data(), in.data() + in.size(), out, hasher);
+}
+
+// ==========  UTF-32 --> UTF-8
+
+template<typename _HasherType>
+inline void Utf32ToUtf8Hashed(Internal::StrInputT<char32_t> in,
+	std::string& out, _HasherType&& hasher)
+{
+	Internal::UtfConvertHashed<Internal::Utf32ToUtf8BatchImpl<char32_t> >(
+		in.data(), in.data() + in.size(), out, hasher);
+}
+
+// ==========  UTF-32 --> UTF-16
+
+template<typename _HasherType>
+inline void Utf32ToUtf16Hashed(Internal::StrInputT<char32_t> in,
+	std::u16string& out, _HasherType&& hasher)
+{
+	Internal::UtfConvertHashed<Internal::Utf32ToUtf16BatchImpl<char32_t> >(
+		in.data(), in.data() + in.size(), out, hasher);
+}
+
+} // namespace SimpleUtf
@@ -33,9 +33,22 @@
 #include <iterator>
 #include <limits>
 #include <string>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#	define SIMPLEUTF_HAS_STRING_VIEW
+#endif
 
 #include "Exceptions.hpp"
+#include "UtfStats.hpp"
+
+// With `SIMPLEUTF_CHECK_ASSUME_VALID` defined, the unchecked conversions
+// (e.g., `Utf8ToUtf16Unchecked`) still validate their input, and throw
+// `UtfConversionException` if it's invalid; it's opt-in, and, like
+// `SIMPLEUTF_ENABLE_STATS`, it must be the same for the whole program.
 
 #ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
 namespace SimpleUtf
@@ -269,6 +282,49 @@ inline bool IsValidUtfCodePt(char32_t val)
 	return Internal::IsValidCodePt(val);
 }
 
+// ==================================================
+// Policies on surrogate code points
+// ==================================================
+
+/**
+ * @brief The default policy, as required by the UTF standards - surrogate
+ *        code points (U+D800 ~ U+DFFF) are invalid, and so are unpaired
+ *        surrogates in UTF-16.
+ *
+ */
+struct UtfStrictPolicy
+{
+	static bool AllowLoneSurrogates()
+	{
+		return false;
+	}
+
+	static bool IsValidCodePt(char32_t val)
+	{
+		return Internal::IsValidCodePt(val);
+	}
+}; // struct UtfStrictPolicy
+
+/**
+ * @brief The WTF-8 / WTF-16 policy - unpaired surrogates are preserved as
+ *        surrogate code points (encoded in 3 bytes in WTF-8, and as a single
+ *        code unit in WTF-16), while valid surrogate pairs in UTF-16 are
+ *        still joined into one code point.
+ *
+ */
+struct WtfPolicy
+{
+	static bool AllowLoneSurrogates()
+	{
+		return true;
+	}
+
+	static bool IsValidCodePt(char32_t val)
+	{
+		return val <= 0x10FFFFU;
+	}
+}; // struct WtfPolicy
+
 // ==================================================
 // Helper functions for checking byte size
 // ==================================================
@@ -344,13 +400,15 @@ inline _ValType EnsureByteSize(const _ValType& val)
 	using UType = decltype(uval);
 	static_assert(!IsSigned<UType>::value, "Programming Error");
 
-	return ((uval &
-		static_cast<UType>(
-			~TrailingOnes<UType, _Bytes>())) == 0) ?
-		uval :
+	if ((uval & static_cast<UType>(~TrailingOnes<UType, _Bytes>())) != 0)
+	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
 		throw UtfConversionException("Invalid Encoding" " - "
 			"The given value is out of range of "
 				+ std::to_string(_Bytes) + " bytes");
+	}
+
+	return uval;
 }
 
 /**
@@ -360,6 +418,70 @@ inline _ValType EnsureByteSize(const _ValType& val)
 template<typename _ItType>
 using ItValType = typename std::iterator_traits<_ItType>::value_type;
 
+/**
+ * @brief Is the given iterator type a random access iterator?
+ *
+ */
+template<typename _ItType>
+using IsRandomAccessIt = std::is_base_of<
+	std::random_access_iterator_tag,
+	typename std::iterator_traits<_ItType>::iterator_category>;
+
+/**
+ * @brief Bound checks used by the decoders while reading a multi-unit
+ *        sequence.
+ *        For random access iterators (e.g., pointers into contiguous memory),
+ *        the remaining length is checked once per code point by
+ *        `HasAtLeast`, and `IsEnd` is a no-op;
+ *        for other iterators, `HasAtLeast` is a no-op and `IsEnd` has to be
+ *        checked before every increment.
+ *
+ */
+template<typename _ItType, bool _IsRandomAccess = IsRandomAccessIt<_ItType>::value>
+struct ItBoundCheck;
+
+template<typename _ItType>
+struct ItBoundCheck<_ItType, true>
+{
+	static bool HasAtLeast(const _ItType& begin, const _ItType& end, size_t n)
+	{
+		return static_cast<size_t>(end - begin) >= n;
+	}
+
+	static constexpr bool IsEnd(const _ItType&, const _ItType&)
+	{
+		return false;
+	}
+}; // struct ItBoundCheck
+
+template<typename _ItType>
+struct ItBoundCheck<_ItType, false>
+{
+	static constexpr bool HasAtLeast(const _ItType&, const _ItType&, size_t)
+	{
+		return true;
+	}
+
+	static bool IsEnd(const _ItType& it, const _ItType& end)
+	{
+		return it == end;
+	}
+}; // struct ItBoundCheck
+
+/**
+ * @brief The type used by the string conversion functions to take string
+ *        inputs; it's std::basic_string_view when available, so inputs that
+ *        are not std::basic_string don't have to be copied first.
+ *
+ */
+#ifdef SIMPLEUTF_HAS_STRING_VIEW
+template<typename _CharType>
+using StrInputT = std::basic_string_view<_CharType>;
+#else
+template<typename _CharType>
+using StrInputT = const std::basic_string<_CharType>&;
+#endif
+
 /**
  * @brief Can type _ValType hold value that has size of _ByteSize?
  *
@@ -552,4 +674,49 @@ static_assert(!AsciiTraits<uint8_t>::IsPrintable(static_cast<uint8_t>('\x7f')),
 static_assert(!AsciiTraits<uint8_t>::IsPrintable(static_cast<uint8_t>('\x80')),
 	"Programming Error");
 
+// ==================================================
+// Helper functions for scanning ASCII runs
+// ==================================================
+
+namespace Internal
+{
+
+/**
+ * @brief Counts the number of ASCII code units at the beginning of
+ *        [begin, end), for 1-byte code units.
+ *        The input is tested 8 bytes at a time while it's all ASCII
+ *        (SWAR - SIMD within a register), and then byte by byte.
+ *
+ */
+template<typename _ValType,
+	EnableIfT<
+		IsIntegral<_ValType>::value &&
+		(sizeof(_ValType) == 1)
+		, int> = 0>
+inline size_t CountAsciiPrefix(const _ValType* begin, const _ValType* end)
+{
+	static constexpr uint64_t sk_nonAsciiMask = 0x8080808080808080ULL;
+
+	const _ValType* ptr = begin;
+	for (; (end - ptr) >= 8; ptr += 8)
+	{
+		uint64_t word = 0;
+		std::memcpy(&word, ptr, sizeof(word));
+		if ((word & sk_nonAsciiMask) != 0)
+		{
+			break;
+		}
+	}
+	while ((ptr != end) && AsciiTraits<_ValType>::IsAsciiFast(*ptr))
+	{
+		++ptr;
+	}
+
+	SIMPLEUTF_STATS_ADD(AsciiFastPathBytes, ptr - begin);
+
+	return static_cast<size_t>(ptr - begin);
+}
+
+} // namespace Internal
+
 } // namespace SimpleUtf
@@ -0,0 +1,153 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include "Utf.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+// Comparing strings in different encodings by their code points, without
+// converting either of them; both sides are decoded in lockstep, and the
+// comparison stops at the first difference.
+// Strings are ordered lexicographically by code point, which, unlike the
+// order of UTF-16 code units, is the same as the order of UTF-8 bytes.
+
+namespace Internal
+{
+
+/**
+ * @brief Compares the ASCII prefixes of a UTF-8 and a UTF-16 string, 8
+ *        characters at a time, and moves both past the characters that are
+ *        equal.
+ *
+ * @return the difference of the first different characters, or 0 if a
+ *         non-ASCII character or the end is reached first
+ */
+inline int CompareAsciiPrefix(const char*& utf8, const char* utf8End,
+	const char16_t*& utf16, const char16_t* utf16End)
+{
+	static constexpr uint64_t sk_nonAscii8 = 0x8080808080808080ULL;
+	static constexpr uint64_t sk_nonAscii16 = 0xFF80FF80FF80FF80ULL;
+
+	while (((utf8End - utf8) >= 8) && ((utf16End - utf16) >= 8))
+	{
+		uint64_t word8 = 0;
+		uint64_t word16[2] = { 0, 0 };
+		std::memcpy(&word8, utf8, sizeof(word8));
+		std::memcpy(word16, utf16, sizeof(word16));
+		if (((word8 & sk_nonAscii8) != 0) ||
+			(((word16[0] | word16[1]) & sk_nonAscii16) != 0))
+		{
+			break;
+		}
+
+		for (size_t i = 0; i < 8; ++i)
+		{
+			if (static_cast<char16_t>(utf8[i]) != utf16[i])
+			{
+				const int diff = static_cast<int>(utf8[i]) -
+					static_cast<int>(utf16[i]);
+				utf8 += i;
+				utf16 += i;
+				return diff;
+			}
+		}
+
+		utf8 += 8;
+		utf16 += 8;
+	}
+
+	return 0;
+}
+
+} // namespace Internal
+
+/**
+ * @brief Compares two strings, decoded by `funcA` and `funcB` respectively
+ *        (e.g., `Utf8ToCodePtOnce<const char*>`), by their code points.
+ *
+ * @return a negative value, zero, or a positive value, if the first string
+ *         is less than, equal to, or greater than the second string
+ */
+template<typename InBoundFuncA, typename InputItA,
+	typename InBoundFuncB, typename InputItB>
+inline int CompareCodePoints(
+	InBoundFuncA funcA, InputItA beginA, InputItA endA,
+	InBoundFuncB funcB, InputItB beginB, InputItB endB)
+{
+	while ((beginA != endA) && (beginB != endB))
+	{
+		auto resA = funcA(beginA, endA);
+		auto resB = funcB(beginB, endB);
+		if (resA.first != resB.first)
+		{
+			return resA.first < resB.first ? -1 : 1;
+		}
+		beginA = resA.second;
+		beginB = resB.second;
+	}
+
+	return (beginA != endA) ? 1 : ((beginB != endB) ? -1 : 0);
+}
+
+// ==========  UTF-8 <--> UTF-16
+
+inline int CompareCodePoints(Internal::StrInputT<char> utf8,
+	Internal::StrInputT<char16_t> utf16)
+{
+	const char* begin8 = utf8.data();
+	const char* end8 = begin8 + utf8.size();
+	const char16_t* begin16 = utf16.data();
+	const char16_t* end16 = begin16 + utf16.size();
+
+	const int asciiDiff =
+		Internal::CompareAsciiPrefix(begin8, end8, begin16, end16);
+	if (asciiDiff != 0)
+	{
+		return asciiDiff < 0 ? -1 : 1;
+	}
+
+	return CompareCodePoints(
+		Utf8ToCodePtOnce<const char*>, begin8, end8,
+		Utf16ToCodePtOnce<const char16_t*>, begin16, end16);
+}
+
+inline int CompareCodePoints(Internal::StrInputT<char16_t> utf16,
+	Internal::StrInputT<char> utf8)
+{
+	return -CompareCodePoints(utf8, utf16);
+}
+
+/**
+ * @brief Are the two strings the same sequence of code points?
+ *        Each code point takes at least as many UTF-8 bytes as UTF-16 code
+ *        units, and at most 3 times as many, so strings whose lengths don't
+ *        fit are rejected without being decoded (and validated).
+ *
+ */
+inline bool EqualCodePoints(Internal::StrInputT<char> utf8,
+	Internal::StrInputT<char16_t> utf16)
+{
+	if ((utf8.size() < utf16.size()) || (utf8.size() > (3 * utf16.size())))
+	{
+		return false;
+	}
+
+	return CompareCodePoints(utf8, utf16) == 0;
+}
+
+inline bool EqualCodePoints(Internal::StrInputT<char16_t> utf16,
+	Internal::StrInputT<char> utf8)
+{
+	return EqualCodePoints(utf8, utf16);
+}
+
+} // namespace SimpleUtf
@@ -0,0 +1,240 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include "UtfCompare.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+// Hashing strings by their code points, so the UTF-8, UTF-16, and UTF-32
+// encodings of the same string have the same hash value (within the same
+// process; the value is not meant to be stored or sent elsewhere).
+//
+// The code points are fed to the hash in the same chunks in all encodings:
+// if the next 8 code points are all ASCII, they are hashed together as one
+// 64-bit block; otherwise, the next code point is hashed on its own.
+
+namespace Internal
+{
+
+class CodePtHashState
+{
+public:
+
+	CodePtHashState() :
+		m_state(0x243F6A8885A308D3ULL)
+	{}
+
+	void AddCodePt(char32_t val)
+	{
+		Mix(static_cast<uint64_t>(val));
+	}
+
+	/**
+	 * @brief Adds 8 ASCII characters, in the memory layout of 8 bytes
+	 *
+	 */
+	void AddAsciiBlock(const char* block)
+	{
+		uint64_t word = 0;
+		std::memcpy(&word, block, sizeof(word));
+		Mix(word);
+	}
+
+	size_t Final() const
+	{
+		// the finalizer of MurmurHash3
+		uint64_t res = m_state;
+		res ^= res >> 33;
+		res *= 0xFF51AFD7ED558CCDULL;
+		res ^= res >> 33;
+		res *= 0xC4CEB9FE1A85EC53ULL;
+		res ^= res >> 33;
+		return static_cast<size_t>(res);
+	}
+
+private:
+
+	void Mix(uint64_t val)
+	{
+		m_state = (m_state ^ val) * 0x9E3779B97F4A7C15ULL;
+		m_state ^= m_state >> 29;
+	}
+
+	uint64_t m_state;
+}; // class CodePtHashState
+
+/**
+ * @brief Narrows the next 8 code units into `block`, if they are all ASCII
+ *
+ */
+template<typename _ValType>
+inline bool ReadAsciiBlock(const _ValType* ptr, char (&block)[8])
+{
+	uint32_t bits = 0;
+	for (size_t i = 0; i < 8; ++i)
+	{
+		bits |= static_cast<uint32_t>(BitCast2Unsigned(ptr[i]));
+		block[i] = static_cast<char>(ptr[i]);
+	}
+	return bits < 0x80U;
+}
+
+template<typename _ValType, typename InBoundFunc>
+inline size_t HashCodePointsImpl(
+	const _ValType* begin, const _ValType* end, InBoundFunc func)
+{
+	CodePtHashState state;
+	char block[8];
+
+	while (begin != end)
+	{
+		if (((end - begin) >= 8) && ReadAsciiBlock(begin, block))
+		{
+			SIMPLEUTF_STATS_ADD(AsciiFastPathBytes, 8 * sizeof(_ValType));
+			state.AddAsciiBlock(block);
+			begin += 8;
+			continue;
+		}
+
+		auto res = func(begin, end);
+		state.AddCodePt(res.first);
+		begin = res.second;
+	}
+
+	return state.Final();
+}
+
+} // namespace Internal
+
+inline size_t HashCodePoints(Internal::StrInputT<char> utf8)
+{
+	return Internal::HashCodePointsImpl(utf8.data(), utf8.data() + utf8.size(),
+		Utf8ToCodePtOnce<const char*>);
+}
+
+inline size_t HashCodePoints(Internal::StrInputT<char16_t> utf16)
+{
+	return Internal::HashCodePointsImpl(utf16.data(),
+		utf16.data() + utf16.size(), Utf16ToCodePtOnce<const char16_t*>);
+}
+
+inline size_t HashCodePoints(Internal::StrInputT<char32_t> utf32)
+{
+	return Internal::HashCodePointsImpl(utf32.data(),
+		utf32.data() + utf32.size(), Utf32ToCodePtOnce<const char32_t*>);
+}
+
+/**
+ * @brief A hash functor for std::string, std::u16string, and std::u32string
+ *        keys, which hashes them by their code points; together with
+ *        `CodePtEqual`, it allows heterogeneous lookups (since C++20),
+ *        e.g., finding a std::u16string_view in an
+ *        `std::unordered_map<std::string, T, CodePtHash, CodePtEqual>`.
+ *
+ */
+struct CodePtHash
+{
+	using is_transparent = void;
+
+	size_t operator()(Internal::StrInputT<char> str) const
+	{
+		return HashCodePoints(str);
+	}
+
+	size_t operator()(Internal::StrInputT<char16_t> str) const
+	{
+		return HashCodePoints(str);
+	}
+
+	size_t operator()(Internal::StrInputT<char32_t> str) const
+	{
+		return HashCodePoints(str);
+	}
+}; // struct CodePtHash
+
+/**
+ * @brief An equality functor that compares strings in any of UTF-8,
+ *        UTF-16, and UTF-32 by their code points
+ *
+ */
+struct CodePtEqual
+{
+	using is_transparent = void;
+
+	// ==========  the same encoding
+
+	bool operator()(Internal::StrInputT<char> a,
+		Internal::StrInputT<char> b) const
+	{
+		return a == b;
+	}
+
+	bool operator()(Internal::StrInputT<char16_t> a,
+		Internal::StrInputT<char16_t> b) const
+	{
+		return a == b;
+	}
+
+	bool operator()(Internal::StrInputT<char32_t> a,
+		Internal::StrInputT<char32_t> b) const
+	{
+		return a == b;
+	}
+
+	// ==========  UTF-8 <--> UTF-16
+
+	bool operator()(Internal::StrInputT<char> a,
+		Internal::StrInputT<char16_t> b) const
+	{
+		return EqualCodePoints(a, b);
+	}
+
+	bool operator()(Internal::StrInputT<char16_t> a,
+		Internal::StrInputT<char> b) const
+	{
+		return EqualCodePoints(a, b);
+	}
+
+	// ==========  UTF-8 / UTF-16 <--> UTF-32
+
+	bool operator()(Internal::StrInputT<char> a,
+		Internal::StrInputT<char32_t> b) const
+	{
+		return CompareCodePoints(
+			Utf8ToCodePtOnce<const char*>, a.data(), a.data() + a.size(),
+			Utf32ToCodePtOnce<const char32_t*>, b.data(), b.data() + b.size()
+		) == 0;
+	}
+
+	bool operator()(Internal::StrInputT<char32_t> a,
+		Internal::StrInputT<char> b) const
+	{
+		return (*this)(b, a);
+	}
+
+	bool operator()(Internal::StrInputT<char16_t> a,
+		Internal::StrInputT<char32_t> b) const
+	{
+		return CompareCodePoints(
+			Utf16ToCodePtOnce<const char16_t*>, a.data(), a.data() + a.size(),
+			Utf32ToCodePtOnce<const char32_t*>, b.data(), b.data() + b.size()
+		) == 0;
+	}
+
+	bool operator()(Internal::StrInputT<char32_t> a,
+		Internal::StrInputT<char16_t> b) const
+	{
+		return (*this)(b, a);
+	}
+}; // struct CodePtEqual
+
+} // namespace SimpleUtf
@@ -0,0 +1,211 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include "Utf.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+namespace Internal
+{
+
+template<typename _Policy>
+struct Utf8CodePtTraits
+{
+	template<typename _ItType>
+	static std::pair<char32_t, _ItType> Next(_ItType begin, _ItType end)
+	{
+		return Utf8ToCodePtOnce<_ItType, _Policy>(begin, end);
+	}
+
+	template<typename _ItType>
+	static std::pair<char32_t, _ItType> Prev(_ItType begin, _ItType pos)
+	{
+		return Utf8PrevCodePt<_ItType, _Policy>(begin, pos);
+	}
+}; // struct Utf8CodePtTraits
+
+template<typename _Policy>
+struct Utf16CodePtTraits
+{
+	template<typename _ItType>
+	static std::pair<char32_t, _ItType> Next(_ItType begin, _ItType end)
+	{
+		return Utf16ToCodePtOnce<_ItType, _Policy>(begin, end);
+	}
+
+	template<typename _ItType>
+	static std::pair<char32_t, _ItType> Prev(_ItType begin, _ItType pos)
+	{
+		return Utf16PrevCodePt<_ItType, _Policy>(begin, pos);
+	}
+}; // struct Utf16CodePtTraits
+
+} // namespace Internal
+
+/**
+ * @brief A bidirectional iterator over the code points of a UTF encoded
+ *        string, in [begin, end); each step decodes (and validates) one
+ *        sequence, forward with `Next`, or backward with `Prev`, so it can
+ *        also be used with `std::reverse_iterator`.
+ *        The underlying iterator must be bidirectional.
+ *
+ */
+template<typename _ItType, typename _Traits>
+class CodePtIterator
+{
+public:
+
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = char32_t;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const char32_t*;
+	using reference = char32_t;
+
+public:
+
+	CodePtIterator() :
+		m_begin(),
+		m_pos(),
+		m_end()
+	{}
+
+	CodePtIterator(_ItType begin, _ItType pos, _ItType end) :
+		m_begin(begin),
+		m_pos(pos),
+		m_end(end)
+	{}
+
+	char32_t operator*() const
+	{
+		return _Traits::Next(m_pos, m_end).first;
+	}
+
+	CodePtIterator& operator++()
+	{
+		m_pos = _Traits::Next(m_pos, m_end).second;
+		return *this;
+	}
+
+	CodePtIterator operator++(int)
+	{
+		CodePtIterator tmp = *this;
+		++(*this);
+		return tmp;
+	}
+
+	CodePtIterator& operator--()
+	{
+		m_pos = _Traits::Prev(m_begin, m_pos).second;
+		return *this;
+	}
+
+	CodePtIterator operator--(int)
+	{
+		CodePtIterator tmp = *this;
+		--(*this);
+		return tmp;
+	}
+
+	bool operator==(const CodePtIterator& other) const
+	{
+		return m_pos == other.m_pos;
+	}
+
+	bool operator!=(const CodePtIterator& other) const
+	{
+		return m_pos != other.m_pos;
+	}
+
+	/**
+	 * @brief The position in the underlying string, i.e., the beginning of
+	 *        the current sequence
+	 *
+	 */
+	const _ItType& Base() const
+	{
+		return m_pos;
+	}
+
+private:
+
+	_ItType m_begin;
+	_ItType m_pos;
+	_ItType m_end;
+}; // class CodePtIterator
+
+template<typename _ItType, typename _Policy = UtfStrictPolicy>
+using Utf8CodePtIterator =
+	CodePtIterator<_ItType, Internal::Utf8CodePtTraits<_Policy> >;
+
+template<typename _ItType, typename _Policy = UtfStrictPolicy>
+using Utf16CodePtIterator =
+	CodePtIterator<_ItType, Internal::Utf16CodePtTraits<_Policy> >;
+
+/**
+ * @brief A pair of code point iterators, usable in range-based for loops
+ *
+ */
+template<typename _CodePtItType>
+class CodePtRange
+{
+public:
+
+	CodePtRange(_CodePtItType begin, _CodePtItType end) :
+		m_begin(begin),
+		m_end(end)
+	{}
+
+	_CodePtItType begin() const
+	{
+		return m_begin;
+	}
+
+	_CodePtItType end() const
+	{
+		return m_end;
+	}
+
+	std::reverse_iterator<_CodePtItType> rbegin() const
+	{
+		return std::reverse_iterator<_CodePtItType>(m_end);
+	}
+
+	std::reverse_iterator<_CodePtItType> rend() const
+	{
+		return std::reverse_iterator<_CodePtItType>(m_begin);
+	}
+
+private:
+
+	_CodePtItType m_begin;
+	_CodePtItType m_end;
+}; // class CodePtRange
+
+template<typename _ItType>
+inline CodePtRange<Utf8CodePtIterator<_ItType> > Utf8CodePts(
+	_ItType begin, _ItType end)
+{
+	return CodePtRange<Utf8CodePtIterator<_ItType> >(
+		Utf8CodePtIterator<_ItType>(begin, begin, end),
+		Utf8CodePtIterator<_ItType>(begin, end, end));
+}
+
+template<typename _ItType>
+inline CodePtRange<Utf16CodePtIterator<_ItType> > Utf16CodePts(
+	_ItType begin, _ItType end)
+{
+	return CodePtRange<Utf16CodePtIterator<_ItType> >(
+		Utf16CodePtIterator<_ItType>(begin, begin, end),
+		Utf16CodePtIterator<_ItType>(begin, end, end));
+}
+
+} // namespace SimpleUtf
@@ -0,0 +1,420 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "Utf.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+/**
+ * @brief An index of the lines of a UTF-8 text, for converting between byte
+ *        offsets and (line, UTF-16 column) positions, as used by the
+ *        Language Server Protocol, without decoding the text again.
+ *
+ *        Lines are separated by LF, CRLF, or a lone CR, as in the Language
+ *        Server Protocol; the line break is not part of the line. For each
+ *        line, the index keeps where it begins and ends,
+ *        and where its non-ASCII characters are, together with how many
+ *        bytes more than UTF-16 code units the characters before them take.
+ *        So positions in ASCII lines are converted in constant time, and
+ *        positions in other lines in O(log n) time.
+ *
+ *        The text must already be valid UTF-8 (e.g., checked by
+ *        `ValidateUtf8`); it's not kept by the index.
+ *
+ */
+class LineIndex
+{
+public:
+
+	LineIndex() :
+		LineIndex(std::string())
+	{}
+
+	explicit LineIndex(Internal::StrInputT<char> utf8) :
+		m_lineBegins(),
+		m_lineEnds(),
+		m_lineSeqs(),
+		m_seqs()
+	{
+		Build(utf8);
+	}
+
+	/**
+	 * @brief Indexes the given text, replacing the current index; the text
+	 *        is scanned once, 8 bytes at a time (SWAR) over ASCII
+	 *        characters.
+	 *
+	 */
+	void Build(Internal::StrInputT<char> utf8)
+	{
+		m_lineBegins.clear();
+		m_lineEnds.clear();
+		m_lineSeqs.clear();
+		m_seqs.clear();
+
+		ScanLines(utf8.data(), utf8.size(), 0, utf8.size(),
+			m_lineBegins, m_lineEnds, m_lineSeqs, m_seqs);
+		m_lineSeqs.push_back(m_seqs.size());
+	}
+
+	/**
+	 * @brief Updates the index after an edit, which replaced the bytes
+	 *        [editBegin, oldEditEnd) of the indexed text with the bytes
+	 *        [editBegin, newEditEnd) of `utf8`.
+	 *        Only the lines touched by the edit, and the line before them
+	 *        (whose CR may be joined with an LF inserted right after it, or
+	 *        split from the LF following it), are scanned again; the
+	 *        offsets of the lines after them are shifted.
+	 *
+	 * @param utf8       The whole text after the edit
+	 * @param editBegin  The beginning of the edit
+	 * @param oldEditEnd The end of the replaced bytes, in the old text
+	 * @param newEditEnd The end of the inserted bytes, in the new text
+	 */
+	void Update(Internal::StrInputT<char> utf8,
+		size_t editBegin, size_t oldEditEnd, size_t newEditEnd)
+	{
+		const size_t firstLine =
+			std::max<size_t>(GetLineOf(editBegin), 1) - 1;
+
+		std::vector<size_t> lineBegins;
+		std::vector<size_t> lineEnds;
+		std::vector<size_t> lineSeqs;
+		std::vector<SeqInfo> seqs;
+		// the lines are scanned until the first line break after the edit;
+		// the lines from there on are the same as before, only shifted
+		const size_t nextBegin = ScanLines(utf8.data(), utf8.size(),
+			m_lineBegins[firstLine], newEditEnd,
+			lineBegins, lineEnds, lineSeqs, seqs);
+		const size_t offsetDiff = newEditEnd - oldEditEnd;
+		const size_t endLine = (nextBegin == sk_npos) ?
+			GetNumLines() :
+			GetLineOf(nextBegin - offsetDiff);
+
+		// 1. the non-ASCII characters
+		const size_t seqFirst = m_lineSeqs[firstLine];
+		const size_t seqLast = m_lineSeqs[endLine];
+		m_seqs.erase(m_seqs.begin() + seqFirst, m_seqs.begin() + seqLast);
+		m_seqs.insert(m_seqs.begin() + seqFirst, seqs.begin(), seqs.end());
+
+		// 2. the lines after the edit are shifted; the differences may be
+		//    negative, which is fine with the modular arithmetic of size_t
+		const size_t seqDiff = seqs.size() - (seqLast - seqFirst);
+		for (size_t i = endLine; i < m_lineBegins.size(); ++i)
+		{
+			m_lineBegins[i] += offsetDiff;
+			m_lineEnds[i] += offsetDiff;
+		}
+		for (size_t i = endLine; i < m_lineSeqs.size(); ++i)
+		{
+			m_lineSeqs[i] += seqDiff;
+		}
+		for (size_t& lineSeq : lineSeqs)
+		{
+			lineSeq += seqFirst;
+		}
+
+		// 3. the lines touched by the edit
+		Splice(m_lineBegins, firstLine, endLine, lineBegins);
+		Splice(m_lineEnds, firstLine, endLine, lineEnds);
+		Splice(m_lineSeqs, firstLine, endLine, lineSeqs);
+	}
+
+	size_t GetNumLines() const
+	{
+		return m_lineBegins.size();
+	}
+
+	/**
+	 * @brief The byte offset of the beginning of the given line
+	 *
+	 */
+	size_t GetLineBegin(size_t line) const
+	{
+		return m_lineBegins[line];
+	}
+
+	/**
+	 * @brief The byte offset of the end of the given line, excluding the
+	 *        line break
+	 *
+	 */
+	size_t GetLineEnd(size_t line) const
+	{
+		return m_lineEnds[line];
+	}
+
+	bool IsLineAscii(size_t line) const
+	{
+		return m_lineSeqs[line] == m_lineSeqs[line + 1];
+	}
+
+	/**
+	 * @brief The line containing the given byte offset; offsets past the end
+	 *        are in the last line.
+	 *
+	 */
+	size_t GetLineOf(size_t offset) const
+	{
+		return static_cast<size_t>(
+			std::upper_bound(m_lineBegins.begin(), m_lineBegins.end(), offset) -
+				m_lineBegins.begin()) - 1;
+	}
+
+	/**
+	 * @brief Converts a byte offset into a (line, UTF-16 column) position.
+	 *        Offsets in a line break are moved to the end of the line, and
+	 *        offsets in a multi-byte sequence to its beginning.
+	 *
+	 */
+	std::pair<size_t, size_t> OffsetToPosition(size_t offset) const
+	{
+		const size_t line = GetLineOf(offset);
+		size_t col = std::min(offset, m_lineEnds[line]) - m_lineBegins[line];
+
+		if (IsLineAscii(line))
+		{
+			return std::make_pair(line, col);
+		}
+
+		// the first character at or after `col`
+		SeqCIt it = std::partition_point(SeqsBegin(line), SeqsEnd(line),
+			[col](const SeqInfo& seq)
+			{
+				return seq.col < col;
+			}
+		);
+		if (it != SeqsBegin(line))
+		{
+			const SeqInfo& prev = *(it - 1);
+			if (col < prev.col + prev.numBytes)
+			{
+				col = prev.col;
+				--it;
+			}
+		}
+
+		return std::make_pair(line,
+			(it == SeqsBegin(line)) ? col : (col - ExtraAfter(*(it - 1))));
+	}
+
+	/**
+	 * @brief Converts a (line, UTF-16 column) position into a byte offset.
+	 *        Columns past the end of the line are moved to the end of the
+	 *        line, columns in a surrogate pair to its beginning, and lines
+	 *        past the end to the end of the text.
+	 *
+	 */
+	size_t PositionToOffset(size_t line, size_t col16) const
+	{
+		if (line >= GetNumLines())
+		{
+			return m_lineEnds.back();
+		}
+
+		const size_t lineBegin = m_lineBegins[line];
+		const size_t lineSize = m_lineEnds[line] - lineBegin;
+
+		if (IsLineAscii(line))
+		{
+			return lineBegin + std::min(col16, lineSize);
+		}
+
+		// the first character at or after `col16`
+		SeqCIt it = std::partition_point(SeqsBegin(line), SeqsEnd(line),
+			[col16](const SeqInfo& seq)
+			{
+				return (seq.col - seq.extraBefore) < col16;
+			}
+		);
+		if (it == SeqsBegin(line))
+		{
+			return lineBegin + std::min(col16, lineSize);
+		}
+
+		const SeqInfo& prev = *(it - 1);
+		const size_t prevCol16 = prev.col - prev.extraBefore;
+		const size_t prevUnits = prev.numBytes - SeqExtra(prev.numBytes);
+		const size_t col = (col16 < prevCol16 + prevUnits) ?
+			prev.col :
+			(col16 + ExtraAfter(prev));
+
+		return lineBegin + std::min(col, lineSize);
+	}
+
+private:
+
+	/**
+	 * @brief A non-ASCII character
+	 *
+	 */
+	struct SeqInfo
+	{
+		// the byte offset from the beginning of the line
+		size_t col;
+		// the number of bytes more than UTF-16 code units taken by the
+		// characters before it, in the same line
+		size_t extraBefore;
+		uint8_t numBytes;
+	}; // struct SeqInfo
+
+	using SeqCIt = std::vector<SeqInfo>::const_iterator;
+
+	static constexpr size_t sk_npos = static_cast<size_t>(-1);
+
+	/**
+	 * @brief The number of bytes more than UTF-16 code units taken by a
+	 *        character of `numBytes` bytes
+	 *
+	 */
+	static size_t SeqExtra(uint8_t numBytes)
+	{
+		return numBytes - ((numBytes == 4) ? 2 : 1);
+	}
+
+	static size_t ExtraAfter(const SeqInfo& seq)
+	{
+		return seq.extraBefore + SeqExtra(seq.numBytes);
+	}
+
+	/**
+	 * @brief Scans one line starting at `pos`, and adds its non-ASCII
+	 *        characters to `seqs`
+	 *
+	 * @return the offset of the CR or LF ending the line, or `size` if it's
+	 *         the last line
+	 */
+	static size_t ScanLine(const char* data, size_t size, size_t pos,
+		std::vector<SeqInfo>& seqs)
+	{
+		static constexpr uint64_t sk_ones = 0x0101010101010101ULL;
+		static constexpr uint64_t sk_highs = 0x8080808080808080ULL;
+		static constexpr uint64_t sk_lfs = sk_ones * 0x0AU;
+		static constexpr uint64_t sk_crs = sk_ones * 0x0DU;
+
+		const size_t lineBegin = pos;
+		size_t extra = 0;
+
+		while (pos != size)
+		{
+			size_t blockEnd = size;
+			if (size - pos >= 8)
+			{
+				uint64_t word = 0;
+				std::memcpy(&word, data + pos, sizeof(word));
+				// a lane is zero where the byte is LF (or CR)
+				const uint64_t lf = word ^ sk_lfs;
+				const uint64_t cr = word ^ sk_crs;
+				if (((word | ((lf - sk_ones) & ~lf) | ((cr - sk_ones) & ~cr)) &
+					sk_highs) == 0)
+				{
+					SIMPLEUTF_STATS_ADD(AsciiFastPathBytes, 8);
+					pos += 8;
+					continue;
+				}
+				blockEnd = pos + 8;
+			}
+
+			for (; pos != blockEnd; ++pos)
+			{
+				const uint8_t uval = Internal::BitCast2Unsigned(data[pos]);
+				if ((uval == 0x0AU) || (uval == 0x0DU))
+				{
+					return pos;
+				}
+				// a leading byte: 11xxxxxx
+				if ((uval & 0xC0U) == 0xC0U)
+				{
+					const uint8_t numBytes = (uval < 0xE0U) ? 2 :
+						((uval < 0xF0U) ? 3 : 4);
+					SeqInfo seq;
+					seq.col = pos - lineBegin;
+					seq.extraBefore = extra;
+					seq.numBytes = numBytes;
+					seqs.push_back(seq);
+					extra += SeqExtra(numBytes);
+				}
+			}
+		}
+
+		return size;
+	}
+
+	/**
+	 * @brief Scans the lines starting at `pos`, until the line ending with
+	 *        a line break beginning at or after `stopAt`, or the end of the
+	 *        text
+	 *
+	 * @return the beginning of the line following the last line scanned,
+	 *         or `sk_npos` if the end of the text is reached
+	 */
+	static size_t ScanLines(const char* data, size_t size, size_t pos,
+		size_t stopAt,
+		std::vector<size_t>& lineBegins,
+		std::vector<size_t>& lineEnds,
+		std::vector<size_t>& lineSeqs,
+		std::vector<SeqInfo>& seqs)
+	{
+		while (true)
+		{
+			lineBegins.push_back(pos);
+			lineSeqs.push_back(seqs.size());
+
+			const size_t lineEnd = ScanLine(data, size, pos, seqs);
+			lineEnds.push_back(lineEnd);
+			if (lineEnd == size)
+			{
+				return sk_npos;
+			}
+
+			// CRLF is a single line break
+			const size_t nextBegin = lineEnd +
+				(((data[lineEnd] == '\r') && (lineEnd + 1 != size) &&
+					(data[lineEnd + 1] == '\n')) ? 2 : 1);
+			if (lineEnd >= stopAt)
+			{
+				return nextBegin;
+			}
+			pos = nextBegin;
+		}
+	}
+
+	template<typename _ValType>
+	static void Splice(std::vector<_ValType>& dest, size_t begin, size_t end,
+		const std::vector<_ValType>& src)
+	{
+		dest.erase(dest.begin() + begin, dest.begin() + end);
+		dest.insert(dest.begin() + begin, src.begin(), src.end());
+	}
+
+	SeqCIt SeqsBegin(size_t line) const
+	{
+		return m_seqs.begin() + m_lineSeqs[line];
+	}
+
+	SeqCIt SeqsEnd(size_t line) const
+	{
+		return m_seqs.begin() + m_lineSeqs[line + 1];
+	}
+
+	std::vector<size_t> m_lineBegins;
+	std::vector<size_t> m_lineEnds;
+	// the index of the first non-ASCII character of each line in `m_seqs`,
+	// plus the number of all of them at the end
+	std::vector<size_t> m_lineSeqs;
+	std::vector<SeqInfo> m_seqs;
+}; // class LineIndex
+
+} // namespace SimpleUtf
@@ -0,0 +1,189 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include <cstring>
+
+#include "UtfCommon.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+namespace Internal
+{
+
+/**
+ * @brief Is the given code unit an ASCII character other than CR and LF?
+ *
+ */
+template<typename _ValType>
+inline bool IsNewlinePlain(const _ValType& val)
+{
+	return AsciiTraits<_ValType>::IsAsciiFast(val) &&
+		(val != 0x0D) && (val != 0x0A);
+}
+
+/**
+ * @brief Counts the number of ASCII code units other than CR and LF at the
+ *        beginning of [begin, end), for 1-byte and 2-byte code units.
+ *        The input is tested 8 bytes at a time (SWAR), and then unit by
+ *        unit.
+ *
+ */
+template<typename _ValType,
+	EnableIfT<
+		IsIntegral<_ValType>::value &&
+		((sizeof(_ValType) == 1) || (sizeof(_ValType) == 2))
+		, int> = 0>
+inline size_t CountNewlinePlainPrefix(const _ValType* begin, const _ValType* end)
+{
+	static constexpr size_t sk_lanes = sizeof(uint64_t) / sizeof(_ValType);
+	// 0x0101... for 1-byte lanes, 0x0001... for 2-byte lanes
+	static constexpr uint64_t sk_ones =
+		(~0ULL) / ((1ULL << (8 * sizeof(_ValType))) - 1);
+	static constexpr uint64_t sk_highs =
+		sk_ones << (8 * sizeof(_ValType) - 1);
+	static constexpr uint64_t sk_nonAsciiMask = ~(sk_ones * 0x7FU);
+	static constexpr uint64_t sk_crs = sk_ones * 0x0DU;
+	static constexpr uint64_t sk_lfs = sk_ones * 0x0AU;
+
+	const _ValType* ptr = begin;
+	for (; static_cast<size_t>(end - ptr) >= sk_lanes; ptr += sk_lanes)
+	{
+		uint64_t word = 0;
+		std::memcpy(&word, ptr, sizeof(word));
+		// a lane is zero where the code unit is CR (or LF)
+		const uint64_t cr = word ^ sk_crs;
+		const uint64_t lf = word ^ sk_lfs;
+		if (((word & sk_nonAsciiMask) != 0) ||
+			(((((cr - sk_ones) & ~cr) | ((lf - sk_ones) & ~lf)) & sk_highs) != 0))
+		{
+			break;
+		}
+	}
+	while ((ptr != end) && IsNewlinePlain(*ptr))
+	{
+		++ptr;
+	}
+
+	SIMPLEUTF_STATS_ADD(AsciiFastPathBytes, (ptr - begin) * sizeof(_ValType));
+
+	return static_cast<size_t>(ptr - begin);
+}
+
+/**
+ * @brief Skips the ASCII code units other than CR and LF at the beginning
+ *        of [begin, end)
+ *
+ */
+template<typename _ItType>
+inline _ItType SkipNewlinePlain(_ItType begin, _ItType end)
+{
+	while ((begin != end) && IsNewlinePlain(*begin))
+	{
+		++begin;
+	}
+	return begin;
+}
+
+template<typename _ValType,
+	EnableIfT<
+		IsIntegral<_ValType>::value &&
+		((sizeof(_ValType) == 1) || (sizeof(_ValType) == 2))
+		, int> = 0>
+inline const _ValType* SkipNewlinePlain(const _ValType* begin, const _ValType* end)
+{
+	return begin + CountNewlinePlainPrefix(begin, end);
+}
+
+} // namespace Internal
+
+// ==================================================
+// Newline normalization
+// ==================================================
+
+/**
+ * @brief Normalizes line breaks to LF while converting - CRLF and a lone CR
+ *        are both replaced by LF - and counts the line breaks.
+ *        It's passed to the conversion functions, and carries its state
+ *        from one call to the next, so a CRLF split between two input
+ *        blocks is still recognized.
+ *
+ */
+class NewlineNormalizer
+{
+public:
+
+	NewlineNormalizer() :
+		m_afterCr(false),
+		m_numNewlines(0)
+	{}
+
+	/**
+	 * @brief Normalizes the next code point in place
+	 *
+	 * @return false if the code point is the LF of a CRLF, and should be
+	 *         dropped
+	 */
+	bool Filter(char32_t& val)
+	{
+		if (val == 0x0AU)
+		{
+			if (m_afterCr)
+			{
+				m_afterCr = false;
+				return false;
+			}
+			++m_numNewlines;
+			return true;
+		}
+
+		m_afterCr = (val == 0x0DU);
+		if (m_afterCr)
+		{
+			val = 0x0AU;
+			++m_numNewlines;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Notifies that code points other than CR and LF are passed
+	 *        through without calling `Filter`
+	 *
+	 */
+	void PassPlain()
+	{
+		m_afterCr = false;
+	}
+
+	/**
+	 * @brief The number of line breaks seen so far, i.e., the number of LFs
+	 *        in the normalized output
+	 *
+	 */
+	size_t GetNumNewlines() const
+	{
+		return m_numNewlines;
+	}
+
+	void Reset()
+	{
+		m_afterCr = false;
+		m_numNewlines = 0;
+	}
+
+private:
+
+	bool m_afterCr;
+	size_t m_numNewlines;
+}; // class NewlineNormalizer
+
+} // namespace SimpleUtf
@@ -0,0 +1,549 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "UtfBatch.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+namespace Internal
+{
+
+/**
+ * @brief A task deque owned by one worker; the owner takes tasks from the
+ *        back, while other workers steal from the front.
+ *
+ */
+class WorkStealingDeque
+{
+public:
+
+	void PushBack(size_t task)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push_back(task);
+	}
+
+	bool PopBack(size_t& task)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_tasks.empty())
+		{
+			return false;
+		}
+		task = m_tasks.back();
+		m_tasks.pop_back();
+		return true;
+	}
+
+	bool StealFront(size_t& task)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_tasks.empty())
+		{
+			return false;
+		}
+		task = m_tasks.front();
+		m_tasks.pop_front();
+		return true;
+	}
+
+private:
+
+	std::mutex m_mutex;
+	std::deque<size_t> m_tasks;
+}; // class WorkStealingDeque
+
+} // namespace Internal
+
+/**
+ * @brief A pool of worker threads that runs a batch of indexed tasks at a
+ *        time. The tasks are initially split into contiguous ranges, one per
+ *        worker deque, and a worker that runs out of tasks steals from the
+ *        others, so uneven tasks are balanced out.
+ *        The thread calling `Run` acts as one of the workers.
+ *
+ */
+class WorkStealingPool
+{
+public:
+
+	/**
+	 * @brief Construct a new Work Stealing Pool object
+	 *
+	 * @param numThreads The total number of workers, including the thread
+	 *                   calling `Run`; 0 means the number of hardware
+	 *                   threads.
+	 */
+	explicit WorkStealingPool(size_t numThreads = 0) :
+		m_numWorkers(numThreads != 0 ? numThreads : DefaultNumThreads()),
+		m_queues(),
+		m_threads(),
+		m_mutex(),
+		m_cv(),
+		m_doneCv(),
+		m_job(),
+		m_generation(0),
+		m_pending(0),
+		m_stop(false),
+		m_except()
+	{
+		for (size_t i = 0; i < m_numWorkers; ++i)
+		{
+			m_queues.emplace_back(new Internal::WorkStealingDeque());
+		}
+		for (size_t i = 1; i < m_numWorkers; ++i)
+		{
+			m_threads.emplace_back(&WorkStealingPool::WorkerMain, this, i);
+		}
+	}
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	/**
+	 * @brief Destroy the Work Stealing Pool object, and join all threads
+	 *
+	 */
+	~WorkStealingPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_cv.notify_all();
+		for (auto& thr : m_threads)
+		{
+			thr.join();
+		}
+	}
+
+	size_t GetNumThreads() const
+	{
+		return m_numWorkers;
+	}
+
+	/**
+	 * @brief Runs `func(i)` for every `i` in [0, numTasks), and blocks until
+	 *        all of them are finished. If any task throws, the first
+	 *        exception is re-thrown after the rest are finished.
+	 *        Only one `Run` may be in progress at a time.
+	 *
+	 */
+	void Run(size_t numTasks, std::function<void(size_t)> func)
+	{
+		if (numTasks == 0)
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_job = std::move(func);
+			m_except = nullptr;
+			m_pending.store(numTasks);
+
+			const size_t perWorker = numTasks / m_numWorkers;
+			const size_t extra = numTasks % m_numWorkers;
+			size_t task = 0;
+			for (size_t i = 0; i < m_numWorkers; ++i)
+			{
+				const size_t num = perWorker + (i < extra ? 1 : 0);
+				for (size_t j = 0; j < num; ++j, ++task)
+				{
+					m_queues[i]->PushBack(task);
+				}
+			}
+
+			++m_generation;
+		}
+		m_cv.notify_all();
+
+		RunTasks(0);
+
+		std::exception_ptr except;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_doneCv.wait(lock, [this](){ return m_pending.load() == 0; });
+			m_job = nullptr;
+			except = m_except;
+			m_except = nullptr;
+		}
+
+		if (except)
+		{
+			std::rethrow_exception(except);
+		}
+	}
+
+private:
+
+	static size_t DefaultNumThreads()
+	{
+		const size_t hw = std::thread::hardware_concurrency();
+		return hw != 0 ? hw : 1;
+	}
+
+	bool TakeTask(size_t workerIdx, size_t& task)
+	{
+		if (m_queues[workerIdx]->PopBack(task))
+		{
+			return true;
+		}
+		for (size_t i = 1; i < m_numWorkers; ++i)
+		{
+			const size_t victim = (workerIdx + i) % m_numWorkers;
+			if (m_queues[victim]->StealFront(task))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void RunTasks(size_t workerIdx)
+	{
+		size_t task = 0;
+		while (TakeTask(workerIdx, task))
+		{
+			try
+			{
+				m_job(task);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (!m_except)
+				{
+					m_except = std::current_exception();
+				}
+			}
+
+			if (m_pending.fetch_sub(1) == 1)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_doneCv.notify_all();
+			}
+		}
+	}
+
+	void WorkerMain(size_t workerIdx)
+	{
+		uint64_t seenGeneration = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_cv.wait(lock, [this, seenGeneration](){
+					return m_stop || (m_generation != seenGeneration);
+				});
+				if (m_stop)
+				{
+					return;
+				}
+				seenGeneration = m_generation;
+			}
+
+			RunTasks(workerIdx);
+		}
+	}
+
+	size_t m_numWorkers;
+	std::vector<std::unique_ptr<Internal::WorkStealingDeque> > m_queues;
+	std::vector<std::thread> m_threads;
+
+	std::mutex m_mutex;
+	std::condition_variable m_cv;
+	std::condition_variable m_doneCv;
+
+	std::function<void(size_t)> m_job;
+	uint64_t m_generation;
+	std::atomic<size_t> m_pending;
+	bool m_stop;
+	std::exception_ptr m_except;
+}; // class WorkStealingPool
+
+namespace Internal
+{
+
+/**
+ * @brief A unit of work of a parallel batch conversion; it's either a group
+ *        of whole (small) strings, or a chunk of a single (large) string.
+ *
+ */
+struct BatchWorkItem
+{
+	size_t strIdx;
+	size_t numStrs;
+	// the range of the input, for a chunk
+	size_t inBegin;
+	size_t inEnd;
+	bool isChunk;
+	// the output size, and its position in the output buffer
+	size_t outSize;
+	size_t outPos;
+}; // struct BatchWorkItem
+
+template<typename _BatchImpl, typename InputIt>
+inline void UtfConvertBatchParallel(
+	WorkStealingPool& pool, size_t chunkSize,
+	InputIt begin, InputIt end,
+	UtfBatch<typename _BatchImpl::OutCharType>& out)
+{
+	using OutCharType = typename _BatchImpl::OutCharType;
+
+	const size_t numStrs = static_cast<size_t>(end - begin);
+	chunkSize = chunkSize != 0 ? chunkSize : 1;
+
+	// Split the work: large strings are cut into chunks at sequence
+	// boundaries, and small strings are grouped together
+	std::vector<BatchWorkItem> items;
+	size_t groupBegin = 0;
+	size_t groupCost = 0;
+	auto flushGroup = [&](size_t groupEnd)
+	{
+		if (groupEnd > groupBegin)
+		{
+			items.push_back(BatchWorkItem{
+				groupBegin, groupEnd - groupBegin, 0, 0, false, 0, 0 });
+		}
+		groupBegin = groupEnd;
+		groupCost = 0;
+	};
+
+	for (size_t i = 0; i < numStrs; ++i)
+	{
+		const auto& str = begin[i];
+		const size_t strSize = str.size();
+		if (strSize > chunkSize)
+		{
+			flushGroup(i);
+
+			const auto strBegin = str.data();
+			size_t pos = 0;
+			while ((strSize - pos) > chunkSize)
+			{
+				size_t cut = static_cast<size_t>(_BatchImpl::SeqBegin(
+					strBegin, strBegin + pos + chunkSize) - strBegin);
+				if (cut <= pos)
+				{
+					// the chunk is shorter than a sequence; move forward to
+					// the next sequence instead
+					cut = pos + chunkSize;
+					while ((cut < strSize) &&
+						(_BatchImpl::SeqBegin(strBegin, strBegin + cut) !=
+							strBegin + cut))
+					{
+						++cut;
+					}
+				}
+				items.push_back(BatchWorkItem{ i, 1, pos, cut, true, 0, 0 });
+				pos = cut;
+			}
+			items.push_back(BatchWorkItem{ i, 1, pos, strSize, true, 0, 0 });
+
+			groupBegin = i + 1;
+		}
+		else
+		{
+			// each string costs at least one, so long runs of empty
+			// strings are still split
+			groupCost += strSize + 1;
+			if (groupCost >= chunkSize)
+			{
+				flushGroup(i + 1);
+			}
+		}
+	}
+	flushGroup(numStrs);
+
+	// 1st pass - calculate the size of each output
+	std::vector<size_t> strSizes(numStrs, 0);
+	pool.Run(items.size(), [&](size_t itemIdx)
+	{
+		BatchWorkItem& item = items[itemIdx];
+		if (item.isChunk)
+		{
+			const auto strBegin = begin[item.strIdx].data();
+			item.outSize = _BatchImpl::GetSize(
+				strBegin + item.inBegin, strBegin + item.inEnd);
+		}
+		else
+		{
+			for (size_t i = item.strIdx; i < item.strIdx + item.numStrs; ++i)
+			{
+				const auto& str = begin[i];
+				strSizes[i] = _BatchImpl::GetSize(
+					str.data(), str.data() + str.size());
+				item.outSize += strSizes[i];
+			}
+		}
+	});
+
+	out.offsets.resize(numStrs + 1);
+	out.offsets[0] = 0;
+
+	size_t totalSize = 0;
+	for (auto& item : items)
+	{
+		item.outPos = totalSize;
+		totalSize += item.outSize;
+		if (item.isChunk)
+		{
+			strSizes[item.strIdx] += item.outSize;
+		}
+	}
+	for (size_t i = 0; i < numStrs; ++i)
+	{
+		out.offsets[i + 1] = out.offsets[i] + strSizes[i];
+	}
+
+	out.data.resize(totalSize);
+
+	// 2nd pass - write each output into its slot
+	OutCharType* dest = out.data.data();
+	pool.Run(items.size(), [&](size_t itemIdx)
+	{
+		const BatchWorkItem& item = items[itemIdx];
+		OutCharType* itemDest = dest + item.outPos;
+		if (item.isChunk)
+		{
+			const auto strBegin = begin[item.strIdx].data();
+			_BatchImpl::Convert(
+				strBegin + item.inBegin, strBegin + item.inEnd, itemDest);
+		}
+		else
+		{
+			for (size_t i = item.strIdx; i < item.strIdx + item.numStrs; ++i)
+			{
+				const auto& str = begin[i];
+				itemDest = _BatchImpl::Convert(
+					str.data(), str.data() + str.size(), itemDest);
+			}
+		}
+	});
+}
+
+} // namespace Internal
+
+/**
+ * @brief Runs batch conversions (see `UtfBatch.hpp`) on a
+ *        `WorkStealingPool`.
+ *        Strings longer than the chunk size are split into chunks at
+ *        sequence boundaries, and shorter strings are grouped into tasks of
+ *        about the chunk size; the output size of every task is calculated
+ *        first, so that each task then writes into its preassigned slot of
+ *        the output buffer.
+ *        The input iterators must be random access iterators.
+ *
+ */
+class UtfBatchExecutor
+{
+public:
+
+	static constexpr size_t sk_defaultChunkSize = 64 * 1024;
+
+	/**
+	 * @brief Construct a new UTF Batch Executor object
+	 *
+	 * @param numThreads The number of threads; 0 means the number of
+	 *                   hardware threads.
+	 * @param chunkSize  The approximate number of input code units per task
+	 */
+	explicit UtfBatchExecutor(
+		size_t numThreads = 0,
+		size_t chunkSize = sk_defaultChunkSize) :
+		m_pool(numThreads),
+		m_chunkSize(chunkSize)
+	{}
+
+	WorkStealingPool& GetPool()
+	{
+		return m_pool;
+	}
+
+	size_t GetChunkSize() const
+	{
+		return m_chunkSize;
+	}
+
+	template<typename InputIt>
+	void Utf8ToUtf16Batch(InputIt begin, InputIt end,
+		UtfBatch<char16_t>& out)
+	{
+		Internal::UtfConvertBatchParallel<
+			Internal::Utf8ToUtf16BatchImpl<Internal::BatchInCharT<InputIt> > >(
+				m_pool, m_chunkSize, begin, end, out);
+	}
+
+	template<typename InputIt>
+	void Utf8ToUtf32Batch(InputIt begin, InputIt end,
+		UtfBatch<char32_t>& out)
+	{
+		Internal::UtfConvertBatchParallel<
+			Internal::Utf8ToUtf32BatchImpl<Internal::BatchInCharT<InputIt> > >(
+				m_pool, m_chunkSize, begin, end, out);
+	}
+
+	template<typename InputIt>
+	void Utf16ToUtf8Batch(InputIt begin, InputIt end,
+		UtfBatch<char>& out)
+	{
+		Internal::UtfConvertBatchParallel<
+			Internal::Utf16ToUtf8BatchImpl<Internal::BatchInCharT<InputIt> > >(
+				m_pool, m_chunkSize, begin, end, out);
+	}
+
+	template<typename InputIt>
+	void Utf16ToUtf32Batch(InputIt begin, InputIt end,
+		UtfBatch<char32_t>& out)
+	{
+		Internal::UtfConvertBatchParallel<
+			Internal::Utf16ToUtf32BatchImpl<Internal::BatchInCharT<InputIt> > >(
+				m_pool, m_chunkSize, begin, end, out);
+	}
+
+	template<typename InputIt>
+	void Utf32ToUtf8Batch(InputIt begin, InputIt end,
+		UtfBatch<char>& out)
+	{
+		Internal::UtfConvertBatchParallel<
+			Internal::Utf32ToUtf8BatchImpl<Internal::BatchInCharT<InputIt> > >(
+				m_pool, m_chunkSize, begin, end, out);
+	}
+
+	template<typename InputIt>
+	void Utf32ToUtf16Batch(InputIt begin, InputIt end,
+		UtfBatch<char16_t>& out)
+	{
+		Internal::UtfConvertBatchParallel<
+			Internal::Utf32ToUtf16BatchImpl<Internal::BatchInCharT<InputIt> > >(
+				m_pool, m_chunkSize, begin, end, out);
+	}
+
+private:
+
+	WorkStealingPool m_pool;
+	size_t m_chunkSize;
+}; // class UtfBatchExecutor
+
+} // namespace SimpleUtf
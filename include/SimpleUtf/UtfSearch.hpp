@@ -0,0 +1,213 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include "Utf.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+// Searching UTF-8 and UTF-16 strings for code points and substrings,
+// without decoding the haystack.
+// Both UTF-8 and UTF-16 are self-synchronizing, so a match of an encoded
+// needle is a match of the code points, as long as it doesn't start or
+// end in the middle of a sequence.
+// All functions return the offset (in code units) of the first match at
+// or after `pos`, or `std::string::npos` if there is none.
+
+namespace Internal
+{
+
+template<typename _ValType>
+struct SearchTraits;
+
+template<>
+struct SearchTraits<char>
+{
+	static constexpr uint64_t sk_ones = 0x0101010101010101ULL;
+	static constexpr uint64_t sk_highs = 0x8080808080808080ULL;
+
+	static bool IsSeqCont(char val)
+	{
+		// 10xxxxxx
+		return (BitCast2Unsigned(val) & 0xC0U) == 0x80U;
+	}
+}; // struct SearchTraits
+
+template<>
+struct SearchTraits<char16_t>
+{
+	static constexpr uint64_t sk_ones = 0x0001000100010001ULL;
+	static constexpr uint64_t sk_highs = 0x8000800080008000ULL;
+
+	static bool IsSeqCont(char16_t val)
+	{
+		return IsUtf16SurrogateSecond(val);
+	}
+}; // struct SearchTraits
+
+/**
+ * @brief Finds the first match of [nBegin, nEnd) in [begin, end) that
+ *        starts and ends at sequence boundaries.
+ *        Candidates are filtered by the first and the last code unit of the
+ *        needle, 8 bytes of positions at a time (SWAR - SIMD within a
+ *        register); only the positions where both match are compared in
+ *        full.
+ *
+ * @return the beginning of the match, or `end` if there is none
+ */
+template<typename _ValType>
+inline const _ValType* FindSeqImpl(const _ValType* begin, const _ValType* end,
+	const _ValType* nBegin, const _ValType* nEnd)
+{
+	using Traits = SearchTraits<_ValType>;
+	static constexpr size_t sk_lanes = sizeof(uint64_t) / sizeof(_ValType);
+
+	const size_t nSize = static_cast<size_t>(nEnd - nBegin);
+	if (static_cast<size_t>(end - begin) < nSize)
+	{
+		return end;
+	}
+
+	const _ValType first = nBegin[0];
+	const _ValType last = nBegin[nSize - 1];
+
+	auto isMatch = [&](const _ValType* ptr)
+	{
+		return (ptr[0] == first) && (ptr[nSize - 1] == last) &&
+			std::equal(nBegin, nEnd, ptr) &&
+			!Traits::IsSeqCont(ptr[0]) &&
+			((ptr + nSize == end) || !Traits::IsSeqCont(ptr[nSize]));
+	};
+
+	// one past the last position a match can start at
+	const _ValType* posEnd = end - nSize + 1;
+
+	const uint64_t firstWord =
+		Traits::sk_ones * BitCast2Unsigned(first);
+	const uint64_t lastWord =
+		Traits::sk_ones * BitCast2Unsigned(last);
+
+	const _ValType* ptr = begin;
+	for (; static_cast<size_t>(posEnd - ptr) >= sk_lanes; ptr += sk_lanes)
+	{
+		uint64_t firstUnits = 0;
+		uint64_t lastUnits = 0;
+		std::memcpy(&firstUnits, ptr, sizeof(firstUnits));
+		std::memcpy(&lastUnits, ptr + nSize - 1, sizeof(lastUnits));
+
+		// a lane is zero where the code unit matches
+		const uint64_t x = firstUnits ^ firstWord;
+		const uint64_t y = lastUnits ^ lastWord;
+		// (false positives only happen after a true positive)
+		const uint64_t candidates =
+			((x - Traits::sk_ones) & ~x) &
+			((y - Traits::sk_ones) & ~y) &
+			Traits::sk_highs;
+		if (candidates != 0)
+		{
+			for (size_t i = 0; i < sk_lanes; ++i)
+			{
+				if (isMatch(ptr + i))
+				{
+					return ptr + i;
+				}
+			}
+		}
+	}
+	for (; ptr != posEnd; ++ptr)
+	{
+		if (isMatch(ptr))
+		{
+			return ptr;
+		}
+	}
+
+	return end;
+}
+
+template<typename _ValType>
+inline size_t FindSeq(const _ValType* begin, const _ValType* end,
+	const _ValType* nBegin, const _ValType* nEnd, size_t pos)
+{
+	const size_t size = static_cast<size_t>(end - begin);
+	if (pos > size)
+	{
+		return std::string::npos;
+	}
+	if (nBegin == nEnd)
+	{
+		return pos;
+	}
+
+	const _ValType* res = FindSeqImpl(begin + pos, end, nBegin, nEnd);
+	return res == end ?
+		std::string::npos : static_cast<size_t>(res - begin);
+}
+
+} // namespace Internal
+
+// ==========  UTF-8
+
+/**
+ * @brief Finds the UTF-8 string `needle` in `haystack`
+ *
+ */
+inline size_t FindUtf8(Internal::StrInputT<char> haystack,
+	Internal::StrInputT<char> needle, size_t pos = 0)
+{
+	return Internal::FindSeq(haystack.data(), haystack.data() + haystack.size(),
+		needle.data(), needle.data() + needle.size(), pos);
+}
+
+/**
+ * @brief Finds the code point `val` in the UTF-8 string `utf8`
+ *
+ * @exception UtfConversionException if `val` is not a valid code point
+ */
+inline size_t FindCodePt(Internal::StrInputT<char> utf8, char32_t val,
+	size_t pos = 0)
+{
+	char needle[4] = { 0, 0, 0, 0 };
+	char* needleEnd = CodePtToUtf8Once(val, needle);
+
+	return Internal::FindSeq(utf8.data(), utf8.data() + utf8.size(),
+		needle, needleEnd, pos);
+}
+
+// ==========  UTF-16
+
+/**
+ * @brief Finds the UTF-16 string `needle` in `haystack`
+ *
+ */
+inline size_t FindUtf16(Internal::StrInputT<char16_t> haystack,
+	Internal::StrInputT<char16_t> needle, size_t pos = 0)
+{
+	return Internal::FindSeq(haystack.data(), haystack.data() + haystack.size(),
+		needle.data(), needle.data() + needle.size(), pos);
+}
+
+/**
+ * @brief Finds the code point `val` in the UTF-16 string `utf16`
+ *
+ * @exception UtfConversionException if `val` is not a valid code point
+ */
+inline size_t FindCodePt(Internal::StrInputT<char16_t> utf16, char32_t val,
+	size_t pos = 0)
+{
+	char16_t needle[2] = { 0, 0 };
+	char16_t* needleEnd = CodePtToUtf16Once(val, needle);
+
+	return Internal::FindSeq(utf16.data(), utf16.data() + utf16.size(),
+		needle, needleEnd, pos);
+}
+
+} // namespace SimpleUtf
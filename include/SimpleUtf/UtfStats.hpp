@@ -0,0 +1,258 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef SIMPLEUTF_ENABLE_STATS
+#include <atomic>
+#include <mutex>
+#include <vector>
+#endif // SIMPLEUTF_ENABLE_STATS
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+/**
+ * @brief The counters collected when SimpleUtf is built with
+ *        `SIMPLEUTF_ENABLE_STATS` defined
+ *
+ */
+enum class UtfStatsCounter : size_t
+{
+	// number of UtfConvert calls
+	ConvertCalls,
+	// bytes consumed by the decoders, and produced by the encoders
+	BytesIn,
+	BytesOut,
+	// bytes that went through the ASCII fast paths (see CountAsciiPrefix)
+	AsciiFastPathBytes,
+	// code points decoded from UTF-8, by length
+	Utf8Decoded1B,
+	Utf8Decoded2B,
+	Utf8Decoded3B,
+	Utf8Decoded4B,
+	// code points encoded into UTF-8, by length
+	Utf8Encoded1B,
+	Utf8Encoded2B,
+	Utf8Encoded3B,
+	Utf8Encoded4B,
+	// surrogate pairs decoded from, and encoded into UTF-16
+	Utf16DecodedSurrogatePairs,
+	Utf16EncodedSurrogatePairs,
+	// exceptions thrown, by error kind
+	ErrUnexpectedEnding,
+	ErrInvalidEncoding,
+	ErrInvalidCodePoint,
+
+	NumCounters
+}; // enum class UtfStatsCounter
+
+/**
+ * @brief A snapshot of all the counters; all zeros if stats are disabled
+ *
+ */
+struct UtfStatsSnapshot
+{
+	static constexpr size_t sk_numCounters =
+		static_cast<size_t>(UtfStatsCounter::NumCounters);
+
+	uint64_t counters[sk_numCounters];
+
+	uint64_t Get(UtfStatsCounter counter) const
+	{
+		return counters[static_cast<size_t>(counter)];
+	}
+}; // struct UtfStatsSnapshot
+
+#ifdef SIMPLEUTF_ENABLE_STATS
+
+namespace Internal
+{
+
+/**
+ * @brief The counters of a single thread; the atomic counters are only
+ *        written by the owning thread, and read by `GetUtfStats`, so relaxed
+ *        atomic loads/stores are enough.
+ *        `ResetUtfStats` doesn't write to the counters, since that would
+ *        race with the owner's load-add-store; instead, it records their
+ *        current values as the baselines, which are subtracted from them
+ *        when read.
+ *        The baselines are only accessed with the registry's mutex held.
+ *
+ */
+struct UtfStatsBlock
+{
+	std::atomic<uint64_t> counters[UtfStatsSnapshot::sk_numCounters];
+	uint64_t baselines[UtfStatsSnapshot::sk_numCounters];
+
+	UtfStatsBlock() :
+		baselines()
+	{
+		for (auto& counter : counters)
+		{
+			counter.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * @brief The count of the i-th counter since the last reset
+	 *
+	 */
+	uint64_t Load(size_t i) const
+	{
+		return counters[i].load(std::memory_order_relaxed) - baselines[i];
+	}
+}; // struct UtfStatsBlock
+
+class UtfStatsRegistry
+{
+public:
+
+	static UtfStatsRegistry& GetInstance()
+	{
+		static UtfStatsRegistry inst;
+		return inst;
+	}
+
+	void Register(UtfStatsBlock* block)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_blocks.push_back(block);
+	}
+
+	/**
+	 * @brief Removes a block when its thread exits, and keeps its counts
+	 *
+	 */
+	void Unregister(UtfStatsBlock* block)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (size_t i = 0; i < UtfStatsSnapshot::sk_numCounters; ++i)
+		{
+			m_retired[i] += block->Load(i);
+		}
+		for (auto it = m_blocks.begin(); it != m_blocks.end(); ++it)
+		{
+			if (*it == block)
+			{
+				m_blocks.erase(it);
+				break;
+			}
+		}
+	}
+
+	UtfStatsSnapshot Snapshot()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		UtfStatsSnapshot res;
+		for (size_t i = 0; i < UtfStatsSnapshot::sk_numCounters; ++i)
+		{
+			res.counters[i] = m_retired[i];
+			for (const auto block : m_blocks)
+			{
+				res.counters[i] += block->Load(i);
+			}
+		}
+		return res;
+	}
+
+	void Reset()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (size_t i = 0; i < UtfStatsSnapshot::sk_numCounters; ++i)
+		{
+			m_retired[i] = 0;
+			for (const auto block : m_blocks)
+			{
+				block->baselines[i] =
+					block->counters[i].load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+private:
+
+	UtfStatsRegistry() :
+		m_mutex(),
+		m_blocks(),
+		m_retired()
+	{}
+
+	std::mutex m_mutex;
+	std::vector<UtfStatsBlock*> m_blocks;
+	uint64_t m_retired[UtfStatsSnapshot::sk_numCounters];
+}; // class UtfStatsRegistry
+
+struct UtfThreadStats
+{
+	UtfStatsBlock m_block;
+
+	UtfThreadStats() :
+		m_block()
+	{
+		UtfStatsRegistry::GetInstance().Register(&m_block);
+	}
+
+	~UtfThreadStats()
+	{
+		UtfStatsRegistry::GetInstance().Unregister(&m_block);
+	}
+}; // struct UtfThreadStats
+
+inline void UtfStatsAdd(UtfStatsCounter counter, uint64_t val)
+{
+	thread_local UtfThreadStats threadStats;
+
+	// Only the owning thread writes to the counter
+	std::atomic<uint64_t>& cnt =
+		threadStats.m_block.counters[static_cast<size_t>(counter)];
+	cnt.store(cnt.load(std::memory_order_relaxed) + val,
+		std::memory_order_relaxed);
+}
+
+} // namespace Internal
+
+#	define SIMPLEUTF_STATS_ADD(COUNTER, VAL) \
+		(Internal::UtfStatsAdd(UtfStatsCounter::COUNTER, (VAL)))
+// adds to the IDX-th counter after COUNTER (e.g., Utf8Decoded1B + 2)
+#	define SIMPLEUTF_STATS_ADD_NTH(COUNTER, IDX, VAL) \
+		(Internal::UtfStatsAdd( \
+			static_cast<UtfStatsCounter>( \
+				static_cast<size_t>(UtfStatsCounter::COUNTER) + (IDX)), \
+			(VAL)))
+
+inline UtfStatsSnapshot GetUtfStats()
+{
+	return Internal::UtfStatsRegistry::GetInstance().Snapshot();
+}
+
+inline void ResetUtfStats()
+{
+	Internal::UtfStatsRegistry::GetInstance().Reset();
+}
+
+#else // !SIMPLEUTF_ENABLE_STATS
+
+#	define SIMPLEUTF_STATS_ADD(COUNTER, VAL) ((void)0)
+#	define SIMPLEUTF_STATS_ADD_NTH(COUNTER, IDX, VAL) ((void)0)
+
+inline UtfStatsSnapshot GetUtfStats()
+{
+	return UtfStatsSnapshot();
+}
+
+inline void ResetUtfStats()
+{}
+
+#endif // SIMPLEUTF_ENABLE_STATS
+
+} // namespace SimpleUtf
@@ -0,0 +1,787 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include <cstring>
+#include <cwchar>
+
+#include <algorithm>
+#include <locale>
+#include <streambuf>
+#include <vector>
+
+#include "Utf8.hpp"
+#include "Utf16.hpp"
+#include "UtfNewline.hpp"
+#include "UtfValidate.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+/**
+ * @brief The result of a streaming conversion call
+ *
+ */
+enum class UtfStreamResult
+{
+	// all input is converted
+	Ok,
+	// not all input could be converted, because the output is full, or
+	// more input is needed to complete a pending sequence
+	Partial,
+	// the input is invalid; the input pointer points to the beginning of
+	// the invalid sequence
+	Error,
+}; // enum class UtfStreamResult
+
+/**
+ * @brief The state of a streaming UTF-8 decoder - the bytes of a sequence
+ *        that is split across two input blocks.
+ *
+ */
+struct Utf8StreamState
+{
+	uint8_t numBytes = 0;
+	uint8_t bytes[3] = {};
+}; // struct Utf8StreamState
+
+/**
+ * @brief The state of a streaming UTF-16 decoder - the high surrogate of a
+ *        pair that is split across two input blocks.
+ *
+ */
+struct Utf16StreamState
+{
+	char16_t highSurrogate = 0;
+}; // struct Utf16StreamState
+
+namespace Internal
+{
+
+/**
+ * @brief The length of the UTF-8 sequence started by the given leading
+ *        byte, or 0 if it's not a valid leading byte; this doesn't throw.
+ *
+ */
+inline size_t Utf8SeqLength(uint8_t leading)
+{
+	return (leading < 0x80U) ? 1 :
+		((leading & 0xE0U) == 0xC0U) ? 2 :
+		((leading & 0xF0U) == 0xE0U) ? 3 :
+		((leading & 0xF8U) == 0xF0U) ? 4 : 0;
+}
+
+inline bool Utf8IsCont(uint8_t val)
+{
+	return (val & 0xC0U) == 0x80U;
+}
+
+inline size_t Utf16NumUnits(char32_t codePt)
+{
+	return codePt > 0xFFFFU ? 2 : 1;
+}
+
+/**
+ * @brief Decodes the complete UTF-8 sequence at `begin`, without throwing
+ *
+ * @return The code point, and the end of the sequence; the end is `begin`
+ *         if the sequence is not valid
+ */
+template<typename _ValType>
+inline std::pair<char32_t, const _ValType*> Utf8StreamDecodeOnce(
+	const _ValType* begin, const _ValType* end)
+{
+	const _ValType* seqEnd = Utf8ValidSeqEnd(begin, end);
+	if (seqEnd == begin)
+	{
+		SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+		return std::make_pair(char32_t(0), begin);
+	}
+	return std::make_pair(
+		Utf8ToCodePtOnceUnchecked(begin, seqEnd).first, seqEnd);
+}
+
+/**
+ * @brief The number of UTF-16 code units in the valid sequence at `begin`,
+ *        or 0 if it's a lone surrogate; `begin` must not be a high
+ *        surrogate at the end of the input.
+ *
+ */
+template<typename _ValType>
+inline size_t Utf16StreamSeqLength(const _ValType* begin, const _ValType* end)
+{
+	const char16_t unit = static_cast<char16_t>(*begin);
+	if ((unit & 0xF800U) != 0xD800U)
+	{
+		return 1;
+	}
+	if (((unit & 0xFC00U) == 0xD800U) && (begin + 1 != end) &&
+		((static_cast<char16_t>(begin[1]) & 0xFC00U) == 0xDC00U))
+	{
+		return 2;
+	}
+	SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+	return 0;
+}
+
+/**
+ * @brief Loads a streaming state from (and stores it into) a
+ *        `std::mbstate_t`, which is treated as opaque storage; a
+ *        zero-initialized `std::mbstate_t` gives the initial state.
+ *
+ */
+template<typename _StateType>
+inline _StateType LoadStreamState(const std::mbstate_t& mbState)
+{
+	static_assert(sizeof(_StateType) <= sizeof(std::mbstate_t),
+		"The streaming state doesn't fit in std::mbstate_t");
+	static_assert(std::is_trivially_copyable<_StateType>::value,
+		"The streaming state must be trivially copyable");
+
+	_StateType state;
+	// it only has a default constructor, so it can be copied byte by byte
+	std::memcpy(static_cast<void*>(&state), &mbState, sizeof(_StateType));
+	return state;
+}
+
+template<typename _StateType>
+inline void StoreStreamState(std::mbstate_t& mbState, const _StateType& state)
+{
+	std::memcpy(&mbState, &state, sizeof(_StateType));
+}
+
+} // namespace Internal
+
+/**
+ * @brief Decodes a block of a UTF-8 stream into UTF-16.
+ *        A sequence that is cut at the end of the block is consumed and
+ *        kept in `state`, and is completed by the following call(s); in
+ *        this case `Partial` is returned, so that the caller knows the
+ *        stream must not end here.
+ *
+ * @param state   The decoder state, carried from one call to the next
+ * @param inNext  [in,out] The input position, updated to the first byte not
+ *                consumed
+ * @param inEnd   The end of the input block
+ * @param outNext [in,out] The output position, updated to the first code
+ *                unit not written
+ * @param outEnd  The end of the output buffer
+ * @param newlines If not null, line breaks are normalized to LF (see
+ *                `NewlineNormalizer`); a CR at the end of a block is
+ *                paired with an LF at the beginning of the next one
+ */
+template<typename _InCharType, typename _OutCharType>
+inline UtfStreamResult Utf8ToUtf16Stream(Utf8StreamState& state,
+	const _InCharType*& inNext, const _InCharType* inEnd,
+	_OutCharType*& outNext, _OutCharType* outEnd,
+	NewlineNormalizer* newlines = nullptr)
+{
+	const _InCharType* in = inNext;
+	_OutCharType* out = outNext;
+
+	// 1. complete the sequence pending from the previous block
+	if (state.numBytes != 0)
+	{
+		uint8_t seq[4] = { 0, 0, 0, 0 };
+		std::memcpy(seq, state.bytes, state.numBytes);
+		size_t seqLen = state.numBytes;
+		const size_t needed = Internal::Utf8SeqLength(seq[0]);
+
+		while ((seqLen < needed) && (in != inEnd))
+		{
+			const uint8_t val = Internal::BitCast2Unsigned(*in);
+			if (!Internal::Utf8IsCont(val))
+			{
+				// the invalid sequence began in the previous block, so
+				// nothing in this one is consumed
+				SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+				state.numBytes = 0;
+				return UtfStreamResult::Error;
+			}
+			seq[seqLen++] = val;
+			++in;
+		}
+
+		if (seqLen < needed)
+		{
+			// still incomplete - keep all of it
+			std::memcpy(state.bytes, seq, seqLen);
+			state.numBytes = static_cast<uint8_t>(seqLen);
+			inNext = in;
+			return UtfStreamResult::Partial;
+		}
+
+		const auto codePtRes =
+			Internal::Utf8StreamDecodeOnce(seq, seq + seqLen);
+		if (codePtRes.second == seq)
+		{
+			state.numBytes = 0;
+			return UtfStreamResult::Error;
+		}
+		const char32_t codePt = codePtRes.first;
+
+		if (static_cast<size_t>(outEnd - out) <
+			Internal::Utf16NumUnits(codePt))
+		{
+			// the bytes just read are given back to the caller
+			return UtfStreamResult::Partial;
+		}
+		out = Internal::CodePtToUtf16OnceUnchecked(codePt, out);
+		state.numBytes = 0;
+		if (newlines != nullptr)
+		{
+			newlines->PassPlain();
+		}
+	}
+
+	// 2. convert the rest of the block
+	while (in != inEnd)
+	{
+		if (out == outEnd)
+		{
+			inNext = in;
+			outNext = out;
+			return UtfStreamResult::Partial;
+		}
+
+		// runs of ASCII characters (other than CR and LF, if they are
+		// normalized)
+		size_t numAscii = (newlines == nullptr) ?
+			Internal::CountAsciiPrefix(in, inEnd) :
+			Internal::CountNewlinePlainPrefix(in, inEnd);
+		if (numAscii != 0)
+		{
+			numAscii = std::min(numAscii,
+				static_cast<size_t>(outEnd - out));
+			out = std::copy(in, in + numAscii, out);
+			in += numAscii;
+			if (newlines != nullptr)
+			{
+				newlines->PassPlain();
+			}
+			continue;
+		}
+
+		if ((newlines != nullptr) && ((*in == 0x0D) || (*in == 0x0A)))
+		{
+			char32_t codePt = static_cast<char32_t>(*in);
+			if (newlines->Filter(codePt))
+			{
+				*out = static_cast<_OutCharType>(codePt);
+				++out;
+			}
+			++in;
+			continue;
+		}
+
+		const size_t seqLen =
+			Internal::Utf8SeqLength(Internal::BitCast2Unsigned(*in));
+		if (seqLen == 0)
+		{
+			SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+			break;
+		}
+
+		if (static_cast<size_t>(inEnd - in) < seqLen)
+		{
+			// the sequence is cut at the end of the block
+			for (const _InCharType* it = in + 1; it != inEnd; ++it)
+			{
+				if (!Internal::Utf8IsCont(Internal::BitCast2Unsigned(*it)))
+				{
+					SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+					inNext = in;
+					outNext = out;
+					return UtfStreamResult::Error;
+				}
+			}
+			state.numBytes = static_cast<uint8_t>(inEnd - in);
+			for (size_t i = 0; i < state.numBytes; ++i)
+			{
+				state.bytes[i] = Internal::BitCast2Unsigned(in[i]);
+			}
+			inNext = inEnd;
+			outNext = out;
+			return UtfStreamResult::Partial;
+		}
+
+		const auto codePtRes = Internal::Utf8StreamDecodeOnce(in, inEnd);
+		if (codePtRes.second == in)
+		{
+			break;
+		}
+		if (static_cast<size_t>(outEnd - out) <
+			Internal::Utf16NumUnits(codePtRes.first))
+		{
+			inNext = in;
+			outNext = out;
+			return UtfStreamResult::Partial;
+		}
+		out = Internal::CodePtToUtf16OnceUnchecked(codePtRes.first, out);
+		in = codePtRes.second;
+		if (newlines != nullptr)
+		{
+			newlines->PassPlain();
+		}
+	}
+
+	inNext = in;
+	outNext = out;
+	return in == inEnd ? UtfStreamResult::Ok : UtfStreamResult::Error;
+}
+
+/**
+ * @brief Encodes a block of a UTF-16 stream into UTF-8.
+ *        A high surrogate at the end of the block is consumed and kept in
+ *        `state`, to be paired with the first unit of the next block; in
+ *        this case `Partial` is returned.
+ *
+ * @param state   The encoder state, carried from one call to the next
+ * @param inNext  [in,out] The input position, updated to the first code
+ *                unit not consumed
+ * @param inEnd   The end of the input block
+ * @param outNext [in,out] The output position, updated to the first byte
+ *                not written
+ * @param outEnd  The end of the output buffer
+ * @param newlines If not null, line breaks are normalized to LF (see
+ *                `NewlineNormalizer`)
+ */
+template<typename _InCharType, typename _OutCharType>
+inline UtfStreamResult Utf16ToUtf8Stream(Utf16StreamState& state,
+	const _InCharType*& inNext, const _InCharType* inEnd,
+	_OutCharType*& outNext, _OutCharType* outEnd,
+	NewlineNormalizer* newlines = nullptr)
+{
+	const _InCharType* in = inNext;
+	_OutCharType* out = outNext;
+
+	// 1. complete the surrogate pair pending from the previous block
+	if (state.highSurrogate != 0)
+	{
+		if (in == inEnd)
+		{
+			return UtfStreamResult::Partial;
+		}
+
+		const char16_t pair[2] = {
+			state.highSurrogate, static_cast<char16_t>(*in)
+		};
+		if (Internal::Utf16StreamSeqLength(pair, pair + 2) != 2)
+		{
+			// the invalid pair began in the previous block, so nothing in
+			// this one is consumed
+			state.highSurrogate = 0;
+			return UtfStreamResult::Error;
+		}
+		const char32_t codePt =
+			Internal::Utf16ToCodePtOnceUnchecked(pair, pair + 2).first;
+
+		if (outEnd - out < 4)
+		{
+			return UtfStreamResult::Partial;
+		}
+		out = Internal::CodePtToUtf8OnceUnchecked(codePt, out);
+		++in;
+		state.highSurrogate = 0;
+		if (newlines != nullptr)
+		{
+			newlines->PassPlain();
+		}
+	}
+
+	// 2. convert the rest of the block
+	while (in != inEnd)
+	{
+		const char16_t unit = static_cast<char16_t>(*in);
+		if (unit < 0x80U)
+		{
+			if (out == outEnd)
+			{
+				break;
+			}
+			char32_t codePt = unit;
+			if ((newlines == nullptr) || newlines->Filter(codePt))
+			{
+				*out = static_cast<_OutCharType>(codePt);
+				++out;
+			}
+			++in;
+			continue;
+		}
+
+		if ((unit >= 0xD800U) && (unit <= 0xDBFFU) && (in + 1 == inEnd))
+		{
+			// the surrogate pair is cut at the end of the block
+			state.highSurrogate = unit;
+			inNext = inEnd;
+			outNext = out;
+			return UtfStreamResult::Partial;
+		}
+
+		const size_t seqLen = Internal::Utf16StreamSeqLength(in, inEnd);
+		if (seqLen == 0)
+		{
+			inNext = in;
+			outNext = out;
+			return UtfStreamResult::Error;
+		}
+		const char32_t codePt =
+			Internal::Utf16ToCodePtOnceUnchecked(in, in + seqLen).first;
+		if (static_cast<size_t>(outEnd - out) <
+			Internal::CodePtToUtf8OnceGetSizeUnchecked(codePt))
+		{
+			break;
+		}
+		out = Internal::CodePtToUtf8OnceUnchecked(codePt, out);
+		in += seqLen;
+		if (newlines != nullptr)
+		{
+			newlines->PassPlain();
+		}
+	}
+
+	inNext = in;
+	outNext = out;
+	return in == inEnd ? UtfStreamResult::Ok : UtfStreamResult::Partial;
+}
+
+#if defined(_MSC_VER)
+#	pragma warning(push)
+#	pragma warning(disable: 4996)
+#elif defined(__GNUC__)
+#	pragma GCC diagnostic push
+#	pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+
+/**
+ * @brief A `std::codecvt<char16_t, char, std::mbstate_t>` facet converting
+ *        between UTF-16 (internal) and UTF-8 (external), as a replacement of
+ *        the deprecated `std::codecvt_utf8_utf16<char16_t>`.
+ *        Sequences cut at the end of a block are kept in the `mbstate_t`.
+ *
+ */
+class Utf8Utf16Codecvt : public std::codecvt<char16_t, char, std::mbstate_t>
+{
+public:
+
+	using Base = std::codecvt<char16_t, char, std::mbstate_t>;
+
+	explicit Utf8Utf16Codecvt(size_t refs = 0) :
+		Base(refs)
+	{}
+
+	virtual ~Utf8Utf16Codecvt() = default;
+
+protected:
+
+	static result ToCodecvtResult(UtfStreamResult res)
+	{
+		switch (res)
+		{
+		case UtfStreamResult::Ok:
+			return ok;
+		case UtfStreamResult::Partial:
+			return partial;
+		case UtfStreamResult::Error:
+		default:
+			return error;
+		}
+	}
+
+	virtual result do_out(state_type& mbState,
+		const intern_type* from, const intern_type* fromEnd,
+		const intern_type*& fromNext,
+		extern_type* to, extern_type* toEnd,
+		extern_type*& toNext) const override
+	{
+		Utf16StreamState state =
+			Internal::LoadStreamState<Utf16StreamState>(mbState);
+
+		fromNext = from;
+		toNext = to;
+		const UtfStreamResult res =
+			Utf16ToUtf8Stream(state, fromNext, fromEnd, toNext, toEnd);
+
+		Internal::StoreStreamState(mbState, state);
+		return ToCodecvtResult(res);
+	}
+
+	virtual result do_in(state_type& mbState,
+		const extern_type* from, const extern_type* fromEnd,
+		const extern_type*& fromNext,
+		intern_type* to, intern_type* toEnd,
+		intern_type*& toNext) const override
+	{
+		Utf8StreamState state =
+			Internal::LoadStreamState<Utf8StreamState>(mbState);
+
+		fromNext = from;
+		toNext = to;
+		const UtfStreamResult res =
+			Utf8ToUtf16Stream(state, fromNext, fromEnd, toNext, toEnd);
+
+		Internal::StoreStreamState(mbState, state);
+		return ToCodecvtResult(res);
+	}
+
+	virtual result do_unshift(state_type& mbState,
+		extern_type* to, extern_type*,
+		extern_type*& toNext) const override
+	{
+		toNext = to;
+
+		// a high surrogate without its pair can't be written out
+		return Internal::LoadStreamState<Utf16StreamState>(
+			mbState).highSurrogate != 0 ? error : noconv;
+	}
+
+	virtual int do_encoding() const noexcept override
+	{
+		// variable length
+		return 0;
+	}
+
+	virtual bool do_always_noconv() const noexcept override
+	{
+		return false;
+	}
+
+	virtual int do_length(state_type& mbState,
+		const extern_type* from, const extern_type* fromEnd,
+		size_t max) const override
+	{
+		Utf8StreamState state =
+			Internal::LoadStreamState<Utf8StreamState>(mbState);
+
+		intern_type buf[256];
+		const extern_type* fromNext = from;
+		while ((max != 0) && (fromNext != fromEnd))
+		{
+			intern_type* toNext = buf;
+			const UtfStreamResult res = Utf8ToUtf16Stream(state,
+				fromNext, fromEnd,
+				toNext, buf + std::min<size_t>(max, sizeof(buf) / sizeof(buf[0])));
+			max -= static_cast<size_t>(toNext - buf);
+
+			if ((res == UtfStreamResult::Error) || (toNext == buf))
+			{
+				break;
+			}
+		}
+
+		Internal::StoreStreamState(mbState, state);
+		return static_cast<int>(fromNext - from);
+	}
+
+	virtual int do_max_length() const noexcept override
+	{
+		return 4;
+	}
+}; // class Utf8Utf16Codecvt
+
+#if defined(_MSC_VER)
+#	pragma warning(pop)
+#elif defined(__GNUC__)
+#	pragma GCC diagnostic pop
+#endif
+
+/**
+ * @brief A UTF-16 stream buffer on top of a UTF-8 (byte) stream buffer; it
+ *        transcodes on the fly, a block at a time, so reading or writing a
+ *        UTF-8 file through it needs no separate conversion pass.
+ *        Reading decodes the underlying bytes into UTF-16, and writing
+ *        encodes UTF-16 into the underlying bytes (flushed on `sync`, on
+ *        overflow, by `Finish`, and on destruction).
+ *
+ * @exception UtfConversionException when reading invalid UTF-8 (or a
+ *            stream ending in the middle of a sequence), or writing invalid
+ *            UTF-16; `std::basic_istream` and `std::basic_ostream` turn it
+ *            into `badbit`.
+ */
+class Utf8Utf16StreamBuf : public std::basic_streambuf<char16_t>
+{
+public:
+
+	static constexpr size_t sk_defaultBufSize = 64 * 1024;
+
+	/**
+	 * @brief Construct a new Utf8Utf16StreamBuf object
+	 *
+	 * @param bytes   The underlying stream buffer of UTF-8 bytes; it must
+	 *                outlive this object.
+	 * @param bufSize The size of the blocks, in code units
+	 */
+	explicit Utf8Utf16StreamBuf(std::streambuf* bytes,
+		size_t bufSize = sk_defaultBufSize) :
+		m_bytes(bytes),
+		m_extBuf(),
+		m_inBuf(),
+		m_outBuf(),
+		m_inState(),
+		m_outState()
+	{
+		bufSize = std::max<size_t>(bufSize, 4);
+		// one code unit per byte at most, plus a pending surrogate pair
+		m_inBuf.resize(bufSize + 2);
+		m_outBuf.resize(bufSize);
+		// 3 bytes per code unit at most
+		m_extBuf.resize(bufSize * 3 + 4);
+
+		setg(m_inBuf.data(), m_inBuf.data(), m_inBuf.data());
+		setp(m_outBuf.data(), m_outBuf.data() + m_outBuf.size());
+	}
+
+	Utf8Utf16StreamBuf(const Utf8Utf16StreamBuf&) = delete;
+
+	Utf8Utf16StreamBuf& operator=(const Utf8Utf16StreamBuf&) = delete;
+
+	/**
+	 * @brief Flushes the output; errors can't be reported here, so a high
+	 *        surrogate still waiting for its pair is written as U+FFFD
+	 *        (and counted as `ErrUnexpectedEnding`) instead of being
+	 *        dropped. Call `Finish` first to have it reported.
+	 *
+	 */
+	virtual ~Utf8Utf16StreamBuf()
+	{
+		try
+		{
+			FlushOut();
+		}
+		catch (...)
+		{}
+
+		if (m_outState.highSurrogate != 0)
+		{
+			static constexpr char sk_replacement[] = "\xEF\xBF\xBD";
+
+			SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
+			m_outState.highSurrogate = 0;
+			m_bytes->sputn(sk_replacement, sizeof(sk_replacement) - 1);
+		}
+	}
+
+	/**
+	 * @brief Flushes the output, which must end here
+	 *
+	 * @exception UtfConversionException if the output ends in the middle of
+	 *            a surrogate pair; the pending high surrogate is discarded.
+	 */
+	void Finish()
+	{
+		FlushOut();
+		if (m_outState.highSurrogate != 0)
+		{
+			m_outState.highSurrogate = 0;
+			SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
+			throw UtfConversionException("Unexpected Ending" " - "
+				"Stream ends in the middle of a UTF-16 surrogate pair.");
+		}
+	}
+
+protected:
+
+	virtual int_type underflow() override
+	{
+		if (gptr() < egptr())
+		{
+			return traits_type::to_int_type(*gptr());
+		}
+
+		// the input buffer holds at least as many units as bytes read
+		const size_t readSize = m_inBuf.size() - 2;
+		char16_t* out = m_inBuf.data();
+		while (out == m_inBuf.data())
+		{
+			const std::streamsize numRead = m_bytes->sgetn(m_extBuf.data(),
+				static_cast<std::streamsize>(readSize));
+			if (numRead <= 0)
+			{
+				if (m_inState.numBytes != 0)
+				{
+					m_inState.numBytes = 0;
+					SIMPLEUTF_STATS_ADD(ErrUnexpectedEnding, 1);
+					throw UtfConversionException("Unexpected Ending" " - "
+						"Stream ends in the middle of a UTF-8 sequence.");
+				}
+				return traits_type::eof();
+			}
+
+			const char* in = m_extBuf.data();
+			const char* inEnd = in + numRead;
+			const UtfStreamResult res = Utf8ToUtf16Stream(m_inState,
+				in, inEnd, out, m_inBuf.data() + m_inBuf.size());
+			if (res == UtfStreamResult::Error)
+			{
+				// start over from a clean state, if reading goes on
+				m_inState = Utf8StreamState();
+				setg(m_inBuf.data(), m_inBuf.data(), m_inBuf.data());
+				throw UtfConversionException("Invalid Encoding" " - "
+					"Invalid UTF-8 sequence in the stream.");
+			}
+		}
+
+		setg(m_inBuf.data(), m_inBuf.data(), out);
+		return traits_type::to_int_type(*gptr());
+	}
+
+	virtual int_type overflow(int_type ch = traits_type::eof()) override
+	{
+		FlushOut();
+		if (!traits_type::eq_int_type(ch, traits_type::eof()))
+		{
+			*pptr() = traits_type::to_char_type(ch);
+			pbump(1);
+		}
+		return traits_type::not_eof(ch);
+	}
+
+	virtual int sync() override
+	{
+		FlushOut();
+		return m_bytes->pubsync();
+	}
+
+private:
+
+	void FlushOut()
+	{
+		const char16_t* in = pbase();
+		char* out = m_extBuf.data();
+		const UtfStreamResult res = Utf16ToUtf8Stream(m_outState,
+			in, static_cast<const char16_t*>(pptr()),
+			out, m_extBuf.data() + m_extBuf.size());
+		setp(m_outBuf.data(), m_outBuf.data() + m_outBuf.size());
+
+		// what is converted before an error is still written out
+		const std::streamsize numBytes =
+			static_cast<std::streamsize>(out - m_extBuf.data());
+		if (m_bytes->sputn(m_extBuf.data(), numBytes) != numBytes)
+		{
+			throw UtfConversionException("Failed to write to the stream");
+		}
+
+		if (res == UtfStreamResult::Error)
+		{
+			m_outState = Utf16StreamState();
+			throw UtfConversionException("Invalid Encoding" " - "
+				"Invalid UTF-16 sequence written to the stream.");
+		}
+	}
+
+	std::streambuf* m_bytes;
+	std::vector<char> m_extBuf;
+	std::vector<char16_t> m_inBuf;
+	std::vector<char16_t> m_outBuf;
+	Utf8StreamState m_inState;
+	Utf16StreamState m_outState;
+}; // class Utf8Utf16StreamBuf
+
+} // namespace SimpleUtf
@@ -0,0 +1,298 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include "Utf8.hpp"
+#include "Utf16.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+/**
+ * @brief A string that is known to be valid UTF-8, since it can only be
+ *        constructed by validating its content; it also caches the number of
+ *        code points and whether it's all ASCII, which are found during the
+ *        validation.
+ *        The conversions in `Utf.hpp` take it without validating it again.
+ *
+ */
+class Utf8String
+{
+public:
+
+	using value_type = char;
+	using const_iterator = std::string::const_iterator;
+
+public:
+
+	Utf8String() :
+		m_str(),
+		m_numCodePts(0),
+		m_isAscii(true)
+	{}
+
+	/**
+	 * @brief Validates the given string, and takes it
+	 *
+	 * @exception UtfConversionException if the given string is not valid
+	 *            UTF-8
+	 */
+	explicit Utf8String(std::string str) :
+		m_str(std::move(str)),
+		m_numCodePts(0),
+		m_isAscii(true)
+	{
+		const char* begin = m_str.data();
+		const char* end = begin + m_str.size();
+		while (begin != end)
+		{
+			const size_t numAscii = Internal::CountAsciiPrefix(begin, end);
+			begin += numAscii;
+			m_numCodePts += numAscii;
+
+			if (begin != end)
+			{
+				begin = Utf8ToCodePtOnce(begin, end).second;
+				++m_numCodePts;
+				m_isAscii = false;
+			}
+		}
+	}
+
+	Utf8String(const Utf8String& other) = default;
+
+	Utf8String(Utf8String&& other) noexcept :
+		m_str(std::move(other.m_str)),
+		m_numCodePts(other.m_numCodePts),
+		m_isAscii(other.m_isAscii)
+	{
+		other.Reset();
+	}
+
+	~Utf8String() = default;
+
+	Utf8String& operator=(const Utf8String& other) = default;
+
+	Utf8String& operator=(Utf8String&& other) noexcept
+	{
+		if (this != &other)
+		{
+			m_str = std::move(other.m_str);
+			m_numCodePts = other.m_numCodePts;
+			m_isAscii = other.m_isAscii;
+			other.Reset();
+		}
+		return *this;
+	}
+
+	const std::string& Get() const
+	{
+		return m_str;
+	}
+
+	const char* data() const
+	{
+		return m_str.data();
+	}
+
+	size_t size() const
+	{
+		return m_str.size();
+	}
+
+	bool empty() const
+	{
+		return m_str.empty();
+	}
+
+	const_iterator begin() const
+	{
+		return m_str.begin();
+	}
+
+	const_iterator end() const
+	{
+		return m_str.end();
+	}
+
+	size_t GetNumCodePts() const
+	{
+		return m_numCodePts;
+	}
+
+	bool IsAscii() const
+	{
+		return m_isAscii;
+	}
+
+	/**
+	 * @brief Gives up the underlying string, and leaves this one empty
+	 *
+	 */
+	std::string Release()
+	{
+		std::string res = std::move(m_str);
+		Reset();
+		return res;
+	}
+
+private:
+
+	void Reset() noexcept
+	{
+		m_str.clear();
+		m_numCodePts = 0;
+		m_isAscii = true;
+	}
+
+	std::string m_str;
+	size_t m_numCodePts;
+	bool m_isAscii;
+}; // class Utf8String
+
+/**
+ * @brief A string that is known to be valid UTF-16; see `Utf8String`.
+ *
+ */
+class Utf16String
+{
+public:
+
+	using value_type = char16_t;
+	using const_iterator = std::u16string::const_iterator;
+
+public:
+
+	Utf16String() :
+		m_str(),
+		m_numCodePts(0),
+		m_isAscii(true)
+	{}
+
+	/**
+	 * @brief Validates the given string, and takes it
+	 *
+	 * @exception UtfConversionException if the given string is not valid
+	 *            UTF-16
+	 */
+	explicit Utf16String(std::u16string str) :
+		m_str(std::move(str)),
+		m_numCodePts(0),
+		m_isAscii(true)
+	{
+		const char16_t* begin = m_str.data();
+		const char16_t* end = begin + m_str.size();
+		while (begin != end)
+		{
+			if (*begin < 0x80U)
+			{
+				++begin;
+			}
+			else
+			{
+				begin = Utf16ToCodePtOnce(begin, end).second;
+				m_isAscii = false;
+			}
+			++m_numCodePts;
+		}
+	}
+
+	Utf16String(const Utf16String& other) = default;
+
+	Utf16String(Utf16String&& other) noexcept :
+		m_str(std::move(other.m_str)),
+		m_numCodePts(other.m_numCodePts),
+		m_isAscii(other.m_isAscii)
+	{
+		other.Reset();
+	}
+
+	~Utf16String() = default;
+
+	Utf16String& operator=(const Utf16String& other) = default;
+
+	Utf16String& operator=(Utf16String&& other) noexcept
+	{
+		if (this != &other)
+		{
+			m_str = std::move(other.m_str);
+			m_numCodePts = other.m_numCodePts;
+			m_isAscii = other.m_isAscii;
+			other.Reset();
+		}
+		return *this;
+	}
+
+	const std::u16string& Get() const
+	{
+		return m_str;
+	}
+
+	const char16_t* data() const
+	{
+		return m_str.data();
+	}
+
+	size_t size() const
+	{
+		return m_str.size();
+	}
+
+	bool empty() const
+	{
+		return m_str.empty();
+	}
+
+	const_iterator begin() const
+	{
+		return m_str.begin();
+	}
+
+	const_iterator end() const
+	{
+		return m_str.end();
+	}
+
+	size_t GetNumCodePts() const
+	{
+		return m_numCodePts;
+	}
+
+	bool IsAscii() const
+	{
+		return m_isAscii;
+	}
+
+	/**
+	 * @brief Gives up the underlying string, and leaves this one empty
+	 *
+	 */
+	std::u16string Release()
+	{
+		std::u16string res = std::move(m_str);
+		Reset();
+		return res;
+	}
+
+private:
+
+	void Reset() noexcept
+	{
+		m_str.clear();
+		m_numCodePts = 0;
+		m_isAscii = true;
+	}
+
+	std::u16string m_str;
+	size_t m_numCodePts;
+	bool m_isAscii;
+}; // class Utf16String
+
+} // namespace SimpleUtf
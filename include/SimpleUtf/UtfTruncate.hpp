@@ -0,0 +1,189 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include "Utf.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+// Truncating strings to a length limit without splitting a sequence.
+// The input must already be valid (e.g., checked by `ValidateUtf8`); only
+// the sequence at the cut is looked at, so invalid inputs are not detected.
+
+namespace Internal
+{
+
+/**
+ * @brief The number of UTF-16 code units needed by the UTF-8 sequence
+ *        starting with the given byte; 0 for continuation bytes.
+ *
+ */
+inline size_t Utf8ByteToUtf16Units(uint8_t uval)
+{
+	// 10xxxxxx
+	return ((uval & 0xC0U) == 0x80U) ? 0 :
+		// 11110xxx
+		((uval & 0xF0U) == 0xF0U) ? 2 : 1;
+}
+
+template<typename _ItType>
+inline _ItType TruncateUtf8ToUtf16UnitsImpl(
+	_ItType begin, _ItType end, size_t maxUnits, size_t numUnits)
+{
+	for (; begin != end; ++begin)
+	{
+		numUnits += Utf8ByteToUtf16Units(
+			static_cast<uint8_t>(BitCast2Unsigned(*begin)));
+		if (numUnits > maxUnits)
+		{
+			break;
+		}
+	}
+	return begin;
+}
+
+/**
+ * @brief The number of UTF-16 code units needed by the UTF-8 sequences
+ *        starting in the given 8 bytes.
+ *
+ */
+inline size_t Utf8WordToUtf16Units(uint64_t word)
+{
+	static constexpr uint64_t sk_ones = 0x0101010101010101ULL;
+	static constexpr uint64_t sk_highs = 0x8080808080808080ULL;
+
+	// the high bit of a byte is set if the byte is 10xxxxxx
+	const uint64_t cont = (word & ~(word << 1)) & sk_highs;
+	// the high bit of a byte is set if the byte is 1111xxxx
+	const uint64_t four =
+		(word & (word << 1) & (word << 2) & (word << 3)) & sk_highs;
+
+	// sum up the flags (at most 8), which end up in the highest byte
+	const size_t numCont = static_cast<size_t>(((cont >> 7) * sk_ones) >> 56);
+	const size_t numFour = static_cast<size_t>(((four >> 7) * sk_ones) >> 56);
+
+	return 8 - numCont + numFour;
+}
+
+} // namespace Internal
+
+// ==========  UTF-8, by bytes
+
+/**
+ * @brief Finds where to cut [begin, end), so that it's at most `maxBytes`
+ *        long, and no sequence is split; it takes constant time.
+ *
+ * @return the new end
+ */
+template<typename _ItType,
+	Internal::EnableIfT<Internal::IsRandomAccessIt<_ItType>::value, int> = 0>
+inline _ItType TruncateUtf8ToBytes(_ItType begin, _ItType end, size_t maxBytes)
+{
+	if (static_cast<size_t>(end - begin) <= maxBytes)
+	{
+		return end;
+	}
+
+	// the byte right after the cut is the beginning of a sequence, unless
+	// it's a continuation byte, in which case the whole sequence is cut off
+	return Internal::Utf8SeqBegin(begin, begin + maxBytes);
+}
+
+inline void TruncateUtf8ToBytes(std::string& str, size_t maxBytes)
+{
+	const char* begin = str.data();
+	str.resize(static_cast<size_t>(
+		TruncateUtf8ToBytes(begin, begin + str.size(), maxBytes) - begin));
+}
+
+// ==========  UTF-16, by code units
+
+/**
+ * @brief Finds where to cut [begin, end), so that it's at most `maxUnits`
+ *        code units long, and no surrogate pair is split; it takes constant
+ *        time.
+ *
+ * @return the new end
+ */
+template<typename _ItType,
+	Internal::EnableIfT<Internal::IsRandomAccessIt<_ItType>::value, int> = 0>
+inline _ItType TruncateUtf16ToUnits(_ItType begin, _ItType end, size_t maxUnits)
+{
+	if (static_cast<size_t>(end - begin) <= maxUnits)
+	{
+		return end;
+	}
+
+	return Internal::Utf16SeqBegin(begin, begin + maxUnits);
+}
+
+inline void TruncateUtf16ToUnits(std::u16string& str, size_t maxUnits)
+{
+	const char16_t* begin = str.data();
+	str.resize(static_cast<size_t>(
+		TruncateUtf16ToUnits(begin, begin + str.size(), maxUnits) - begin));
+}
+
+// ==========  UTF-8, by the length in UTF-16
+
+/**
+ * @brief Finds where to cut the UTF-8 string [begin, end), so that its
+ *        UTF-16 encoding is at most `maxUnits` code units long, without
+ *        converting it; no sequence is split.
+ *
+ * @return the new end
+ */
+template<typename _ItType>
+inline _ItType TruncateUtf8ToUtf16Units(
+	_ItType begin, _ItType end, size_t maxUnits)
+{
+	return Internal::TruncateUtf8ToUtf16UnitsImpl(begin, end, maxUnits, 0);
+}
+
+/**
+ * @brief `TruncateUtf8ToUtf16Units` for contiguous memory; the UTF-16
+ *        length is counted 8 bytes at a time (SWAR - SIMD within a
+ *        register), until the next 8 bytes may exceed the limit.
+ *
+ */
+template<typename _ValType,
+	Internal::EnableIfT<
+		Internal::IsIntegral<_ValType>::value &&
+		(sizeof(_ValType) == 1)
+		, int> = 0>
+inline const _ValType* TruncateUtf8ToUtf16Units(
+	const _ValType* begin, const _ValType* end, size_t maxUnits)
+{
+	size_t numUnits = 0;
+	// a word adds 16 units at most
+	while (((end - begin) >= 8) && (numUnits + 16 <= maxUnits))
+	{
+		uint64_t word = 0;
+		std::memcpy(&word, begin, sizeof(word));
+		numUnits += Internal::Utf8WordToUtf16Units(word);
+		begin += 8;
+	}
+
+	// the bytes counted above may end in the middle of a sequence, but its
+	// leading byte has been counted, and the rest count as 0
+	return Internal::TruncateUtf8ToUtf16UnitsImpl(
+		begin, end, maxUnits, numUnits);
+}
+
+inline void TruncateUtf8ToUtf16Units(std::string& str, size_t maxUnits)
+{
+	const char* begin = str.data();
+	str.resize(static_cast<size_t>(
+		TruncateUtf8ToUtf16Units(begin, begin + str.size(), maxUnits) -
+			begin));
+}
+
+} // namespace SimpleUtf
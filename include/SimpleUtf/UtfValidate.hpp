@@ -0,0 +1,354 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include <memory>
+
+#include "Utf8.hpp"
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+namespace SimpleUtf
+#else
+namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE
+#endif
+{
+
+class ValidatedUtf8View;
+
+namespace Internal
+{
+
+inline ValidatedUtf8View ValidateUtf8Impl(const char* begin, const char* end);
+
+inline ValidatedUtf8View ValidateUtf8ReplaceImpl(
+	const char* begin, const char* end);
+
+/**
+ * @brief Checks the UTF-8 sequence at `begin` without decoding it, by the
+ *        well-formed byte sequences in the Unicode standard (table 3-7);
+ *        it accepts the same sequences as `Utf8ToCodePtOnce`, but it never
+ *        throws.
+ *
+ * @return The end of the sequence, or `begin` if it's not valid
+ */
+template<typename _ValType>
+inline const _ValType* Utf8ValidSeqEnd(
+	const _ValType* begin, const _ValType* end)
+{
+	const size_t avail = static_cast<size_t>(end - begin);
+	const uint8_t leading = static_cast<uint8_t>(BitCast2Unsigned(*begin));
+
+	// the number of continuation bytes, and the range of the first one
+	size_t numCont = 0;
+	uint8_t contMin = 0x80U;
+	uint8_t contMax = 0xBFU;
+	if (leading < 0x80U)
+	{
+		return begin + 1;
+	}
+	else if ((0xC2U <= leading) && (leading <= 0xDFU))
+	{
+		numCont = 1;
+	}
+	else if ((0xE0U <= leading) && (leading <= 0xEFU))
+	{
+		numCont = 2;
+		// no overlong encoding, and no surrogates
+		contMin = (leading == 0xE0U) ? 0xA0U : 0x80U;
+		contMax = (leading == 0xEDU) ? 0x9FU : 0xBFU;
+	}
+	else if ((0xF0U <= leading) && (leading <= 0xF4U))
+	{
+		numCont = 3;
+		// no overlong encoding, and nothing above U+10FFFF
+		contMin = (leading == 0xF0U) ? 0x90U : 0x80U;
+		contMax = (leading == 0xF4U) ? 0x8FU : 0xBFU;
+	}
+	else
+	{
+		return begin;
+	}
+
+	if (avail <= numCont)
+	{
+		return begin;
+	}
+	for (size_t i = 1; i <= numCont; ++i)
+	{
+		const uint8_t cont = static_cast<uint8_t>(BitCast2Unsigned(begin[i]));
+		if ((cont < contMin) || (cont > contMax))
+		{
+			return begin;
+		}
+		contMin = 0x80U;
+		contMax = 0xBFU;
+	}
+	return begin + 1 + numCont;
+}
+
+/**
+ * @brief Finds the first invalid UTF-8 sequence in [begin, end)
+ *
+ * @return The beginning of the first invalid sequence, or `end` if the whole
+ *         input is valid
+ */
+template<typename _ValType>
+inline const _ValType* Utf8FindInvalid(
+	const _ValType* begin, const _ValType* end)
+{
+	while (begin != end)
+	{
+		begin += CountAsciiPrefix(begin, end);
+		if (begin == end)
+		{
+			break;
+		}
+
+		const _ValType* seqEnd = Utf8ValidSeqEnd(begin, end);
+		if (seqEnd == begin)
+		{
+			return begin;
+		}
+		begin = seqEnd;
+	}
+	return end;
+}
+
+/**
+ * @brief Skips the invalid sequence at `begin`, which is its first byte,
+ *        plus any continuation bytes following it
+ *
+ */
+template<typename _ValType>
+inline const _ValType* Utf8SkipInvalid(
+	const _ValType* begin, const _ValType* end)
+{
+	++begin;
+	while ((begin != end) &&
+		((BitCast2Unsigned(*begin) & 0xC0U) == 0x80U))
+	{
+		++begin;
+	}
+	return begin;
+}
+
+} // namespace Internal
+
+/**
+ * @brief A read-only view of a string that is known to be valid UTF-8.
+ *        It's either borrowed - pointing to the original storage, which
+ *        must outlive the view - or, if the original string had to be
+ *        repaired (see `ValidateUtf8Replace`), it shares the ownership of
+ *        the repaired copy.
+ *        It can only be created by `ValidateUtf8` and `ValidateUtf8Replace`.
+ *
+ */
+class ValidatedUtf8View
+{
+public:
+
+	using value_type = char;
+	using const_iterator = const char*;
+
+	friend ValidatedUtf8View Internal::ValidateUtf8Impl(
+		const char* begin, const char* end);
+	friend ValidatedUtf8View Internal::ValidateUtf8ReplaceImpl(
+		const char* begin, const char* end);
+
+public:
+
+	ValidatedUtf8View(const ValidatedUtf8View& other) = default;
+
+	ValidatedUtf8View& operator=(const ValidatedUtf8View& other) = default;
+
+	~ValidatedUtf8View() = default;
+
+	const char* data() const
+	{
+		return m_data;
+	}
+
+	size_t size() const
+	{
+		return m_size;
+	}
+
+	bool empty() const
+	{
+		return m_size == 0;
+	}
+
+	const_iterator begin() const
+	{
+		return m_data;
+	}
+
+	const_iterator end() const
+	{
+		return m_data + m_size;
+	}
+
+	/**
+	 * @brief Does this view point to the original storage (i.e., no repair
+	 *        was needed)?
+	 *
+	 */
+	bool IsBorrowed() const
+	{
+		return m_owned == nullptr;
+	}
+
+	std::string ToString() const
+	{
+		return std::string(m_data, m_size);
+	}
+
+#ifdef SIMPLEUTF_HAS_STRING_VIEW
+	std::string_view View() const
+	{
+		return std::string_view(m_data, m_size);
+	}
+#endif // SIMPLEUTF_HAS_STRING_VIEW
+
+private:
+
+	ValidatedUtf8View(const char* data, size_t size) :
+		m_owned(),
+		m_data(data),
+		m_size(size)
+	{}
+
+	explicit ValidatedUtf8View(std::shared_ptr<const std::string> owned) :
+		m_owned(std::move(owned)),
+		m_data(m_owned->data()),
+		m_size(m_owned->size())
+	{}
+
+	std::shared_ptr<const std::string> m_owned;
+	const char* m_data;
+	size_t m_size;
+}; // class ValidatedUtf8View
+
+/**
+ * @brief Checks if the given string is valid UTF-8, without converting it
+ *
+ */
+inline bool IsValidUtf8(Internal::StrInputT<char> str)
+{
+	const char* end = str.data() + str.size();
+	return Internal::Utf8FindInvalid(str.data(), end) == end;
+}
+
+namespace Internal
+{
+
+inline ValidatedUtf8View ValidateUtf8Impl(const char* begin, const char* end)
+{
+	const char* invalid = Utf8FindInvalid(begin, end);
+	if (invalid != end)
+	{
+		// re-decode to throw the specific exception
+		Utf8ToCodePtOnce(invalid, end);
+
+		// the decoder and `Utf8ValidSeqEnd` should agree; but never return
+		// a view over invalid bytes in case they don't
+		SIMPLEUTF_STATS_ADD(ErrInvalidEncoding, 1);
+		throw UtfConversionException("Invalid Encoding" " - "
+			"Invalid UTF-8 sequence.");
+	}
+
+	return ValidatedUtf8View(begin, static_cast<size_t>(end - begin));
+}
+
+inline ValidatedUtf8View ValidateUtf8ReplaceImpl(
+	const char* begin, const char* end)
+{
+	static constexpr char sk_replacement[] = "\xEF\xBF\xBD";
+
+	const size_t size = static_cast<size_t>(end - begin);
+	const char* invalid = Utf8FindInvalid(begin, end);
+	if (invalid == end)
+	{
+		return ValidatedUtf8View(begin, size);
+	}
+
+	std::shared_ptr<std::string> repaired = std::make_shared<std::string>();
+	repaired->reserve(size + 2);
+	while (invalid != end)
+	{
+		repaired->append(begin, invalid);
+		repaired->append(sk_replacement, sizeof(sk_replacement) - 1);
+
+		begin = Utf8SkipInvalid(invalid, end);
+		invalid = Utf8FindInvalid(begin, end);
+	}
+	repaired->append(begin, end);
+
+	return ValidatedUtf8View(
+		std::shared_ptr<const std::string>(std::move(repaired)));
+}
+
+} // namespace Internal
+
+/**
+ * @brief Validates the given UTF-8 string, and returns a view borrowing it;
+ *        no copy is made.
+ *
+ * @exception UtfConversionException if the given string is not valid UTF-8
+ */
+inline ValidatedUtf8View ValidateUtf8(Internal::StrInputT<char> str)
+{
+	return Internal::ValidateUtf8Impl(str.data(), str.data() + str.size());
+}
+
+/**
+ * @brief Validates the given null-terminated UTF-8 string; see above.
+ *
+ */
+inline ValidatedUtf8View ValidateUtf8(const char* str)
+{
+	return Internal::ValidateUtf8Impl(
+		str, str + std::char_traits<char>::length(str));
+}
+
+/**
+ * @brief The returned view would borrow a temporary string, which is gone
+ *        at the end of the full expression.
+ *
+ */
+ValidatedUtf8View ValidateUtf8(std::string&& str) = delete;
+
+/**
+ * @brief Validates the given UTF-8 string; if it's valid, a view borrowing
+ *        it is returned; otherwise, a repaired copy is made, where each
+ *        invalid sequence (together with the continuation bytes following
+ *        it) is replaced by U+FFFD, and the returned view owns the copy.
+ *
+ */
+inline ValidatedUtf8View ValidateUtf8Replace(Internal::StrInputT<char> str)
+{
+	return Internal::ValidateUtf8ReplaceImpl(
+		str.data(), str.data() + str.size());
+}
+
+/**
+ * @brief Validates the given null-terminated UTF-8 string; see above.
+ *
+ */
+inline ValidatedUtf8View ValidateUtf8Replace(const char* str)
+{
+	return Internal::ValidateUtf8ReplaceImpl(
+		str, str + std::char_traits<char>::length(str));
+}
+
+/**
+ * @brief The returned view may borrow a temporary string, which is gone at
+ *        the end of the full expression.
+ *
+ */
+ValidatedUtf8View ValidateUtf8Replace(std::string&& str) = delete;
+
+} // namespace SimpleUtf
@@ -0,0 +1,135 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <SimpleUtf/Cesu8.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+namespace
+{
+
+// "a\0" + U+00E9 + U+6D4B + U+1F602
+const std::string gk_utf8("a\0" "\xC3\xA9" "\xE6\xB5\x8B" "\xF0\x9F\x98\x82",
+	11);
+const std::string gk_cesu8("a\0" "\xC3\xA9" "\xE6\xB5\x8B"
+	"\xED\xA0\xBD" "\xED\xB8\x82", 13);
+const std::string gk_mutf8("a" "\xC0\x80" "\xC3\xA9" "\xE6\xB5\x8B"
+	"\xED\xA0\xBD" "\xED\xB8\x82", 14);
+const std::u16string gk_utf16({ 0x0061, 0x0000, 0x00e9, 0x6d4b, 0xd83d, 0xde02 });
+
+} // namespace
+
+GTEST_TEST(TestCesu8, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestCesu8, Cesu8)
+{
+	EXPECT_EQ(Utf8ToCesu8(gk_utf8), gk_cesu8);
+	EXPECT_EQ(Cesu8ToUtf8(gk_cesu8), gk_utf8);
+	EXPECT_EQ(Utf16ToCesu8(gk_utf16), gk_cesu8);
+	EXPECT_EQ(Cesu8ToUtf16(gk_cesu8), gk_utf16);
+
+	// the 4-byte form is not CESU-8
+	EXPECT_THROW(Cesu8ToUtf8("\xF0\x9F\x98\x82");, UtfConversionException);
+	// neither is C0 80
+	EXPECT_THROW(Cesu8ToUtf8("\xC0\x80");, UtfConversionException);
+	// unpaired surrogates
+	EXPECT_THROW(Cesu8ToUtf8("\xED\xA0\xBD" "a");, UtfConversionException);
+	EXPECT_THROW(Cesu8ToUtf8("\xED\xB8\x82");, UtfConversionException);
+	// overlong
+	EXPECT_THROW(Cesu8ToUtf8("\xE0\x80\xBF");, UtfConversionException);
+	EXPECT_THROW(Cesu8ToUtf8("\xE6\xB5");, UtfConversionException);
+
+	const std::string lone = "\xED\xA0\xBD" "a";
+	auto res = Cesu8ToCodePtOnce<std::string::const_iterator, WtfPolicy>(
+		lone.begin(), lone.end());
+	EXPECT_EQ(res.first, 0xd83dU);
+	EXPECT_EQ(res.second, lone.begin() + 3);
+
+	EXPECT_EQ(CodePtToCesu8OnceGetSize(0x1F602U), 6);
+	EXPECT_EQ(CodePtToCesu8OnceGetSize(0U), 1);
+
+	// the size follows the policy, as the encoder does
+	EXPECT_THROW(CodePtToCesu8OnceGetSize(0xd83dU);, UtfConversionException);
+	EXPECT_EQ(CodePtToCesu8OnceGetSize<WtfPolicy>(0xd83dU), 3);
+	EXPECT_EQ(CodePtToMutf8OnceGetSize<WtfPolicy>(0xdc00U), 3);
+}
+
+GTEST_TEST(TestCesu8, Mutf8)
+{
+	EXPECT_EQ(Utf8ToMutf8(gk_utf8), gk_mutf8);
+	EXPECT_EQ(Mutf8ToUtf8(gk_mutf8), gk_utf8);
+	EXPECT_EQ(CodePtToMutf8OnceGetSize(0U), 2);
+
+	// direct conversions with UTF-16
+	EXPECT_EQ(Utf16ToMutf8(gk_utf16), gk_mutf8);
+	EXPECT_EQ(Mutf8ToUtf16(gk_mutf8), gk_utf16);
+	EXPECT_EQ(Utf16ToMutf8GetSize(gk_utf16.begin(), gk_utf16.end()),
+		gk_mutf8.size());
+	EXPECT_EQ(Mutf8ToUtf16GetSize(gk_mutf8.begin(), gk_mutf8.end()),
+		gk_utf16.size());
+
+	std::u16string out;
+	Mutf8ToUtf16(gk_mutf8.begin(), gk_mutf8.end(), std::back_inserter(out));
+	EXPECT_EQ(out, gk_utf16);
+
+	out.clear();
+	Mutf8ToUtf16(gk_mutf8.data(), gk_mutf8.data() + gk_mutf8.size(),
+		std::back_inserter(out));
+	EXPECT_EQ(out, gk_utf16);
+
+	// unpaired surrogates are carried over, like in Java
+	const std::u16string lone = { 0xdc00, 0x0061, 0xd800 };
+	EXPECT_EQ(Mutf8ToUtf16(Utf16ToMutf8(lone)), lone);
+
+	EXPECT_THROW(Mutf8ToUtf16("\xF0\x9F\x98\x82");, UtfConversionException);
+	EXPECT_THROW(Mutf8ToUtf16("\xC1\x80");, UtfConversionException);
+	EXPECT_THROW(Mutf8ToUtf16("abc\xE6\xB5");, UtfConversionException);
+}
+
+#ifdef SIMPLEUTF_ENABLE_STATS
+
+GTEST_TEST(TestCesu8, Stats)
+{
+	// a high surrogate followed by something other than a low surrogate;
+	// each byte is counted once
+	const std::string lone = "\xED\xA0\xBD" "\xC3\xA9";
+	std::u32string out;
+	ResetUtfStats();
+	UtfConvert(Cesu8ToCodePtOnce<std::string::const_iterator, WtfPolicy>,
+		CodePtToUtf32Once<std::back_insert_iterator<std::u32string>,
+			WtfPolicy>,
+		lone.begin(), lone.end(), std::back_inserter(out));
+	EXPECT_EQ(out, std::u32string(U"\xD83D\u00E9", 2));
+	EXPECT_EQ(GetUtfStats().Get(UtfStatsCounter::BytesIn), lone.size());
+
+	// pointers to bytes take the ASCII fast path, other iterators don't
+	const std::string mutf8 = "0123456789\xC3\xA9";
+	char16_t buf[16];
+	ResetUtfStats();
+	char16_t* bufEnd =
+		Mutf8ToUtf16(mutf8.data(), mutf8.data() + mutf8.size(), buf);
+	EXPECT_EQ(GetUtfStats().Get(UtfStatsCounter::AsciiFastPathBytes), 10);
+	EXPECT_EQ(std::u16string(buf, bufEnd), Mutf8ToUtf16(mutf8));
+
+	ResetUtfStats();
+	Mutf8ToUtf16(mutf8.begin(), mutf8.end(), buf);
+	EXPECT_EQ(GetUtfStats().Get(UtfStatsCounter::AsciiFastPathBytes), 0);
+}
+
+#endif // SIMPLEUTF_ENABLE_STATS
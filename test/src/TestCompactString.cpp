@@ -0,0 +1,185 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <SimpleUtf/CompactString.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+GTEST_TEST(TestCompactString, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestCompactString, Storage)
+{
+	EXPECT_EQ(CompactString().GetStorage(), CompactStorage::Latin1);
+	EXPECT_EQ(CompactString(std::string()).GetStorage(),
+		CompactStorage::Latin1);
+
+	// UTF-8, with the widest code point at the head, in the middle of a
+	// word, and in the tail
+	const std::string ascii = "abcdefghijklmnopq";
+	for (size_t pos = 0; pos <= ascii.size(); pos += 3)
+	{
+		std::string str = ascii;
+
+		str.insert(pos, "\xC3\xA9"); // U+00E9
+		EXPECT_EQ(CompactString(str).GetStorage(), CompactStorage::Latin1);
+		str.insert(pos, "\xC4\x80"); // U+0100
+		EXPECT_EQ(CompactString(str).GetStorage(), CompactStorage::Ucs2);
+		str.insert(pos, "\xE4\xB8\xAD"); // U+4E2D
+		EXPECT_EQ(CompactString(str).GetStorage(), CompactStorage::Ucs2);
+		str.insert(pos, "\xF0\x9F\x98\x80"); // U+1F600
+		EXPECT_EQ(CompactString(str).GetStorage(), CompactStorage::Utf32);
+	}
+
+	// UTF-16
+	const std::u16string ascii16 = u"abcdefghijklmnopq";
+	for (size_t pos = 0; pos <= ascii16.size(); pos += 3)
+	{
+		std::u16string str = ascii16;
+
+		str.insert(pos, u"\u00FF");
+		EXPECT_EQ(CompactString(str).GetStorage(), CompactStorage::Latin1);
+		str.insert(pos, u"\uFFFD");
+		EXPECT_EQ(CompactString(str).GetStorage(), CompactStorage::Ucs2);
+		str.insert(pos, u"\U0001F600");
+		EXPECT_EQ(CompactString(str).GetStorage(), CompactStorage::Utf32);
+	}
+
+	// UTF-32
+	EXPECT_EQ(CompactString(std::u32string(U"abc\u00FF")).GetStorage(),
+		CompactStorage::Latin1);
+	EXPECT_EQ(CompactString(std::u32string(U"abc\u0100")).GetStorage(),
+		CompactStorage::Ucs2);
+	EXPECT_EQ(CompactString(std::u32string(U"abc\U00010000")).GetStorage(),
+		CompactStorage::Utf32);
+}
+
+GTEST_TEST(TestCompactString, Indexing)
+{
+	const CompactString latin1(std::string("caf\xC3\xA9!"));
+	EXPECT_EQ(latin1.GetSize(), 5);
+	EXPECT_EQ(latin1.GetStorageSize(), 5);
+	EXPECT_EQ(latin1[0], U'c');
+	EXPECT_EQ(latin1[3], U'\u00E9');
+	EXPECT_EQ(latin1[4], U'!');
+
+	const CompactString ucs2(std::u16string(u"a\u4E2D\u00E9"));
+	EXPECT_EQ(ucs2.GetSize(), 3);
+	EXPECT_EQ(ucs2.GetStorageSize(), 6);
+	EXPECT_EQ(ucs2[1], U'\u4E2D');
+	EXPECT_EQ(ucs2[2], U'\u00E9');
+
+	const CompactString utf32(std::string("a\xF0\x9F\x98\x80z"));
+	EXPECT_EQ(utf32.GetSize(), 3);
+	EXPECT_EQ(utf32.GetStorageSize(), 12);
+	EXPECT_EQ(utf32[1], U'\U0001F600');
+	EXPECT_EQ(utf32[2], U'z');
+}
+
+GTEST_TEST(TestCompactString, Conversions)
+{
+	const std::u32string testStrs[] = {
+		U"",
+		U"Hello, world!",
+		std::u32string(U"\u0000\u007F\u0080\u00FF", 4),
+		U"Latin-1: caf\u00E9, na\u00EFve, \u00BFqu\u00E9?",
+		U"UCS-2: \u0100\u07FF\u0800\u4E2D\u6587\uFFFD\uFFFF",
+		U"UTF-32: \U00010000\U0001F600\U0010FFFF\u00E9\u4E2D",
+	};
+
+	for (const std::u32string& testStr : testStrs)
+	{
+		const std::string utf8 = Utf32ToUtf8(testStr);
+		const std::u16string utf16 = Utf32ToUtf16(testStr);
+
+		const CompactString fromUtf8(utf8);
+		const CompactString fromUtf16(utf16);
+		const CompactString fromUtf32(testStr);
+		EXPECT_EQ(fromUtf8.GetStorage(), fromUtf32.GetStorage());
+		EXPECT_EQ(fromUtf16.GetStorage(), fromUtf32.GetStorage());
+
+		for (const CompactString* str : { &fromUtf8, &fromUtf16, &fromUtf32 })
+		{
+			EXPECT_EQ(str->GetSize(), testStr.size());
+			EXPECT_EQ(str->ToUtf8(), utf8);
+			EXPECT_EQ(str->ToUtf16(), utf16);
+			EXPECT_EQ(str->ToUtf32(), testStr);
+			for (size_t i = 0; i < testStr.size(); ++i)
+			{
+				EXPECT_EQ((*str)[i], testStr[i]);
+			}
+		}
+	}
+}
+
+GTEST_TEST(TestCompactString, CopyAndMove)
+{
+	CompactString latin1(std::string("caf\xC3\xA9"));
+	CompactString utf32(std::u16string(u"\U0001F600!"));
+
+	CompactString copy(latin1);
+	EXPECT_EQ(copy.GetStorage(), CompactStorage::Latin1);
+	EXPECT_EQ(copy.ToUtf8(), latin1.ToUtf8());
+
+	copy = utf32;
+	EXPECT_EQ(copy.GetStorage(), CompactStorage::Utf32);
+	EXPECT_EQ(copy.ToUtf16(), u"\U0001F600!");
+
+	const CompactString& self = copy;
+	copy = self;
+	EXPECT_EQ(copy.ToUtf16(), u"\U0001F600!");
+
+	CompactString moved(std::move(copy));
+	EXPECT_EQ(moved.GetStorage(), CompactStorage::Utf32);
+	EXPECT_EQ(moved.ToUtf16(), u"\U0001F600!");
+
+	moved = CompactString(std::u16string(u"\u4E2D"));
+	EXPECT_EQ(moved.GetStorage(), CompactStorage::Ucs2);
+	EXPECT_EQ(moved[0], U'\u4E2D');
+}
+
+GTEST_TEST(TestCompactString, Invalid)
+{
+	// UTF-8
+	EXPECT_THROW(CompactString(std::string("abc\xC3")),
+		UtfConversionException);
+	EXPECT_THROW(CompactString(std::string("abc\xC3(")),
+		UtfConversionException);
+	EXPECT_THROW(CompactString(std::string("abc\xC0\x80")),
+		UtfConversionException);
+	EXPECT_THROW(CompactString(std::string("abc\xE4\xB8")),
+		UtfConversionException);
+	EXPECT_THROW(CompactString(std::string("abc\xED\xA0\x80")),
+		UtfConversionException);
+	EXPECT_THROW(CompactString(std::string("abc\xF0\x9F\x98")),
+		UtfConversionException);
+	EXPECT_THROW(CompactString(std::string("abcdefghi\xFF")),
+		UtfConversionException);
+
+	// UTF-16
+	EXPECT_THROW(CompactString(std::u16string(1, char16_t(0xD800))),
+		UtfConversionException);
+	EXPECT_THROW(CompactString(std::u16string(u"abcdefg") + char16_t(0xDC00)),
+		UtfConversionException);
+
+	// UTF-32
+	EXPECT_THROW(CompactString(std::u32string(1, char32_t(0x110000))),
+		UtfConversionException);
+	EXPECT_THROW(CompactString(std::u32string(1, char32_t(0xD800))),
+		UtfConversionException);
+}
@@ -0,0 +1,122 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <SimpleUtf/Json.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+GTEST_TEST(TestJson, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestJson, Unescape)
+{
+	EXPECT_EQ(JsonUnescapeToUtf8(""), "");
+	EXPECT_EQ(JsonUnescapeToUtf8("a long run of plain ASCII characters"),
+		"a long run of plain ASCII characters");
+	EXPECT_EQ(JsonUnescapeToUtf8(
+		"\\\"quoted\\\" \\\\ \\/ \\b\\f\\n\\r\\t"),
+		"\"quoted\" \\ / \b\f\n\r\t");
+	EXPECT_EQ(JsonUnescapeToUtf8("\\u0041\\u00e9\\u6D4B"),
+		"A\xC3\xA9\xE6\xB5\x8B");
+	EXPECT_EQ(JsonUnescapeToUtf8("x\\u0000y"), std::string("x\0y", 3));
+	// surrogate pairs, escaped and raw
+	EXPECT_EQ(JsonUnescapeToUtf8("smile \\ud83d\\ude02 \xF0\x9F\x98\x82!"),
+		"smile \xF0\x9F\x98\x82 \xF0\x9F\x98\x82!");
+
+	std::string out;
+	const std::string in = "abc\\n\xE6\xB5\x8B";
+	JsonUnescapeToUtf8(in.begin(), in.end(), std::back_inserter(out));
+	EXPECT_EQ(out, "abc\n\xE6\xB5\x8B");
+
+	// invalid JSON strings
+	EXPECT_THROW(JsonUnescapeToUtf8("a\"b");, UtfConversionException);
+	EXPECT_THROW(JsonUnescapeToUtf8("a\nb");, UtfConversionException);
+	EXPECT_THROW(JsonUnescapeToUtf8("a\\");, UtfConversionException);
+	EXPECT_THROW(JsonUnescapeToUtf8("a\\x");, UtfConversionException);
+	EXPECT_THROW(JsonUnescapeToUtf8("\\u12");, UtfConversionException);
+	EXPECT_THROW(JsonUnescapeToUtf8("\\u12g4");, UtfConversionException);
+	// invalid UTF-8
+	EXPECT_THROW(JsonUnescapeToUtf8("abcdefgh\xFF");, UtfConversionException);
+	EXPECT_THROW(JsonUnescapeToUtf8("\xE6\xB5");, UtfConversionException);
+	// unpaired surrogates
+	EXPECT_THROW(JsonUnescapeToUtf8("\\ud83d");, UtfConversionException);
+	EXPECT_THROW(JsonUnescapeToUtf8("\\ud83dx");, UtfConversionException);
+	EXPECT_THROW(JsonUnescapeToUtf8("\\ud83d\\n");, UtfConversionException);
+	EXPECT_THROW(JsonUnescapeToUtf8("\\ud83d\\u0041");,
+		UtfConversionException);
+	EXPECT_THROW(JsonUnescapeToUtf8("\\ude02");, UtfConversionException);
+
+	// which are kept as WTF-8 under WtfPolicy
+	const std::string lone = "\\ud83d\\ud83d\\ude02";
+	out.clear();
+	JsonUnescapeToUtf8<std::string::const_iterator,
+		std::back_insert_iterator<std::string>, WtfPolicy>(
+			lone.begin(), lone.end(), std::back_inserter(out));
+	EXPECT_EQ(out, "\xED\xA0\xBD" "\xF0\x9F\x98\x82");
+}
+
+GTEST_TEST(TestJson, Escape)
+{
+	EXPECT_EQ(Utf8ToJsonEscaped(""), "");
+	EXPECT_EQ(Utf8ToJsonEscaped("a long run of plain ASCII characters"),
+		"a long run of plain ASCII characters");
+	EXPECT_EQ(Utf8ToJsonEscaped("\"quoted\" \\ / \b\f\n\r\t"),
+		"\\\"quoted\\\" \\\\ / \\b\\f\\n\\r\\t");
+	EXPECT_EQ(Utf8ToJsonEscaped(std::string("x\0\x1F\x7Fy", 5)),
+		"x\\u0000\\u001f\x7Fy");
+
+	const std::string utf8 = "caf\xC3\xA9 \xE6\xB5\x8B \xF0\x9F\x98\x82";
+	EXPECT_EQ(Utf8ToJsonEscaped(utf8), utf8);
+	EXPECT_EQ(Utf8ToJsonEscaped(utf8, true),
+		"caf\\u00e9 \\u6d4b \\ud83d\\ude02");
+
+	std::string out;
+	Utf8ToJsonEscaped(utf8, out, true);
+	EXPECT_EQ(JsonUnescapeToUtf8(out), utf8);
+
+	// invalid UTF-8
+	EXPECT_THROW(Utf8ToJsonEscaped("abcdefgh\xFF");, UtfConversionException);
+	EXPECT_THROW(Utf8ToJsonEscaped("\xE6\xB5");, UtfConversionException);
+	EXPECT_THROW(Utf8ToJsonEscaped("\xC0\x80");, UtfConversionException);
+
+	// every byte value at every position of a SWAR word
+	for (size_t pos = 0; pos < 16; ++pos)
+	{
+		for (unsigned int b = 0; b < 0x80U; ++b)
+		{
+			std::string in(16, 'a');
+			in[pos] = static_cast<char>(b);
+			EXPECT_EQ(JsonUnescapeToUtf8(Utf8ToJsonEscaped(in)), in);
+		}
+	}
+}
+
+#ifdef SIMPLEUTF_ENABLE_STATS
+
+GTEST_TEST(TestJson, ErrorStats)
+{
+	ResetUtfStats();
+	EXPECT_THROW(JsonUnescapeToUtf8("\\u12g4");, UtfConversionException);
+	EXPECT_EQ(GetUtfStats().Get(UtfStatsCounter::ErrInvalidEncoding), 1);
+
+	ResetUtfStats();
+	EXPECT_THROW(JsonUnescapeToUtf8("\\u12");, UtfConversionException);
+	EXPECT_EQ(GetUtfStats().Get(UtfStatsCounter::ErrUnexpectedEnding), 1);
+}
+
+#endif // SIMPLEUTF_ENABLE_STATS
@@ -0,0 +1,108 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <SimpleUtf/Percent.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+GTEST_TEST(TestPercent, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestPercent, Decode)
+{
+	EXPECT_EQ(PercentDecodeUtf8(""), "");
+	EXPECT_EQ(PercentDecodeUtf8("/a/long/path/with/no/escapes"),
+		"/a/long/path/with/no/escapes");
+	EXPECT_EQ(PercentDecodeUtf8("a%20b%2fc%2F%25"), "a b/c/%");
+	EXPECT_EQ(PercentDecodeUtf8("caf%C3%A9"), "caf\xC3\xA9");
+	// raw and escaped bytes mixed in a sequence
+	EXPECT_EQ(PercentDecodeUtf8("%E6\xB5%8B-%F0%9F%98%82"),
+		"\xE6\xB5\x8B-\xF0\x9F\x98\x82");
+
+	EXPECT_EQ(PercentDecodeUtf8("a+b%2B"), "a+b+");
+	EXPECT_EQ(PercentDecodeUtf8("a+b%2B", true), "a b+");
+
+	std::string out;
+	const std::string in = "q=%E6%B5%8B%E8%AF%95";
+	PercentDecodeUtf8(in.begin(), in.end(), std::back_inserter(out));
+	EXPECT_EQ(out, "q=\xE6\xB5\x8B\xE8\xAF\x95");
+
+	// malformed escapes
+	EXPECT_THROW(PercentDecodeUtf8("abc%");, UtfConversionException);
+	EXPECT_THROW(PercentDecodeUtf8("abc%2");, UtfConversionException);
+	EXPECT_THROW(PercentDecodeUtf8("abc%2G");, UtfConversionException);
+	// invalid UTF-8 after decoding
+	EXPECT_THROW(PercentDecodeUtf8("abcdefgh%FF");, UtfConversionException);
+	EXPECT_THROW(PercentDecodeUtf8("%C0%80");, UtfConversionException);
+	EXPECT_THROW(PercentDecodeUtf8("%E6%B5");, UtfConversionException);
+	EXPECT_THROW(PercentDecodeUtf8("%E6%B5a");, UtfConversionException);
+	EXPECT_THROW(PercentDecodeUtf8("%ED%A0%BD");, UtfConversionException);
+	EXPECT_THROW(PercentDecodeUtf8("\xE6\xB5");, UtfConversionException);
+}
+
+GTEST_TEST(TestPercent, Encode)
+{
+	EXPECT_EQ(PercentEncodeUtf8(""), "");
+	EXPECT_EQ(PercentEncodeUtf8("AZaz09-._~"), "AZaz09-._~");
+	EXPECT_EQ(PercentEncodeUtf8("a b/c?d=%"), "a%20b%2Fc%3Fd%3D%25");
+	EXPECT_EQ(PercentEncodeUtf8("a b+", true), "a+b%2B");
+
+	const std::string utf8 = "caf\xC3\xA9 \xE6\xB5\x8B \xF0\x9F\x98\x82";
+	const std::string encoded =
+		"caf%C3%A9%20%E6%B5%8B%20%F0%9F%98%82";
+	EXPECT_EQ(PercentEncodeUtf8(utf8), encoded);
+	EXPECT_EQ(PercentEncodeUtf8(Utf8ToUtf16(utf8)), encoded);
+	EXPECT_EQ(PercentDecodeUtf8(encoded), utf8);
+
+	std::string out;
+	const std::u16string utf16 = Utf8ToUtf16(utf8);
+	PercentEncodeUtf8(utf16.begin(), utf16.end(), std::back_inserter(out));
+	EXPECT_EQ(out, encoded);
+
+	EXPECT_THROW(PercentEncodeUtf8("abc\xFF");, UtfConversionException);
+	EXPECT_THROW(PercentEncodeUtf8(std::u16string(1, u'\xD800'));,
+		UtfConversionException);
+
+	// every byte value at every position of a SWAR word
+	for (size_t pos = 0; pos < 16; ++pos)
+	{
+		for (unsigned int b = 0; b < 0x80U; ++b)
+		{
+			std::string in(16, 'a');
+			in[pos] = static_cast<char>(b);
+			EXPECT_EQ(PercentDecodeUtf8(PercentEncodeUtf8(in)), in);
+			EXPECT_EQ(PercentDecodeUtf8(PercentEncodeUtf8(in, true), true),
+				in);
+		}
+	}
+}
+
+#ifdef SIMPLEUTF_ENABLE_STATS
+
+GTEST_TEST(TestPercent, ErrorStats)
+{
+	ResetUtfStats();
+	EXPECT_THROW(PercentDecodeUtf8("abc%2G");, UtfConversionException);
+	EXPECT_EQ(GetUtfStats().Get(UtfStatsCounter::ErrInvalidEncoding), 1);
+
+	ResetUtfStats();
+	EXPECT_THROW(PercentDecodeUtf8("abc%2");, UtfConversionException);
+	EXPECT_EQ(GetUtfStats().Get(UtfStatsCounter::ErrUnexpectedEnding), 1);
+}
+
+#endif // SIMPLEUTF_ENABLE_STATS
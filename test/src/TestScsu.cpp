@@ -0,0 +1,137 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <SimpleUtf/Scsu.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+namespace
+{
+
+void ExpectRoundTrip(const std::u16string& utf16)
+{
+	const std::string utf8 = Utf16ToUtf8(utf16);
+
+	const std::string scsu = Utf16ToScsu(utf16);
+	EXPECT_EQ(Utf8ToScsu(utf8), scsu);
+	EXPECT_EQ(ScsuToUtf16(scsu), utf16);
+	EXPECT_EQ(ScsuToUtf8(scsu), utf8);
+
+	EXPECT_EQ(Utf16ToScsuGetSize(utf16.begin(), utf16.end()), scsu.size());
+	EXPECT_EQ(Utf8ToScsuGetSize(utf8.begin(), utf8.end()), scsu.size());
+	EXPECT_EQ(ScsuToUtf16GetSize(scsu.begin(), scsu.end()), utf16.size());
+	EXPECT_EQ(ScsuToUtf8GetSize(scsu.begin(), scsu.end()), utf8.size());
+}
+
+} // namespace
+
+GTEST_TEST(TestScsu, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestScsu, Examples)
+{
+	// the examples in UTS #6
+
+	// German, in the initial window at 0x0080
+	const std::u16string german = u"\u00D6l flie\u00DFt";
+	const std::string germanScsu = "\xD6\x6C\x20\x66\x6C\x69\x65\xDF\x74";
+	EXPECT_EQ(Utf16ToScsu(german), germanScsu);
+	EXPECT_EQ(ScsuToUtf16(germanScsu), german);
+
+	// Russian, in the initial window at 0x0400
+	const std::u16string russian = u"\u041C\u043E\u0441\u043A\u0432\u0430";
+	const std::string russianScsu = "\x12\x9C\xBE\xC1\xBA\xB2\xB0";
+	EXPECT_EQ(Utf16ToScsu(russian), russianScsu);
+	EXPECT_EQ(ScsuToUtf16(russianScsu), russian);
+
+	// Japanese, with windows defined, and the Unicode mode
+	const std::u16string japanese =
+		u"\u3000\u266A\u30EA\u30F3\u30B4\u53EF\u611B\u3044\u3084"
+		u"\u53EF\u611B\u3044\u3084\u30EA\u30F3\u30B4\u3002";
+	const char japaneseScsuBytes[] =
+		"\x08\x00\x1B\x4C\xEA\x16\xCA\xD3\x94\x0F\x53\xEF\x61\x1B\xE5\x84"
+		"\xC4\x0F\x53\xEF\x61\x1B\xE5\x84\xC4\x16\xCA\xD3\x94\x08\x02";
+	const std::string japaneseScsu(
+		japaneseScsuBytes, sizeof(japaneseScsuBytes) - 1);
+	EXPECT_EQ(ScsuToUtf16(japaneseScsu), japanese);
+	ExpectRoundTrip(japanese);
+}
+
+GTEST_TEST(TestScsu, RoundTrip)
+{
+	ExpectRoundTrip(u"");
+	ExpectRoundTrip(u"plain ASCII\r\n\twith controls \x01\x1F");
+	// Greek, in a window at a special offset
+	ExpectRoundTrip(u"\u039A\u03B1\u03BB\u03B7\u03BC\u03AD\u03C1\u03B1 "
+		u"\u03BA\u03CC\u03C3\u03BC\u03B5");
+	// Latin Extended-A, punctuation in the static windows
+	ExpectRoundTrip(u"Za\u017C\u00F3\u0142\u0107 \u2014 g\u0119\u015Bl\u0105 "
+		u"\u201Cja\u017A\u0144\u201D");
+	// Chinese and Korean, with ASCII in between
+	ExpectRoundTrip(u"\u6D4B\u8BD5 test \u6D4B\u8BD5\u3002 "
+		u"\uC548\uB155\uD558\uC138\uC694 a\uD55C");
+	// supplementary characters, in extended windows
+	ExpectRoundTrip(u"emoji \U0001F602\U0001F603 and \U00020000\u6D4B"
+		u"\U0001F602");
+	// private use characters that collide with Unicode mode tags
+	ExpectRoundTrip(u"\u6D4B\uE000\uF2FF\uE7FF\u6D4B\uF100");
+	// many windows, so they have to be redefined
+	std::u16string scripts;
+	for (char16_t block = 0x0100U; block < 0x2000U; block += 0x80U)
+	{
+		scripts.push_back(static_cast<char16_t>(block + 0x05U));
+		scripts.push_back(static_cast<char16_t>(block + 0x06U));
+	}
+	ExpectRoundTrip(scripts);
+}
+
+GTEST_TEST(TestScsu, Size)
+{
+	// one byte per character, plus a window change
+	const std::u16string greek =
+		u"\u039A\u03B1\u03BB\u03B7\u03BC\u03AD\u03C1\u03B1";
+	EXPECT_EQ(Utf16ToScsu(greek).size(), greek.size() + 2);
+
+	// two bytes per character, plus a mode change
+	const std::u16string chinese = u"\u6D4B\u8BD5\u6D4B\u8BD5\u6D4B\u8BD5";
+	EXPECT_EQ(Utf16ToScsu(chinese).size(), 2 * chinese.size() + 1);
+}
+
+GTEST_TEST(TestScsu, Invalid)
+{
+	// tags at the end are allowed
+	EXPECT_EQ(ScsuToUtf16("a\x12"), u"a");
+
+	// truncated
+	EXPECT_THROW(ScsuToUtf16("\x0E\x41");, UtfConversionException);
+	EXPECT_THROW(ScsuToUtf16("\x0F\x41");, UtfConversionException);
+	EXPECT_THROW(ScsuToUtf16("\x01");, UtfConversionException);
+	// reserved tags and window offsets
+	EXPECT_THROW(ScsuToUtf16("\x0C");, UtfConversionException);
+	EXPECT_THROW(ScsuToUtf16("\x0F\xF2");, UtfConversionException);
+	EXPECT_THROW(ScsuToUtf16(std::string("\x18\x00\x80", 3));,
+		UtfConversionException);
+	EXPECT_THROW(ScsuToUtf16("\x18\xA8\x80");, UtfConversionException);
+	// unpaired surrogates
+	EXPECT_THROW(ScsuToUtf16(std::string("\x0E\xD8\x00" "a", 4));,
+		UtfConversionException);
+	EXPECT_THROW(ScsuToUtf16(std::string("\x0E\xDC\x00", 3));,
+		UtfConversionException);
+	// a surrogate pair quoted in two parts
+	EXPECT_EQ(ScsuToUtf16("\x0E\xD8\x3D\x0E\xDE\x02"), u"\U0001F602");
+}
@@ -5,6 +5,9 @@
 
 #include <gtest/gtest.h>
 
+#include <list>
+#include <vector>
+
 #ifdef _MSC_VER
 #include <windows.h>
 #endif // _MSC_VER
@@ -218,6 +221,53 @@ GTEST_TEST(TestUtf, Utf8ToCodePt)
 	}
 }
 
+GTEST_TEST(TestUtf, Utf8PrevCodePt)
+{
+	constexpr size_t numMap = sizeof(gk_Utf8MapBegins) / sizeof(char32_t);
+	constexpr size_t numPerMap = (sizeof(gk_Utf8Map) / (4 * sizeof(char))) / numMap;
+
+	for (size_t i = 0; i < numMap; ++i)
+	{
+		char32_t begin = gk_Utf8MapBegins[i];
+		for (size_t j = 0; j < numPerMap; ++j)
+		{
+			char32_t codePt = begin + static_cast<char32_t>(j);
+
+			if (Internal::IsValidCodePt(codePt))
+			{
+				const char* ptr = reinterpret_cast<const char*>(gk_Utf8Map[i][j]);
+				const uint8_t* uptr = reinterpret_cast<const uint8_t*>(ptr);
+				size_t len = uptr[1] == 0 ? 1 : (uptr[2] == 0 ? 2 : (uptr[3] == 0 ? 3 : 4));
+				// preceded by an ASCII character
+				std::string utf8 = std::string("a") + std::string(ptr, len);
+
+				auto res = Utf8PrevCodePt(utf8.begin(), utf8.end());
+				EXPECT_EQ(res.first, codePt);
+				EXPECT_EQ(res.second, utf8.begin() + 1);
+			}
+		}
+	}
+
+	auto prev = [](const std::string& str)
+	{
+		return Utf8PrevCodePt(str.data(), str.data() + str.size());
+	};
+	// nothing before
+	EXPECT_THROW(prev("");, UtfConversionException);
+	// stray continuation bytes
+	EXPECT_THROW(prev("\x80");, UtfConversionException);
+	EXPECT_THROW(prev("a\xA9");, UtfConversionException);
+	EXPECT_THROW(prev("\xC3\xA9\xA9");, UtfConversionException);
+	EXPECT_THROW(prev("\xF0\x9F\x98\x82\x82");, UtfConversionException);
+	// cut sequence
+	EXPECT_THROW(prev("\xE6\xB5");, UtfConversionException);
+	// overlong and surrogates
+	EXPECT_THROW(prev("\xC0\x80");, UtfConversionException);
+	EXPECT_THROW(prev("\xED\xA0\xBD");, UtfConversionException);
+	EXPECT_EQ((Utf8PrevCodePt<const char*, WtfPolicy>(
+		"\xED\xA0\xBD", "\xED\xA0\xBD" + 3).first), 0xD83DU);
+}
+
 GTEST_TEST(TestUtf, CodePtToUtf16)
 {
 	constexpr size_t maxNumErr = 10;
@@ -318,6 +368,50 @@ GTEST_TEST(TestUtf, Utf16ToCodePt)
 	}
 }
 
+GTEST_TEST(TestUtf, Utf16PrevCodePt)
+{
+	constexpr size_t numMap = sizeof(gk_Utf16MapBegins) / sizeof(char32_t);
+	constexpr size_t numPerMap = (sizeof(gk_Utf16Map) / (4 * sizeof(char))) / numMap;
+
+	for (size_t i = 0; i < numMap; ++i)
+	{
+		char32_t begin = gk_Utf16MapBegins[i];
+		for (size_t j = 0; j < numPerMap; ++j)
+		{
+			char32_t codePt = begin + static_cast<char32_t>(j);
+
+			if (Internal::IsValidCodePt(codePt))
+			{
+				const uint16_t* ptr = reinterpret_cast<const uint16_t*>(gk_Utf16Map[i][j]);
+				size_t len = ptr[1] == 0 ? 1 : 2;
+				std::vector<uint16_t> utf16(1, 0x61U);
+				utf16.insert(utf16.end(), ptr, ptr + len);
+
+				auto res = Utf16PrevCodePt(utf16.begin(), utf16.end());
+				EXPECT_EQ(res.first, codePt);
+				EXPECT_EQ(res.second, utf16.begin() + 1);
+			}
+		}
+	}
+
+	auto prev = [](const std::u16string& str)
+	{
+		return Utf16PrevCodePt(str.data(), str.data() + str.size());
+	};
+	EXPECT_THROW(prev(u"");, UtfConversionException);
+	// unpaired surrogates
+	EXPECT_THROW(prev(std::u16string({ 0x61, 0xDE02 }));, UtfConversionException);
+	EXPECT_THROW(prev(std::u16string({ 0xDE02 }));, UtfConversionException);
+	EXPECT_THROW(prev(std::u16string({ 0xDE02, 0xDE02 }));, UtfConversionException);
+	EXPECT_THROW(prev(std::u16string({ 0x61, 0xD83D }));, UtfConversionException);
+
+	const std::u16string lone({ 0x61, 0xDE02 });
+	auto res = Utf16PrevCodePt<const char16_t*, WtfPolicy>(
+		lone.data(), lone.data() + lone.size());
+	EXPECT_EQ(res.first, 0xDE02U);
+	EXPECT_EQ(res.second, lone.data() + 1);
+}
+
 GTEST_TEST(TestUtf, CodePtToUtf32)
 {
 	constexpr size_t maxNumErr = 10;
@@ -676,3 +770,319 @@ GTEST_TEST(TestUtf, Conversion)
 		}
 	}
 }
+
+GTEST_TEST(TestUtf, ConversionReuseOutput)
+{
+	const std::string testUtf8 = "\xF0\x9F\x98\x82 \xE6\xB5\x8B\xE8\xAF\x95";
+	const std::u16string testUtf16 = {0xd83d, 0xde02, 0x0020, 0x6d4b, 0x8bd5};
+	const std::u32string testUtf32 = {0x0001f602, 0x00000020, 0x00006d4b, 0x00008bd5};
+
+	{
+		std::u16string utf16 = u"some previous content that is long enough";
+		utf16.reserve(128);
+		const auto cap = utf16.capacity();
+		const auto ptr = utf16.data();
+
+		Utf8ToUtf16(testUtf8, utf16);
+		EXPECT_EQ(utf16, testUtf16);
+		Utf32ToUtf16(testUtf32, utf16);
+		EXPECT_EQ(utf16, testUtf16);
+
+		EXPECT_EQ(utf16.capacity(), cap);
+		EXPECT_EQ(utf16.data(), ptr);
+	}
+	{
+		std::string utf8 = "some previous content that is long enough";
+		utf8.reserve(128);
+		const auto cap = utf8.capacity();
+		const auto ptr = utf8.data();
+
+		Utf16ToUtf8(testUtf16, utf8);
+		EXPECT_EQ(utf8, testUtf8);
+		Utf32ToUtf8(testUtf32, utf8);
+		EXPECT_EQ(utf8, testUtf8);
+
+		EXPECT_EQ(utf8.capacity(), cap);
+		EXPECT_EQ(utf8.data(), ptr);
+	}
+	{
+		std::u32string utf32 = U"some previous content that is long enough";
+		utf32.reserve(128);
+		const auto cap = utf32.capacity();
+		const auto ptr = utf32.data();
+
+		Utf8ToUtf32(testUtf8, utf32);
+		EXPECT_EQ(utf32, testUtf32);
+		Utf16ToUtf32(testUtf16, utf32);
+		EXPECT_EQ(utf32, testUtf32);
+
+		EXPECT_EQ(utf32.capacity(), cap);
+		EXPECT_EQ(utf32.data(), ptr);
+	}
+}
+
+GTEST_TEST(TestUtf, ConversionTruncatedInput)
+{
+	// random access iterators - checked once per code point
+	const std::string truncUtf8 = "\xE6\xB5\x8B\xE8\xAF";
+	std::u32string utf32;
+	EXPECT_THROW(Utf8ToUtf16(truncUtf8);, UtfConversionException);
+	EXPECT_THROW(Utf8ToUtf32(truncUtf8.data(), truncUtf8.data() + 4,
+		std::back_inserter(utf32));, UtfConversionException);
+	EXPECT_EQ(utf32, std::u32string({0x6d4b}));
+	EXPECT_THROW(Utf8ToUtf16GetSize(truncUtf8.begin(), truncUtf8.end());,
+		UtfConversionException);
+
+	// other iterators - checked on every increment
+	const std::list<char> truncUtf8List(truncUtf8.begin(), truncUtf8.end());
+	std::u16string utf16;
+	EXPECT_THROW(Utf8ToUtf16(truncUtf8List.begin(), truncUtf8List.end(),
+		std::back_inserter(utf16));, UtfConversionException);
+	EXPECT_EQ(utf16, std::u16string({0x6d4b}));
+
+	const std::list<char> utf8List(truncUtf8.begin(), truncUtf8.begin() + 3);
+	EXPECT_EQ(Utf8ToUtf16GetSize(utf8List.begin(), utf8List.end()), 1);
+}
+
+#ifdef SIMPLEUTF_HAS_STRING_VIEW
+GTEST_TEST(TestUtf, ConversionStringView)
+{
+	const std::vector<char> buf = {
+		'x', '\xF0', '\x9F', '\x98', '\x82', ' ', '\xE6', '\xB5', '\x8B', 'x'
+	};
+	const std::string_view testUtf8(buf.data() + 1, buf.size() - 2);
+	const std::u16string testUtf16 = {0xd83d, 0xde02, 0x0020, 0x6d4b};
+	const std::u32string testUtf32 = {0x0001f602, 0x00000020, 0x00006d4b};
+
+	EXPECT_EQ(Utf8ToUtf16(testUtf8), testUtf16);
+	EXPECT_EQ(Utf8ToUtf32(testUtf8), testUtf32);
+
+	const std::u16string_view testUtf16View(testUtf16);
+	EXPECT_EQ(Utf16ToUtf8(testUtf16View), testUtf8);
+	EXPECT_EQ(Utf16ToUtf32(testUtf16View.substr(2)), testUtf32.substr(1));
+
+	const std::u32string_view testUtf32View(testUtf32);
+	EXPECT_EQ(Utf32ToUtf8(testUtf32View), testUtf8);
+	EXPECT_EQ(Utf32ToUtf16(testUtf32View.substr(1)), testUtf16.substr(2));
+
+	std::u16string utf16;
+	Utf8ToUtf16(testUtf8.substr(0, 4), utf16);
+	EXPECT_EQ(utf16, testUtf16.substr(0, 2));
+	EXPECT_THROW(Utf8ToUtf16(testUtf8.substr(0, 3), utf16);,
+		UtfConversionException);
+}
+#endif // SIMPLEUTF_HAS_STRING_VIEW
+
+GTEST_TEST(TestUtf, ConversionPointerOutput)
+{
+	const std::string testUtf8 = "\xF0\x9F\x98\x82 \xE6\xB5\x8B";
+	const std::u16string testUtf16 = {0xd83d, 0xde02, 0x0020, 0x6d4b};
+
+	char16_t buf[8] = { 0 };
+	char16_t* bufEnd = Utf8ToUtf16(testUtf8.begin(), testUtf8.end(), buf);
+	EXPECT_EQ(bufEnd, buf + testUtf16.size());
+	EXPECT_EQ(std::u16string(buf, bufEnd), testUtf16);
+
+	char out[16] = { 0 };
+	char* outEnd = Utf16ToUtf8(testUtf16.begin(), testUtf16.end(), out);
+	EXPECT_EQ(std::string(out, outEnd), testUtf8);
+
+	outEnd = CodePtToUtf8Once(0x6d4bU, out);
+	EXPECT_EQ(outEnd, out + 3);
+
+	// a single code point, into a surrogate pair
+	const auto onceRes = UtfConvertOnce(
+		Utf8ToCodePtOnce<std::string::const_iterator>,
+		CodePtToUtf16Once<char16_t*>,
+		testUtf8.begin(), testUtf8.end(), buf);
+	EXPECT_EQ(onceRes.first, testUtf8.begin() + 4);
+	EXPECT_EQ(onceRes.second, buf + 2);
+}
+
+GTEST_TEST(TestUtf, ConversionWtf)
+{
+	// lone high surrogate, a valid pair, and a lone low surrogate at the end
+	const std::u16string wtf16 = {
+		0x0061, 0xd800, 0x0062, 0xd83d, 0xde02, 0xd83d, 0xdc00
+	};
+	const std::string wtf8 =
+		"a" "\xED\xA0\x80" "b" "\xF0\x9F\x98\x82" "\xF0\x9F\x90\x80";
+
+	EXPECT_EQ(Wtf16ToWtf8(wtf16), wtf8);
+	EXPECT_EQ(Wtf8ToWtf16(wtf8), wtf16);
+	EXPECT_EQ(Wtf16ToWtf8GetSize(wtf16.begin(), wtf16.end()), wtf8.size());
+	EXPECT_EQ(Wtf8ToWtf16GetSize(wtf8.begin(), wtf8.end()), wtf16.size());
+
+	const std::u16string lone = { 0xdc00, 0x0061, 0xd800 };
+	const std::string loneWtf8 = "\xED\xB0\x80" "a" "\xED\xA0\x80";
+	EXPECT_EQ(Wtf16ToWtf8(lone), loneWtf8);
+	EXPECT_EQ(Wtf8ToWtf16(loneWtf8), lone);
+
+	// valid UTF is unchanged
+	const std::string utf8 = "\xF0\x9F\x98\x82 \xE6\xB5\x8B";
+	EXPECT_EQ(Wtf8ToWtf16(utf8), Utf8ToUtf16(utf8));
+
+	// still rejected by the default policy
+	EXPECT_THROW(Utf16ToUtf8(lone);, UtfConversionException);
+	EXPECT_THROW(Utf8ToUtf16(loneWtf8);, UtfConversionException);
+
+	// other errors are still errors
+	EXPECT_THROW(Wtf8ToWtf16("\xC0\x80");, UtfConversionException);
+	EXPECT_THROW(Wtf8ToWtf16("\xF4\x90\x80\x80");, UtfConversionException);
+
+	// a surrogate pair must be encoded as one sequence, not two
+	const std::string splitPair = "a" "\xED\xA0\xBD" "\xED\xB8\x80";
+	EXPECT_THROW(Wtf8ToWtf16(splitPair);, UtfConversionException);
+	EXPECT_THROW((Utf8PrevCodePt<const char*, WtfPolicy>(splitPair.data(),
+		splitPair.data() + splitPair.size()));, UtfConversionException);
+	// but a low surrogate followed by a high one is still two lone ones
+	const std::string swapped = "\xED\xB8\x80" "\xED\xA0\xBD" "\xED\xA0\x80";
+	const std::u16string swapped16 = { 0xde00, 0xd83d, 0xd800 };
+	EXPECT_EQ(Wtf8ToWtf16(swapped), swapped16);
+	EXPECT_EQ(Wtf16ToWtf8(swapped16), swapped);
+	EXPECT_EQ((Utf8PrevCodePt<const char*, WtfPolicy>(swapped.data(),
+		swapped.data() + swapped.size()).first), 0xd800U);
+
+	// the policy on the single code point functions
+	char32_t out32[1] = { 0 };
+	EXPECT_EQ((CodePtToUtf32Once<char32_t*, WtfPolicy>(0xdc00U, out32)),
+		out32 + 1);
+	EXPECT_EQ(out32[0], 0xdc00U);
+	EXPECT_THROW(CodePtToUtf32Once(0xdc00U, out32);, UtfConversionException);
+	EXPECT_EQ((Utf32ToCodePtOnce<const char32_t*, WtfPolicy>(
+		out32, out32 + 1).first), 0xdc00U);
+}
+
+GTEST_TEST(TestUtf, ConversionNewlines)
+{
+	// long enough for the 8-byte blocks, with line breaks around them
+	const std::string utf8 =
+		"line one\r\nline two\rline three\n\r\n\r\r"
+		"\xE6\xB5\x8B\r\n\xF0\x9F\x98\x82\rend";
+	const std::string normalized =
+		"line one\nline two\nline three\n\n\n\n"
+		"\xE6\xB5\x8B\n\xF0\x9F\x98\x82\nend";
+
+	NewlineNormalizer newlines;
+	std::u16string utf16;
+	Utf8ToUtf16(utf8, utf16, newlines);
+	EXPECT_EQ(utf16, Utf8ToUtf16(normalized));
+	EXPECT_EQ(newlines.GetNumNewlines(), 8);
+
+	newlines.Reset();
+	std::string out8;
+	Utf16ToUtf8(Utf8ToUtf16(utf8), out8, newlines);
+	EXPECT_EQ(out8, normalized);
+	EXPECT_EQ(newlines.GetNumNewlines(), 8);
+
+	newlines.Reset();
+	std::u32string utf32;
+	Utf8ToUtf32(utf8, utf32, newlines);
+	EXPECT_EQ(utf32, Utf8ToUtf32(normalized));
+
+	newlines.Reset();
+	Utf32ToUtf16(Utf8ToUtf32(utf8), utf16, newlines);
+	EXPECT_EQ(utf16, Utf8ToUtf16(normalized));
+
+	newlines.Reset();
+	Utf32ToUtf8(Utf8ToUtf32(utf8), out8, newlines);
+	EXPECT_EQ(out8, normalized);
+
+	newlines.Reset();
+	Utf16ToUtf32(Utf8ToUtf16(utf8), utf32, newlines);
+	EXPECT_EQ(utf32, Utf8ToUtf32(normalized));
+
+	// a CRLF split between two calls
+	newlines.Reset();
+	const std::string part1 = "a\r";
+	const std::string part2 = "\nb\r";
+	std::u16string split;
+	Utf8ToUtf16(part1.begin(), part1.end(), std::back_inserter(split),
+		newlines);
+	Utf8ToUtf16(part2.begin(), part2.end(), std::back_inserter(split),
+		newlines);
+	EXPECT_EQ(split, u"a\nb\n");
+	EXPECT_EQ(newlines.GetNumNewlines(), 2);
+
+	// invalid inputs are still rejected
+	EXPECT_THROW(Utf8ToUtf16("a\r\n\xC0\x80", utf16, newlines);,
+		UtfConversionException);
+}
+
+GTEST_TEST(TestUtf, ConversionUnchecked)
+{
+	// every 5th code point, skipping surrogates, so all sequence lengths are
+	// covered
+	std::u32string utf32;
+	for (char32_t val = 0; val <= 0x10FFFFU; val += 5)
+	{
+		if ((val < 0xD800U) || (val > 0xDFFFU))
+		{
+			utf32.push_back(val);
+		}
+	}
+	const std::string utf8 = Utf32ToUtf8(utf32);
+	const std::u16string utf16 = Utf32ToUtf16(utf32);
+
+	EXPECT_EQ(Utf8ToUtf16Unchecked(utf8), utf16);
+	EXPECT_EQ(Utf8ToUtf32Unchecked(utf8), utf32);
+	EXPECT_EQ(Utf16ToUtf8Unchecked(utf16), utf8);
+	EXPECT_EQ(Utf16ToUtf32Unchecked(utf16), utf32);
+	EXPECT_EQ(Utf32ToUtf8Unchecked(utf32), utf8);
+	EXPECT_EQ(Utf32ToUtf16Unchecked(utf32), utf16);
+
+	EXPECT_EQ(Utf8ToUtf16GetSizeUnchecked(utf8.begin(), utf8.end()),
+		utf16.size());
+	EXPECT_EQ(Utf8ToUtf32GetSizeUnchecked(utf8.begin(), utf8.end()),
+		utf32.size());
+	EXPECT_EQ(Utf16ToUtf8GetSizeUnchecked(utf16.begin(), utf16.end()),
+		utf8.size());
+	EXPECT_EQ(Utf16ToUtf32GetSizeUnchecked(utf16.begin(), utf16.end()),
+		utf32.size());
+	EXPECT_EQ(Utf32ToUtf8GetSizeUnchecked(utf32.begin(), utf32.end()),
+		utf8.size());
+	EXPECT_EQ(Utf32ToUtf16GetSizeUnchecked(utf32.begin(), utf32.end()),
+		utf16.size());
+
+	// iterator forms, and the output is cleared
+	std::u16string out16;
+	Utf8ToUtf16Unchecked(utf8.begin(), utf8.end(), std::back_inserter(out16));
+	EXPECT_EQ(out16, utf16);
+	Utf8ToUtf16Unchecked(std::string("ok"), out16);
+	EXPECT_EQ(out16, u"ok");
+	Utf8ToUtf16Unchecked(std::string(), out16);
+	EXPECT_EQ(out16, u"");
+
+#ifndef SIMPLEUTF_CHECK_ASSUME_VALID
+	// invalid input gives unspecified output, but nothing is read or
+	// written out of bounds
+	const std::string truncated8("abc\xE4", 4);
+	Utf8ToUtf16Unchecked(truncated8, out16);
+	EXPECT_EQ(out16.size(), 4);
+	EXPECT_EQ(out16.substr(0, 3), u"abc");
+	EXPECT_EQ(Utf8ToUtf16GetSizeUnchecked(truncated8.begin(), truncated8.end()),
+		4);
+	std::u32string out32;
+	Utf8ToUtf32Unchecked(std::string("\xF0\x9F", 2), out32);
+	EXPECT_EQ(out32.size(), 1);
+	Utf8ToUtf32Unchecked(std::string("\xFF\xFF\xFF\xFF\xFF", 5), out32);
+	EXPECT_EQ(out32.size(), 2);
+
+	std::string out8;
+	Utf16ToUtf8Unchecked(std::u16string(u"ab") + char16_t(0xD83D), out8);
+	EXPECT_EQ(out8.size(), 5);
+	EXPECT_EQ(out8.substr(0, 2), "ab");
+	Utf32ToUtf8Unchecked(std::u32string(1, char32_t(0xFFFFFFFFU)), out8);
+	EXPECT_EQ(out8.size(), 4);
+#else
+	// the assumption is verified
+	EXPECT_THROW(Utf8ToUtf16Unchecked(std::string("abc\xC3")),
+		UtfConversionException);
+	EXPECT_THROW(Utf8ToUtf32Unchecked(std::string("abc\xC0\x80")),
+		UtfConversionException);
+	EXPECT_THROW(Utf16ToUtf8Unchecked(std::u16string(1, char16_t(0xDC00))),
+		UtfConversionException);
+	EXPECT_THROW(Utf32ToUtf16Unchecked(std::u32string(1, char32_t(0x110000))),
+		UtfConversionException);
+#endif // SIMPLEUTF_CHECK_ASSUME_VALID
+}
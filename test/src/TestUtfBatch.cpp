@@ -0,0 +1,151 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <SimpleUtf/UtfBatch.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfBatch, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfBatch, Utf8Inputs)
+{
+	const std::vector<std::string> utf8 = {
+		"key",
+		"",
+		"\xF0\x9F\x98\x82 \xE6\xB5\x8B\xE8\xAF\x95",
+		"a longer ASCII-only value that spans multiple words",
+		"mixed \xC3\xA9t\xC3\xA9 value",
+	};
+
+	UtfBatch<char16_t> utf16;
+	Utf8ToUtf16Batch(utf8.begin(), utf8.end(), utf16);
+	ASSERT_EQ(utf16.Count(), utf8.size());
+	ASSERT_EQ(utf16.offsets.size(), utf8.size() + 1);
+	EXPECT_EQ(utf16.offsets.front(), 0);
+	EXPECT_EQ(utf16.offsets.back(), utf16.data.size());
+	for (size_t i = 0; i < utf8.size(); ++i)
+	{
+		EXPECT_EQ(utf16.Get(i), Utf8ToUtf16(utf8[i]));
+	}
+
+	UtfBatch<char32_t> utf32;
+	Utf8ToUtf32Batch(utf8.begin(), utf8.end(), utf32);
+	ASSERT_EQ(utf32.Count(), utf8.size());
+	for (size_t i = 0; i < utf8.size(); ++i)
+	{
+		EXPECT_EQ(utf32.Get(i), Utf8ToUtf32(utf8[i]));
+	}
+
+	// the output buffers are reused
+	const auto dataPtr = utf16.data.data();
+	Utf8ToUtf16Batch(utf8.begin() + 1, utf8.end(), utf16);
+	ASSERT_EQ(utf16.Count(), utf8.size() - 1);
+	EXPECT_EQ(utf16.data.data(), dataPtr);
+	EXPECT_EQ(utf16.Get(1), Utf8ToUtf16(utf8[2]));
+
+	// invalid input; the output is left as it was
+	const std::vector<char16_t> oldData = utf16.data;
+	const std::vector<size_t> oldOffsets = utf16.offsets;
+	const std::vector<std::string> invalid = { "ok", "\xE6\xB5" };
+	EXPECT_THROW(Utf8ToUtf16Batch(invalid.begin(), invalid.end(), utf16);,
+		UtfConversionException);
+	EXPECT_EQ(utf16.data, oldData);
+	EXPECT_EQ(utf16.offsets, oldOffsets);
+}
+
+GTEST_TEST(TestUtfBatch, OtherInputs)
+{
+	const std::vector<std::u16string> utf16 = {
+		u"key",
+		u"",
+		{0xd83d, 0xde02, 0x0020, 0x6d4b, 0x8bd5},
+	};
+	const std::vector<std::u32string> utf32 = {
+		U"key",
+		U"",
+		{0x0001f602, 0x00000020, 0x00006d4b, 0x00008bd5},
+	};
+
+	UtfBatch<char> utf8Out;
+	UtfBatch<char16_t> utf16Out;
+	UtfBatch<char32_t> utf32Out;
+
+	Utf16ToUtf8Batch(utf16.begin(), utf16.end(), utf8Out);
+	Utf16ToUtf32Batch(utf16.begin(), utf16.end(), utf32Out);
+	ASSERT_EQ(utf8Out.Count(), utf16.size());
+	ASSERT_EQ(utf32Out.Count(), utf16.size());
+	for (size_t i = 0; i < utf16.size(); ++i)
+	{
+		EXPECT_EQ(utf8Out.Get(i), Utf16ToUtf8(utf16[i]));
+		EXPECT_EQ(utf32Out.Get(i), utf32[i]);
+	}
+
+	Utf32ToUtf8Batch(utf32.begin(), utf32.end(), utf8Out);
+	Utf32ToUtf16Batch(utf32.begin(), utf32.end(), utf16Out);
+	ASSERT_EQ(utf8Out.Count(), utf32.size());
+	ASSERT_EQ(utf16Out.Count(), utf32.size());
+	for (size_t i = 0; i < utf32.size(); ++i)
+	{
+		EXPECT_EQ(utf8Out.Get(i), Utf32ToUtf8(utf32[i]));
+		EXPECT_EQ(utf16Out.Get(i), utf16[i]);
+	}
+}
+
+GTEST_TEST(TestUtfBatch, CountAsciiPrefix)
+{
+	const std::string str = "0123456789abcdef\xC3\xA9xyz";
+	const char* ptr = str.data();
+	EXPECT_EQ(Internal::CountAsciiPrefix(ptr, ptr + str.size()), 16);
+	EXPECT_EQ(Internal::CountAsciiPrefix(ptr + 3, ptr + str.size()), 13);
+	EXPECT_EQ(Internal::CountAsciiPrefix(ptr + 16, ptr + str.size()), 0);
+	EXPECT_EQ(Internal::CountAsciiPrefix(ptr + 18, ptr + str.size()), 3);
+	EXPECT_EQ(Internal::CountAsciiPrefix(ptr, ptr), 0);
+}
+
+#ifdef SIMPLEUTF_ENABLE_STATS
+
+GTEST_TEST(TestUtfBatch, Stats)
+{
+	// the ASCII runs copied by the fast path are counted as if they were
+	// decoded and encoded one by one
+	const std::vector<std::string> utf8 = { "abc\xC3\xA9", "xy" };
+
+	ResetUtfStats();
+	UtfBatch<char16_t> utf16;
+	Utf8ToUtf16Batch(utf8.begin(), utf8.end(), utf16);
+
+	// each input is decoded twice, once for the size, and once to convert
+	auto stats = GetUtfStats();
+	EXPECT_EQ(stats.Get(UtfStatsCounter::BytesIn), 7 * 2);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::Utf8Decoded1B), 5 * 2);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::Utf8Decoded2B), 1 * 2);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::BytesOut), 6 * sizeof(char16_t));
+
+	ResetUtfStats();
+	UtfBatch<char32_t> utf32;
+	Utf8ToUtf32Batch(utf8.begin(), utf8.end(), utf32);
+
+	stats = GetUtfStats();
+	EXPECT_EQ(stats.Get(UtfStatsCounter::BytesIn), 7 * 2);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::Utf8Decoded1B), 5 * 2);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::BytesOut), 6 * sizeof(char32_t));
+	ResetUtfStats();
+}
+
+#endif // SIMPLEUTF_ENABLE_STATS
@@ -0,0 +1,129 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <SimpleUtf/UtfChecksum.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+namespace
+{
+
+std::string GenUtf8(size_t repeat)
+{
+	std::string res;
+	for (size_t i = 0; i < repeat; ++i)
+	{
+		res += "ASCII \xF0\x9F\x98\x82 \xE6\xB5\x8B\xE8\xAF\x95 \xC3\xA9 ";
+	}
+	return res;
+}
+
+template<typename _CharType>
+uint32_t Crc32cOf(const std::basic_string<_CharType>& str)
+{
+	Crc32c crc;
+	crc.Update(str.data(), str.size() * sizeof(_CharType));
+	return crc.Value();
+}
+
+} // namespace
+
+GTEST_TEST(TestUtfChecksum, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfChecksum, Crc32c)
+{
+	EXPECT_EQ(Crc32cOf(std::string()), 0x00000000U);
+	EXPECT_EQ(Crc32cOf(std::string("123456789")), 0xE3069283U);
+	EXPECT_EQ(Crc32cOf(std::string(32, '\0')), 0x8A9136AAU);
+
+	// split at every position
+	const std::string str = GenUtf8(2);
+	for (size_t i = 0; i <= str.size(); ++i)
+	{
+		Crc32c crc;
+		crc.Update(str.data(), i);
+		crc.Update(str.data() + i, str.size() - i);
+		EXPECT_EQ(crc.Value(), Crc32cOf(str));
+	}
+}
+
+GTEST_TEST(TestUtfChecksum, ConvertHashed)
+{
+	// longer than a few chunks
+	const std::string utf8 = GenUtf8(1000);
+	const std::u16string utf16 = Utf8ToUtf16(utf8);
+	const std::u32string utf32 = Utf8ToUtf32(utf8);
+
+	{
+		std::string out = "old content";
+		Crc32c crc;
+		Utf16ToUtf8Hashed(utf16, out, crc);
+		EXPECT_EQ(out, utf8);
+		EXPECT_EQ(crc.Value(), Crc32cOf(utf8));
+
+		crc = Crc32c();
+		Utf32ToUtf8Hashed(utf32, out, crc);
+		EXPECT_EQ(out, utf8);
+		EXPECT_EQ(crc.Value(), Crc32cOf(utf8));
+	}
+	{
+		std::u16string out;
+		Crc32c crc;
+		Utf8ToUtf16Hashed(utf8, out, crc);
+		EXPECT_EQ(out, utf16);
+		EXPECT_EQ(crc.Value(), Crc32cOf(utf16));
+
+		crc = Crc32c();
+		Utf32ToUtf16Hashed(utf32, out, crc);
+		EXPECT_EQ(out, utf16);
+		EXPECT_EQ(crc.Value(), Crc32cOf(utf16));
+	}
+	{
+		std::u32string out;
+		Crc32c crc;
+		Utf8ToUtf32Hashed(utf8, out, crc);
+		EXPECT_EQ(out, utf32);
+		EXPECT_EQ(crc.Value(), Crc32cOf(utf32));
+
+		crc = Crc32c();
+		Utf16ToUtf32Hashed(utf16, out, crc);
+		EXPECT_EQ(out, utf32);
+		EXPECT_EQ(crc.Value(), Crc32cOf(utf32));
+	}
+
+	// any callable works, and gets the output in order
+	std::string collected;
+	size_t numChunks = 0;
+	std::string out;
+	Utf16ToUtf8Hashed(utf16, out, [&](const char* data, size_t len)
+	{
+		collected.append(data, len);
+		++numChunks;
+	});
+	EXPECT_EQ(collected, utf8);
+	EXPECT_GT(numChunks, 1);
+
+	// invalid input, after a few valid chunks; the partial output is
+	// dropped
+	std::u16string tmp16 = u"old content";
+	Crc32c crc;
+	EXPECT_THROW(Utf8ToUtf16Hashed(utf8 + "\xE6\xB5", tmp16, crc);,
+		UtfConversionException);
+	EXPECT_TRUE(tmp16.empty());
+}
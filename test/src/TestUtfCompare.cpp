@@ -0,0 +1,97 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <SimpleUtf/UtfCompare.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+namespace
+{
+
+const std::string gk_utf8 =
+	"ASCII \xF0\x9F\x98\x82 \xE6\xB5\x8B\xE8\xAF\x95 \xC3\xA9 and more ASCII";
+
+int Sign(int val)
+{
+	return val < 0 ? -1 : (val > 0 ? 1 : 0);
+}
+
+} // namespace
+
+GTEST_TEST(TestUtfCompare, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfCompare, Compare)
+{
+	const std::u16string utf16 = Utf8ToUtf16(gk_utf8);
+
+	EXPECT_EQ(CompareCodePoints(gk_utf8, utf16), 0);
+	EXPECT_EQ(CompareCodePoints(utf16, gk_utf8), 0);
+	EXPECT_EQ(CompareCodePoints(std::string(), std::u16string()), 0);
+
+	// prefixes
+	EXPECT_LT(CompareCodePoints(gk_utf8.substr(0, 5), utf16), 0);
+	EXPECT_GT(CompareCodePoints(gk_utf8, utf16.substr(0, 12)), 0);
+	EXPECT_GT(CompareCodePoints(utf16, gk_utf8.substr(0, 5)), 0);
+
+	// code point order, not code unit order:
+	// U+FF61 is less than U+1F602, but 0xFF61 > 0xD83D
+	EXPECT_LT(CompareCodePoints("\xEF\xBD\xA1", u"\U0001F602"), 0);
+	EXPECT_GT(CompareCodePoints(u"\U0001F602", "\xEF\xBD\xA1"), 0);
+
+	// a difference at every position, in both the fast path and the tail
+	const std::string ascii = "the quick brown fox jumps over the lazy dog";
+	const std::u16string ascii16 = Utf8ToUtf16(ascii);
+	for (size_t i = 0; i < ascii.size(); ++i)
+	{
+		for (char diff : { 'A', '~', '\x7F', '\0' })
+		{
+			std::string str = ascii;
+			str[i] = diff;
+			EXPECT_EQ(CompareCodePoints(str, ascii16),
+				Sign(static_cast<int>(diff) - static_cast<int>(ascii[i])));
+
+			std::u16string str16 = ascii16;
+			str16[i] = u'\xE9';
+			EXPECT_LT(CompareCodePoints(ascii, str16), 0);
+		}
+	}
+
+	// the same, with the generic version
+	const std::u32string utf32 = Utf8ToUtf32(gk_utf8);
+	EXPECT_EQ(CompareCodePoints(
+		Utf8ToCodePtOnce<std::string::const_iterator>,
+		gk_utf8.begin(), gk_utf8.end(),
+		Utf32ToCodePtOnce<std::u32string::const_iterator>,
+		utf32.begin(), utf32.end()), 0);
+
+	// invalid inputs are found
+	EXPECT_THROW(CompareCodePoints("a\xFF", u"ab");, UtfConversionException);
+}
+
+GTEST_TEST(TestUtfCompare, Equal)
+{
+	const std::u16string utf16 = Utf8ToUtf16(gk_utf8);
+
+	EXPECT_TRUE(EqualCodePoints(gk_utf8, utf16));
+	EXPECT_TRUE(EqualCodePoints(utf16, gk_utf8));
+	EXPECT_FALSE(EqualCodePoints(gk_utf8, utf16.substr(1)));
+	EXPECT_FALSE(EqualCodePoints(gk_utf8.substr(1), utf16));
+	EXPECT_FALSE(EqualCodePoints("\xC3\xA9", u"\xE8"));
+	EXPECT_TRUE(EqualCodePoints("", u""));
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include <SimpleUtf/UtfHash.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfHash, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfHash, SameAcrossEncodings)
+{
+	const std::string utf8 =
+		"ASCII \xF0\x9F\x98\x82 \xE6\xB5\x8B\xE8\xAF\x95 \xC3\xA9 and more ASCII";
+
+	// all prefixes, so the ASCII blocks start at every offset
+	std::unordered_set<size_t> hashes;
+	for (auto it = utf8.begin(); it != utf8.end(); )
+	{
+		it = Utf8ToCodePtOnce(it, utf8.end()).second;
+		const std::string prefix(utf8.begin(), it);
+
+		const size_t hash = HashCodePoints(prefix);
+		EXPECT_EQ(HashCodePoints(Utf8ToUtf16(prefix)), hash);
+		EXPECT_EQ(HashCodePoints(Utf8ToUtf32(prefix)), hash);
+		hashes.insert(hash);
+	}
+	// no collisions among the prefixes
+	EXPECT_EQ(hashes.size(), Utf8ToUtf32(utf8).size());
+
+	EXPECT_EQ(HashCodePoints(std::string()), HashCodePoints(std::u16string()));
+	EXPECT_NE(HashCodePoints("abcdefgh"), HashCodePoints("abcdefgi"));
+	EXPECT_NE(HashCodePoints("abcdefgh"), HashCodePoints("abcdefghi"));
+
+	EXPECT_THROW(HashCodePoints("abc\xFF");, UtfConversionException);
+}
+
+GTEST_TEST(TestUtfHash, Functors)
+{
+	CodePtHash hash;
+	CodePtEqual equal;
+
+	const std::string utf8 = "key \xE6\xB5\x8B\xE8\xAF\x95";
+	const std::u16string utf16 = Utf8ToUtf16(utf8);
+	const std::u32string utf32 = Utf8ToUtf32(utf8);
+
+	EXPECT_EQ(hash(utf8), hash(utf16));
+	EXPECT_EQ(hash(utf8), hash(utf32));
+
+	EXPECT_TRUE(equal(utf8, utf8));
+	EXPECT_TRUE(equal(utf8, utf16));
+	EXPECT_TRUE(equal(utf16, utf8));
+	EXPECT_TRUE(equal(utf8, utf32));
+	EXPECT_TRUE(equal(utf32, utf16));
+	EXPECT_FALSE(equal(utf8, utf16.substr(1)));
+	EXPECT_FALSE(equal(utf32.substr(1), utf8));
+
+	std::unordered_map<std::string, int, CodePtHash, CodePtEqual> map;
+	map[utf8] = 1;
+	map["other"] = 2;
+	EXPECT_EQ(map.at(utf8), 1);
+
+#if defined(__cpp_lib_generic_unordered_lookup) && \
+	(__cpp_lib_generic_unordered_lookup >= 201811L)
+	// heterogeneous lookup, without converting the key
+	auto it = map.find(std::u16string_view(utf16));
+	ASSERT_NE(it, map.end());
+	EXPECT_EQ(it->second, 1);
+	EXPECT_EQ(map.find(std::u16string_view(u"other!")), map.end());
+	EXPECT_EQ(map.count(std::u32string_view(U"other")), 1);
+#endif
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <list>
+
+#include <SimpleUtf/UtfIterator.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+namespace
+{
+
+const std::u32string gk_utf32 =
+	U"ASCII \U0001F602 \u6D4B\u8BD5 \u00E9!";
+
+} // namespace
+
+GTEST_TEST(TestUtfIterator, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfIterator, Utf8)
+{
+	const std::string utf8 = Utf32ToUtf8(gk_utf32);
+
+	std::u32string res;
+	for (char32_t codePt : Utf8CodePts(utf8.begin(), utf8.end()))
+	{
+		res.push_back(codePt);
+	}
+	EXPECT_EQ(res, gk_utf32);
+
+	// backward
+	auto range = Utf8CodePts(utf8.begin(), utf8.end());
+	res = std::u32string(range.rbegin(), range.rend());
+	EXPECT_EQ(res, std::u32string(gk_utf32.rbegin(), gk_utf32.rend()));
+
+	// back and forth
+	auto it = range.end();
+	--it;
+	EXPECT_EQ(*it, U'!');
+	--it;
+	EXPECT_EQ(*it, U'\u00E9');
+	EXPECT_EQ(it.Base(), utf8.end() - 3);
+	--it;
+	EXPECT_EQ(*it, U' ');
+	++it;
+	++it;
+	EXPECT_EQ(*it, U'!');
+
+	// non-random-access iterators
+	const std::list<char> utf8List(utf8.begin(), utf8.end());
+	auto listRange = Utf8CodePts(utf8List.begin(), utf8List.end());
+	res = std::u32string(listRange.rbegin(), listRange.rend());
+	EXPECT_EQ(res, std::u32string(gk_utf32.rbegin(), gk_utf32.rend()));
+
+	// invalid sequences are found in both directions
+	const std::string invalid = "ab\xA9" "cd";
+	auto invRange = Utf8CodePts(invalid.begin(), invalid.end());
+	EXPECT_THROW(std::u32string(invRange.begin(), invRange.end());,
+		UtfConversionException);
+	EXPECT_THROW(std::u32string(invRange.rbegin(), invRange.rend());,
+		UtfConversionException);
+}
+
+GTEST_TEST(TestUtfIterator, Utf16)
+{
+	const std::u16string utf16 = Utf32ToUtf16(gk_utf32);
+
+	auto range = Utf16CodePts(utf16.begin(), utf16.end());
+	EXPECT_EQ(std::u32string(range.begin(), range.end()), gk_utf32);
+	EXPECT_EQ(std::u32string(range.rbegin(), range.rend()),
+		std::u32string(gk_utf32.rbegin(), gk_utf32.rend()));
+
+	// right-to-left search
+	auto it = std::find(range.rbegin(), range.rend(), U'\U0001F602');
+	ASSERT_NE(it, range.rend());
+	EXPECT_EQ(it.base().Base() - utf16.begin(), 8);
+}
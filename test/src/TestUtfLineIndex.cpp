@@ -0,0 +1,230 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <SimpleUtf/UtfLineIndex.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+namespace
+{
+
+using Position = std::pair<size_t, size_t>;
+
+const std::string gk_text =
+	"first line, long enough for 8-byte blocks\r\n"
+	"\xE6\xB5\x8B\xE8\xAF\x95 \xF0\x9F\x98\x82 x\xC3\xA9y\n"
+	"\n"
+	"ASCII again\n"
+	"\xF0\x9F\x98\x82";
+
+/**
+ * @brief Checks the index against positions computed by decoding the text
+ *
+ */
+void ExpectIndexOf(const LineIndex& index, const std::string& text)
+{
+	// the (begin, end) of each line; LF, CRLF, and a lone CR are all line
+	// breaks, and are not part of the line
+	std::vector<std::pair<size_t, size_t> > lines;
+	size_t lineBegin = 0;
+	for (size_t i = 0; i < text.size(); ++i)
+	{
+		if ((text[i] == '\r') || (text[i] == '\n'))
+		{
+			lines.emplace_back(lineBegin, i);
+			if ((text[i] == '\r') && (i + 1 < text.size()) &&
+				(text[i + 1] == '\n'))
+			{
+				++i;
+			}
+			lineBegin = i + 1;
+		}
+	}
+	lines.emplace_back(lineBegin, text.size());
+
+	size_t line = 0;
+	for (size_t offset = 0; offset <= text.size(); ++offset)
+	{
+		while ((line + 1 < lines.size()) && (lines[line + 1].first <= offset))
+		{
+			++line;
+		}
+		if ((offset < text.size()) &&
+			((static_cast<unsigned char>(text[offset]) & 0xC0U) == 0x80U))
+		{
+			continue;
+		}
+
+		// the line break itself is at the end of the line
+		const size_t pos = std::min(offset, lines[line].second);
+		const size_t col16 = Utf8ToUtf16GetSize(
+			text.begin() + lines[line].first, text.begin() + pos);
+
+		EXPECT_EQ(index.OffsetToPosition(offset), std::make_pair(line, col16))
+			<< "offset " << offset;
+		EXPECT_EQ(index.PositionToOffset(line, col16), pos)
+			<< "offset " << offset;
+	}
+	ASSERT_EQ(index.GetNumLines(), lines.size());
+	for (size_t i = 0; i < lines.size(); ++i)
+	{
+		EXPECT_EQ(index.GetLineBegin(i), lines[i].first) << "line " << i;
+		EXPECT_EQ(index.GetLineEnd(i), lines[i].second) << "line " << i;
+	}
+}
+
+} // namespace
+
+GTEST_TEST(TestUtfLineIndex, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfLineIndex, Build)
+{
+	LineIndex index(gk_text);
+	ExpectIndexOf(index, gk_text);
+
+	EXPECT_EQ(index.GetNumLines(), 5);
+	EXPECT_EQ(index.GetLineBegin(1), 43);
+	EXPECT_EQ(index.GetLineEnd(0), 41);
+	EXPECT_TRUE(index.IsLineAscii(0));
+	EXPECT_FALSE(index.IsLineAscii(1));
+	EXPECT_TRUE(index.IsLineAscii(2));
+	EXPECT_FALSE(index.IsLineAscii(4));
+
+	// the surrogate pair of U+1F602 at column 3 of line 1
+	const size_t emoji = gk_text.find("\xF0\x9F\x98\x82");
+	EXPECT_EQ(index.OffsetToPosition(emoji), Position(1, 3));
+	EXPECT_EQ(index.OffsetToPosition(emoji + 2),
+		Position(1, 3));
+	EXPECT_EQ(index.PositionToOffset(1, 4), emoji);
+	EXPECT_EQ(index.PositionToOffset(1, 5), emoji + 4);
+
+	// out of range
+	EXPECT_EQ(index.PositionToOffset(0, 100), 41);
+	EXPECT_EQ(index.PositionToOffset(100, 0), gk_text.size());
+	EXPECT_EQ(index.OffsetToPosition(1000),
+		Position(4, 2));
+
+	LineIndex empty;
+	EXPECT_EQ(empty.GetNumLines(), 1);
+	EXPECT_EQ(empty.OffsetToPosition(0), Position(0, 0));
+	EXPECT_EQ(empty.PositionToOffset(0, 5), 0);
+}
+
+GTEST_TEST(TestUtfLineIndex, Update)
+{
+	struct Edit
+	{
+		size_t begin;
+		size_t end;
+		std::string text;
+	};
+	const Edit edits[] = {
+		// typing in a line
+		{ 5, 5, "x" },
+		{ 44, 44, "\xC3\xA9" },
+		// deleting a line break
+		{ 41, 43, "" },
+		// inserting lines
+		{ 10, 10, "\n\xF0\x9F\x98\x82\n\r" },
+		// joining a CR and an LF
+		{ 17, 17, "\n" },
+		// replacing across lines
+		{ 3, 60, "a\nb\xE6\xB5\x8B" },
+		// at the end
+		{ 0, 0, "" },
+	};
+
+	std::string text = gk_text;
+	LineIndex index(text);
+	for (const Edit& edit : edits)
+	{
+		size_t begin = std::min(edit.begin, text.size());
+		size_t end = std::min(edit.end, text.size());
+		// edits are made at code point boundaries
+		while ((begin != 0) && (begin != text.size()) &&
+			((static_cast<unsigned char>(text[begin]) & 0xC0U) == 0x80U))
+		{
+			--begin;
+		}
+		while ((end != text.size()) &&
+			((static_cast<unsigned char>(text[end]) & 0xC0U) == 0x80U))
+		{
+			++end;
+		}
+		text.replace(begin, end - begin, edit.text);
+		index.Update(text, begin, end, begin + edit.text.size());
+		ExpectIndexOf(index, text);
+	}
+
+	const size_t size = text.size();
+	text += "\r\nend\xC3\xA9";
+	index.Update(text, size, size, text.size());
+	ExpectIndexOf(index, text);
+
+	const size_t oldSize = text.size();
+	text.clear();
+	index.Update(text, 0, oldSize, 0);
+	ExpectIndexOf(index, text);
+}
+
+GTEST_TEST(TestUtfLineIndex, LineBreaks)
+{
+	// a lone CR, CRLF, LF, and CRs inside and at the end of 8-byte blocks
+	const std::string text =
+		"old mac line\rcrlf line\r\nunix line\n\r\r\n"
+		"abcdefg\rabcdefgh\r\xC3\xA9\r";
+	LineIndex index(text);
+	ExpectIndexOf(index, text);
+	EXPECT_EQ(index.GetNumLines(), 9);
+	EXPECT_EQ(index.OffsetToPosition(13), Position(1, 0));
+	EXPECT_EQ(index.PositionToOffset(1, 100), 22);
+	EXPECT_EQ(index.GetLineBegin(2), 24);
+	EXPECT_EQ(index.OffsetToPosition(text.size()), Position(8, 0));
+
+	// an LF inserted right after a CR joins them into one line break, and
+	// deleting it splits them again
+	std::string edited = "ab\rcd\xC3\xA9\ref";
+	LineIndex editedIndex(edited);
+	EXPECT_EQ(editedIndex.GetNumLines(), 3);
+
+	edited.insert(3, "\n");
+	editedIndex.Update(edited, 3, 3, 4);
+	ExpectIndexOf(editedIndex, edited);
+	EXPECT_EQ(editedIndex.GetNumLines(), 3);
+
+	edited.insert(9, "\n");
+	editedIndex.Update(edited, 9, 9, 10);
+	ExpectIndexOf(editedIndex, edited);
+
+	edited.erase(3, 1);
+	editedIndex.Update(edited, 3, 4, 3);
+	ExpectIndexOf(editedIndex, edited);
+
+	// a CR typed before an existing CRLF adds an empty line
+	edited.insert(8, "\r");
+	editedIndex.Update(edited, 8, 8, 9);
+	ExpectIndexOf(editedIndex, edited);
+	EXPECT_EQ(editedIndex.GetNumLines(), 4);
+
+	// a character typed between a CR and an LF splits them
+	edited.insert(9, "x");
+	editedIndex.Update(edited, 9, 9, 10);
+	ExpectIndexOf(editedIndex, edited);
+	EXPECT_EQ(editedIndex.GetNumLines(), 5);
+}
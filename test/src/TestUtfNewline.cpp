@@ -0,0 +1,90 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <SimpleUtf/UtfNewline.hpp>
+#include <SimpleUtf/Utf.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfNewline, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfNewline, Normalizer)
+{
+	NewlineNormalizer newlines;
+
+	// CRLF
+	char32_t val = U'\r';
+	EXPECT_TRUE(newlines.Filter(val));
+	EXPECT_EQ(val, U'\n');
+	val = U'\n';
+	EXPECT_FALSE(newlines.Filter(val));
+
+	// LF, and CR followed by something else
+	EXPECT_TRUE(newlines.Filter(val));
+	EXPECT_EQ(val, U'\n');
+	val = U'\r';
+	EXPECT_TRUE(newlines.Filter(val));
+	newlines.PassPlain();
+	val = U'\n';
+	EXPECT_TRUE(newlines.Filter(val));
+	EXPECT_EQ(newlines.GetNumNewlines(), 4);
+
+	val = U'\r';
+	EXPECT_TRUE(newlines.Filter(val));
+	newlines.Reset();
+	EXPECT_EQ(newlines.GetNumNewlines(), 0);
+	// the CR before the reset is forgotten
+	val = U'\n';
+	EXPECT_TRUE(newlines.Filter(val));
+	EXPECT_EQ(newlines.GetNumNewlines(), 1);
+}
+
+GTEST_TEST(TestUtfNewline, PlainPrefix)
+{
+	const std::string utf8 = "abcdefghij\r\n";
+	EXPECT_EQ(Internal::CountNewlinePlainPrefix(
+		utf8.data(), utf8.data() + utf8.size()), 10);
+	EXPECT_EQ(Internal::SkipNewlinePlain(utf8.begin(), utf8.end()),
+		utf8.begin() + 10);
+
+	const std::u16string utf16 = u"abcdefghi\u00E9\n";
+	EXPECT_EQ(Internal::CountNewlinePlainPrefix(
+		utf16.data(), utf16.data() + utf16.size()), 9);
+}
+
+#ifdef SIMPLEUTF_ENABLE_STATS
+
+GTEST_TEST(TestUtfNewline, Stats)
+{
+	// the runs copied without decoding are counted too
+	const std::string utf8 = "abc\r\ndef\xC3\xA9";
+	NewlineNormalizer newlines;
+	std::u16string out;
+
+	ResetUtfStats();
+	Utf8ToUtf16(utf8, out, newlines);
+	EXPECT_EQ(out, u"abc\ndef\u00E9");
+
+	const auto stats = GetUtfStats();
+	EXPECT_EQ(stats.Get(UtfStatsCounter::BytesIn), utf8.size());
+	EXPECT_EQ(stats.Get(UtfStatsCounter::BytesOut),
+		out.size() * sizeof(char16_t));
+}
+
+#endif // SIMPLEUTF_ENABLE_STATS
@@ -0,0 +1,148 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <SimpleUtf/UtfParallel.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfParallel, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfParallel, WorkStealingPool)
+{
+	WorkStealingPool pool(4);
+	EXPECT_EQ(pool.GetNumThreads(), 4);
+
+	for (size_t round = 0; round < 20; ++round)
+	{
+		const size_t numTasks = 1 + round * 37;
+		std::vector<std::atomic<size_t> > counts(numTasks);
+		for (auto& count : counts)
+		{
+			count.store(0);
+		}
+
+		pool.Run(numTasks, [&](size_t i)
+		{
+			// uneven tasks
+			if (i % 5 == 0)
+			{
+				std::this_thread::sleep_for(std::chrono::microseconds(50));
+			}
+			counts[i].fetch_add(1);
+		});
+
+		for (auto& count : counts)
+		{
+			EXPECT_EQ(count.load(), 1);
+		}
+	}
+
+	EXPECT_THROW(
+		pool.Run(100, [](size_t i)
+		{
+			if (i == 42)
+			{
+				throw UtfConversionException("test");
+			}
+		});,
+		UtfConversionException);
+
+	// the pool is still usable after an exception
+	std::atomic<size_t> sum(0);
+	pool.Run(10, [&](size_t i) { sum.fetch_add(i); });
+	EXPECT_EQ(sum.load(), 45);
+}
+
+GTEST_TEST(TestUtfParallel, BatchExecutor)
+{
+	const std::string unit = "ab\xC3\xA9\xE6\xB5\x8B\xF0\x9F\x98\x82";
+	std::string large;
+	for (size_t i = 0; i < 100; ++i)
+	{
+		large += unit;
+	}
+
+	std::vector<std::string> utf8;
+	for (size_t i = 0; i < 200; ++i)
+	{
+		// prefixes of `unit` that end at a code point boundary
+		static const size_t prefixLens[] = { 0, 1, 2, 4, 7, 11 };
+		utf8.push_back(unit.substr(0, prefixLens[i % 6]));
+		if (i % 50 == 0)
+		{
+			utf8.push_back(large);
+		}
+	}
+	utf8.push_back(std::string());
+
+	// a small chunk size, so large strings are split in the middle of
+	// multi-byte sequences
+	for (size_t chunkSize : { 1, 5, 7, 64, 100000 })
+	{
+		UtfBatchExecutor executor(3, chunkSize);
+
+		UtfBatch<char16_t> ref16;
+		UtfBatch<char16_t> res16;
+		Utf8ToUtf16Batch(utf8.begin(), utf8.end(), ref16);
+		executor.Utf8ToUtf16Batch(utf8.begin(), utf8.end(), res16);
+		EXPECT_EQ(res16.offsets, ref16.offsets);
+		EXPECT_EQ(res16.data, ref16.data);
+
+		UtfBatch<char32_t> ref32;
+		UtfBatch<char32_t> res32;
+		Utf8ToUtf32Batch(utf8.begin(), utf8.end(), ref32);
+		executor.Utf8ToUtf32Batch(utf8.begin(), utf8.end(), res32);
+		EXPECT_EQ(res32.offsets, ref32.offsets);
+		EXPECT_EQ(res32.data, ref32.data);
+
+		std::vector<std::u16string> utf16;
+		for (size_t i = 0; i < ref16.Count(); ++i)
+		{
+			utf16.push_back(ref16.Get(i));
+		}
+		UtfBatch<char> res8;
+		executor.Utf16ToUtf8Batch(utf16.begin(), utf16.end(), res8);
+		ASSERT_EQ(res8.Count(), utf8.size());
+		for (size_t i = 0; i < utf8.size(); ++i)
+		{
+			EXPECT_EQ(res8.Get(i), utf8[i]);
+		}
+		executor.Utf16ToUtf32Batch(utf16.begin(), utf16.end(), res32);
+		EXPECT_EQ(res32.data, ref32.data);
+
+		std::vector<std::u32string> utf32;
+		for (size_t i = 0; i < ref32.Count(); ++i)
+		{
+			utf32.push_back(ref32.Get(i));
+		}
+		executor.Utf32ToUtf8Batch(utf32.begin(), utf32.end(), res8);
+		EXPECT_EQ(res8.offsets.back(), res8.data.size());
+		EXPECT_EQ(res8.Get(utf8.size() - 2), utf8[utf8.size() - 2]);
+		executor.Utf32ToUtf16Batch(utf32.begin(), utf32.end(), res16);
+		EXPECT_EQ(res16.data, ref16.data);
+	}
+
+	// invalid input
+	UtfBatchExecutor executor(2, 4);
+	std::vector<std::string> invalid = { large, large + "\xE6\xB5", large };
+	UtfBatch<char16_t> res16;
+	EXPECT_THROW(
+		executor.Utf8ToUtf16Batch(invalid.begin(), invalid.end(), res16);,
+		UtfConversionException);
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <SimpleUtf/UtfSearch.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+namespace
+{
+
+const std::string gk_utf8 =
+	"ASCII \xF0\x9F\x98\x82 \xE6\xB5\x8B\xE8\xAF\x95 \xC3\xA9 and more ASCII"
+	" \xE6\xB5\x8B\xC3\xA9\xF0\x9F\x98\x82 end";
+
+} // namespace
+
+GTEST_TEST(TestUtfSearch, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfSearch, Utf8)
+{
+	const size_t npos = std::string::npos;
+
+	EXPECT_EQ(FindCodePt(gk_utf8, U'A'), 0);
+	EXPECT_EQ(FindCodePt(gk_utf8, U'd', 1), gk_utf8.find('d'));
+	EXPECT_EQ(FindCodePt(gk_utf8, U'\U0001F602'), 6);
+	EXPECT_EQ(FindCodePt(gk_utf8, U'\U0001F602', 7), gk_utf8.size() - 8);
+	EXPECT_EQ(FindCodePt(gk_utf8, U'\u6D4B'), 11);
+	EXPECT_EQ(FindCodePt(gk_utf8, U'\u00E9', 20), gk_utf8.find("\xC3\xA9", 20));
+	EXPECT_EQ(FindCodePt(gk_utf8, U'\u00E8'), npos);
+	EXPECT_EQ(FindCodePt(gk_utf8, U'z'), npos);
+	EXPECT_THROW(FindCodePt(gk_utf8, 0xD800U);, UtfConversionException);
+
+	EXPECT_EQ(FindUtf8(gk_utf8, "more"), gk_utf8.find("more"));
+	EXPECT_EQ(FindUtf8(gk_utf8, "\xE6\xB5\x8B\xC3\xA9"),
+		gk_utf8.find("\xE6\xB5\x8B\xC3\xA9"));
+	EXPECT_EQ(FindUtf8(gk_utf8, "", 3), 3);
+	EXPECT_EQ(FindUtf8(gk_utf8, "", gk_utf8.size() + 1), npos);
+	EXPECT_EQ(FindUtf8(gk_utf8, "end"), gk_utf8.size() - 3);
+	EXPECT_EQ(FindUtf8(gk_utf8, "end!"), npos);
+
+	// byte matches that start or end in the middle of a sequence
+	EXPECT_EQ(FindUtf8(gk_utf8, "\x8B"), npos);
+	EXPECT_EQ(FindUtf8(gk_utf8, "\xB5\x8B"), npos);
+	EXPECT_EQ(FindUtf8(gk_utf8, "\xE6\xB5"), npos);
+	EXPECT_EQ(FindUtf8("\xE6\xB5\x8B \xE6\xB5\x8B", "\xE6\xB5\x8B", 1), 4);
+
+	// every position, in both the SWAR loop and the tail
+	for (size_t pos = 0; pos < 24; ++pos)
+	{
+		std::string str(24, 'a');
+		str.replace(pos, 0, "\xE6\xB5\x8B");
+		EXPECT_EQ(FindCodePt(str, U'\u6D4B'), pos);
+		EXPECT_EQ(FindUtf8(str, "a\xE6\xB5\x8B" "a"),
+			pos == 0 || pos == 24 ? npos : pos - 1);
+	}
+}
+
+GTEST_TEST(TestUtfSearch, Utf16)
+{
+	const size_t npos = std::string::npos;
+	const std::u16string utf16 = Utf8ToUtf16(gk_utf8);
+
+	EXPECT_EQ(FindCodePt(utf16, U'A'), 0);
+	EXPECT_EQ(FindCodePt(utf16, U'\U0001F602'), 6);
+	EXPECT_EQ(FindCodePt(utf16, U'\U0001F602', 7), utf16.size() - 6);
+	EXPECT_EQ(FindCodePt(utf16, U'\u6D4B'), 9);
+	EXPECT_EQ(FindCodePt(utf16, U'\u00E8'), npos);
+
+	EXPECT_EQ(FindUtf16(utf16, u"more"), utf16.find(u"more"));
+	EXPECT_EQ(FindUtf16(utf16, u"\u6D4B\u00E9"), utf16.find(u"\u6D4B\u00E9"));
+
+	// the second half of a surrogate pair
+	EXPECT_EQ(FindUtf16(utf16, std::u16string(1, u'\xDE02')), npos);
+	// the first half
+	EXPECT_EQ(FindUtf16(utf16, std::u16string(1, u'\xD83D')), npos);
+
+	for (size_t pos = 0; pos < 12; ++pos)
+	{
+		std::u16string str(12, u'a');
+		str.replace(pos, 0, u"\U0001F602");
+		EXPECT_EQ(FindCodePt(str, U'\U0001F602'), pos);
+	}
+}
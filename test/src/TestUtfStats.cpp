@@ -0,0 +1,125 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <SimpleUtf/Utf.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfStats, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+#ifdef SIMPLEUTF_ENABLE_STATS
+
+GTEST_TEST(TestUtfStats, Counters)
+{
+	ResetUtfStats();
+
+	// 1 + 2 + 3 + 4 bytes
+	const std::string utf8 = "a\xC3\xA9\xE6\xB5\x8B\xF0\x9F\x98\x82";
+	const auto utf16 = Utf8ToUtf16(utf8);
+	Utf16ToUtf32(utf16);
+
+	EXPECT_THROW(Utf8ToUtf16("\xE6\xB5");, UtfConversionException);
+	EXPECT_THROW(Utf8ToUtf16("\xFF");, UtfConversionException);
+	std::string out;
+	EXPECT_THROW(CodePtToUtf8Once(0xD800U, std::back_inserter(out));,
+		UtfConversionException);
+
+	// counts from other threads are kept after they exit
+	std::thread thr([&utf8](){ Utf8ToUtf32(utf8); });
+	thr.join();
+
+	const auto stats = GetUtfStats();
+	EXPECT_EQ(stats.Get(UtfStatsCounter::ConvertCalls), 5);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::Utf8Decoded1B), 2);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::Utf8Decoded2B), 2);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::Utf8Decoded3B), 2);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::Utf8Decoded4B), 2);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::Utf8Encoded1B), 0);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::Utf16EncodedSurrogatePairs), 1);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::Utf16DecodedSurrogatePairs), 1);
+	// UTF-8: 10 * 2, UTF-16: 5 * 2
+	EXPECT_EQ(stats.Get(UtfStatsCounter::BytesIn), 30);
+	// UTF-16: 5 * 2, UTF-32: 4 * 4 * 2
+	EXPECT_EQ(stats.Get(UtfStatsCounter::BytesOut), 42);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::ErrUnexpectedEnding), 1);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::ErrInvalidEncoding), 1);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::ErrInvalidCodePoint), 1);
+
+	ResetUtfStats();
+	EXPECT_EQ(GetUtfStats().Get(UtfStatsCounter::BytesIn), 0);
+}
+
+GTEST_TEST(TestUtfStats, ResetLiveThread)
+{
+	std::mutex mutex;
+	std::condition_variable cv;
+	int step = 0;
+	auto waitFor = [&](int val)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		cv.wait(lock, [&](){ return step == val; });
+	};
+	auto advance = [&]()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		++step;
+		cv.notify_all();
+	};
+
+	// the counts of a thread that is still running are reset, and it keeps
+	// counting from there
+	std::thread thr([&]()
+	{
+		Utf8ToUtf32(std::string("abc"));
+		advance();
+		waitFor(2);
+		Utf8ToUtf32(std::string("de"));
+		advance();
+	});
+
+	waitFor(1);
+	ResetUtfStats();
+	EXPECT_EQ(GetUtfStats().Get(UtfStatsCounter::Utf8Decoded1B), 0);
+	advance();
+	waitFor(3);
+	EXPECT_EQ(GetUtfStats().Get(UtfStatsCounter::Utf8Decoded1B), 2);
+
+	thr.join();
+	EXPECT_EQ(GetUtfStats().Get(UtfStatsCounter::Utf8Decoded1B), 2);
+	ResetUtfStats();
+}
+
+#else // !SIMPLEUTF_ENABLE_STATS
+
+GTEST_TEST(TestUtfStats, Disabled)
+{
+	Utf8ToUtf16("a\xC3\xA9");
+
+	const auto stats = GetUtfStats();
+	for (size_t i = 0; i < UtfStatsSnapshot::sk_numCounters; ++i)
+	{
+		EXPECT_EQ(stats.counters[i], 0);
+	}
+}
+
+#endif // SIMPLEUTF_ENABLE_STATS
@@ -0,0 +1,439 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include <SimpleUtf/UtfStream.hpp>
+#include <SimpleUtf/Utf.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+namespace
+{
+
+const std::string gk_utf8 =
+	"ASCII \xF0\x9F\x98\x82 \xE6\xB5\x8B\xE8\xAF\x95 \xC3\xA9 and more ASCII";
+
+} // namespace
+
+GTEST_TEST(TestUtfStream, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfStream, Utf8ToUtf16Split)
+{
+	const std::u16string expected = Utf8ToUtf16(gk_utf8);
+
+	// split the input at every position
+	for (size_t cut = 0; cut <= gk_utf8.size(); ++cut)
+	{
+		Utf8StreamState state = Utf8StreamState();
+		std::u16string out(expected.size(), u'\0');
+		char16_t* outNext = &out[0];
+		char16_t* outEnd = outNext + out.size();
+
+		const char* in = gk_utf8.data();
+		const char* inCut = in + cut;
+		Utf8ToUtf16Stream(state, in, inCut, outNext, outEnd);
+		EXPECT_EQ(in, inCut);
+
+		const char* inEnd = gk_utf8.data() + gk_utf8.size();
+		EXPECT_EQ(Utf8ToUtf16Stream(state, in, inEnd, outNext, outEnd),
+			UtfStreamResult::Ok);
+		EXPECT_EQ(outNext, outEnd);
+		EXPECT_EQ(out, expected);
+	}
+
+	// a sequence cut twice
+	{
+		const std::string emoji = "\xF0\x9F\x98\x82";
+		Utf8StreamState state = Utf8StreamState();
+		char16_t out[2] = { 0, 0 };
+		char16_t* outNext = out;
+		for (size_t i = 0; i < emoji.size(); ++i)
+		{
+			const char* in = emoji.data() + i;
+			EXPECT_EQ(Utf8ToUtf16Stream(state, in, in + 1, outNext, out + 2),
+				i + 1 < emoji.size() ?
+					UtfStreamResult::Partial : UtfStreamResult::Ok);
+		}
+		EXPECT_EQ(std::u16string(out, 2), u"\U0001F602");
+	}
+}
+
+GTEST_TEST(TestUtfStream, DefaultState)
+{
+	// default-constructed states are the initial states
+	const Utf8StreamState state8;
+	EXPECT_EQ(state8.numBytes, 0);
+	const Utf16StreamState state16;
+	EXPECT_EQ(state16.highSurrogate, 0);
+
+	// and they can still be kept in a std::mbstate_t
+	static_assert(std::is_trivially_copyable<Utf8StreamState>::value,
+		"Utf8StreamState should be trivially copyable");
+	static_assert(std::is_trivially_copyable<Utf16StreamState>::value,
+		"Utf16StreamState should be trivially copyable");
+}
+
+GTEST_TEST(TestUtfStream, Utf8ToUtf16OutputFull)
+{
+	Utf8StreamState state = Utf8StreamState();
+	const std::string in = "a\xF0\x9F\x98\x82";
+	const char* inNext = in.data();
+	char16_t out[2] = { 0, 0 };
+	char16_t* outNext = out;
+
+	// no room for the surrogate pair
+	EXPECT_EQ(Utf8ToUtf16Stream(state, inNext, in.data() + in.size(),
+		outNext, out + 2), UtfStreamResult::Partial);
+	EXPECT_EQ(inNext, in.data() + 1);
+	EXPECT_EQ(outNext, out + 1);
+	EXPECT_EQ(state.numBytes, 0);
+}
+
+GTEST_TEST(TestUtfStream, Utf8ToUtf16Error)
+{
+	auto convert = [](const std::string& in, size_t& errPos)
+	{
+		Utf8StreamState state = Utf8StreamState();
+		std::u16string out(in.size(), u'\0');
+		const char* inNext = in.data();
+		char16_t* outNext = &out[0];
+		auto res = Utf8ToUtf16Stream(state, inNext, in.data() + in.size(),
+			outNext, outNext + out.size());
+		errPos = static_cast<size_t>(inNext - in.data());
+		return res;
+	};
+
+	size_t errPos = 0;
+	EXPECT_EQ(convert("ab\xFF" "cd", errPos), UtfStreamResult::Error);
+	EXPECT_EQ(errPos, 2);
+	EXPECT_EQ(convert("ab\xE6\xB5" "c", errPos), UtfStreamResult::Error);
+	EXPECT_EQ(errPos, 2);
+	EXPECT_EQ(convert("ab\xC0\x80", errPos), UtfStreamResult::Error);
+	EXPECT_EQ(errPos, 2);
+	// a cut sequence that can never be valid
+	EXPECT_EQ(convert("ab\xE6" "c", errPos), UtfStreamResult::Error);
+	EXPECT_EQ(errPos, 2);
+
+	// a sequence pending from the previous block turns out to be invalid;
+	// the state is cleared, so the decoder can be used again
+	Utf8StreamState state = Utf8StreamState();
+	std::u16string out(4, u'\0');
+	char16_t* outNext = &out[0];
+	const std::string first = "a\xE6";
+	const char* in = first.data();
+	EXPECT_EQ(Utf8ToUtf16Stream(state, in, in + first.size(),
+		outNext, &out[0] + out.size()), UtfStreamResult::Partial);
+	const std::string second = "bc";
+	in = second.data();
+	EXPECT_EQ(Utf8ToUtf16Stream(state, in, in + second.size(),
+		outNext, &out[0] + out.size()), UtfStreamResult::Error);
+	EXPECT_EQ(in, second.data());
+	EXPECT_EQ(state.numBytes, 0);
+	EXPECT_EQ(Utf8ToUtf16Stream(state, in, in + second.size(),
+		outNext, &out[0] + out.size()), UtfStreamResult::Ok);
+	EXPECT_EQ(out, u"abc" + std::u16string(1, u'\0'));
+}
+
+GTEST_TEST(TestUtfStream, Utf16ToUtf8Split)
+{
+	const std::u16string utf16 = Utf8ToUtf16(gk_utf8);
+
+	for (size_t cut = 0; cut <= utf16.size(); ++cut)
+	{
+		Utf16StreamState state = Utf16StreamState();
+		std::string out(gk_utf8.size(), '\0');
+		char* outNext = &out[0];
+		char* outEnd = outNext + out.size();
+
+		const char16_t* in = utf16.data();
+		const char16_t* inCut = in + cut;
+		Utf16ToUtf8Stream(state, in, inCut, outNext, outEnd);
+		EXPECT_EQ(in, inCut);
+
+		const char16_t* inEnd = utf16.data() + utf16.size();
+		EXPECT_EQ(Utf16ToUtf8Stream(state, in, inEnd, outNext, outEnd),
+			UtfStreamResult::Ok);
+		EXPECT_EQ(out, gk_utf8);
+	}
+
+	Utf16StreamState state = Utf16StreamState();
+	const std::u16string invalid = u"a\xDC00";
+	const char16_t* in = invalid.data();
+	char out[8];
+	char* outNext = out;
+	EXPECT_EQ(Utf16ToUtf8Stream(state, in, in + invalid.size(),
+		outNext, out + sizeof(out)), UtfStreamResult::Error);
+	EXPECT_EQ(in, invalid.data() + 1);
+
+	// a high surrogate pending from the previous block isn't followed by a
+	// low one; the state is cleared
+	const std::u16string high(1, char16_t(0xD83D));
+	in = high.data();
+	outNext = out;
+	EXPECT_EQ(Utf16ToUtf8Stream(state, in, in + high.size(),
+		outNext, out + sizeof(out)), UtfStreamResult::Partial);
+	EXPECT_EQ(state.highSurrogate, 0xD83D);
+	const std::u16string next = u"b";
+	in = next.data();
+	EXPECT_EQ(Utf16ToUtf8Stream(state, in, in + next.size(),
+		outNext, out + sizeof(out)), UtfStreamResult::Error);
+	EXPECT_EQ(in, next.data());
+	EXPECT_EQ(state.highSurrogate, 0);
+}
+
+GTEST_TEST(TestUtfStream, Newlines)
+{
+	const std::string utf8 = "one\r\ntwo\r\xC3\xA9\rthree\n\r";
+	const std::string normalized = "one\ntwo\n\xC3\xA9\nthree\n\n";
+	const std::u16string expected = Utf8ToUtf16(normalized);
+
+	// split the input at every position, including between CR and LF
+	for (size_t cut = 0; cut <= utf8.size(); ++cut)
+	{
+		Utf8StreamState state = Utf8StreamState();
+		NewlineNormalizer newlines;
+		std::u16string out(utf8.size(), u'\0');
+		char16_t* outNext = &out[0];
+		char16_t* outEnd = outNext + out.size();
+
+		const char* in = utf8.data();
+		const char* inCut = in + cut;
+		Utf8ToUtf16Stream(state, in, inCut, outNext, outEnd, &newlines);
+		EXPECT_EQ(in, inCut);
+
+		const char* inEnd = utf8.data() + utf8.size();
+		EXPECT_EQ(Utf8ToUtf16Stream(state, in, inEnd, outNext, outEnd,
+			&newlines), UtfStreamResult::Ok);
+		out.resize(static_cast<size_t>(outNext - out.data()));
+		EXPECT_EQ(out, expected);
+		EXPECT_EQ(newlines.GetNumNewlines(), 5);
+	}
+
+	const std::u16string utf16 = Utf8ToUtf16(utf8);
+	for (size_t cut = 0; cut <= utf16.size(); ++cut)
+	{
+		Utf16StreamState state = Utf16StreamState();
+		NewlineNormalizer newlines;
+		std::string out(utf8.size(), '\0');
+		char* outNext = &out[0];
+		char* outEnd = outNext + out.size();
+
+		const char16_t* in = utf16.data();
+		const char16_t* inCut = in + cut;
+		Utf16ToUtf8Stream(state, in, inCut, outNext, outEnd, &newlines);
+		EXPECT_EQ(in, inCut);
+
+		const char16_t* inEnd = utf16.data() + utf16.size();
+		EXPECT_EQ(Utf16ToUtf8Stream(state, in, inEnd, outNext, outEnd,
+			&newlines), UtfStreamResult::Ok);
+		out.resize(static_cast<size_t>(outNext - out.data()));
+		EXPECT_EQ(out, normalized);
+		EXPECT_EQ(newlines.GetNumNewlines(), 5);
+	}
+
+	// the output is full right at a CR; it's converted by the next call
+	{
+		Utf8StreamState state = Utf8StreamState();
+		NewlineNormalizer newlines;
+		const std::string crlf = "a\r\n";
+		char16_t out[3] = { 0, 0, 0 };
+		char16_t* outNext = out;
+		const char* in = crlf.data();
+		EXPECT_EQ(Utf8ToUtf16Stream(state, in, in + crlf.size(),
+			outNext, out + 1, &newlines), UtfStreamResult::Partial);
+		EXPECT_EQ(in, crlf.data() + 1);
+		EXPECT_EQ(Utf8ToUtf16Stream(state, in, crlf.data() + crlf.size(),
+			outNext, out + 3, &newlines), UtfStreamResult::Ok);
+		EXPECT_EQ(outNext, out + 2);
+		EXPECT_EQ(std::u16string(out, 2), u"a\n");
+	}
+}
+
+GTEST_TEST(TestUtfStream, Codecvt)
+{
+	using Codecvt = std::codecvt<char16_t, char, std::mbstate_t>;
+
+	std::locale loc(std::locale::classic(), new Utf8Utf16Codecvt());
+	const Codecvt& cvt = std::use_facet<Codecvt>(loc);
+
+	EXPECT_FALSE(cvt.always_noconv());
+	EXPECT_EQ(cvt.encoding(), 0);
+	EXPECT_EQ(cvt.max_length(), 4);
+
+	// in - one byte at a time
+	{
+		std::mbstate_t state = std::mbstate_t();
+		std::u16string out(gk_utf8.size(), u'\0');
+		char16_t* toNext = &out[0];
+		for (size_t i = 0; i < gk_utf8.size(); ++i)
+		{
+			const char* from = gk_utf8.data() + i;
+			const char* fromNext = nullptr;
+			char16_t* to = toNext;
+			auto res = cvt.in(state, from, from + 1, fromNext,
+				to, &out[0] + out.size(), toNext);
+			EXPECT_NE(res, Codecvt::error);
+			EXPECT_EQ(fromNext, from + 1);
+		}
+		out.resize(static_cast<size_t>(toNext - &out[0]));
+		EXPECT_EQ(out, Utf8ToUtf16(gk_utf8));
+	}
+
+	// out - one unit at a time
+	{
+		const std::u16string utf16 = Utf8ToUtf16(gk_utf8);
+		std::mbstate_t state = std::mbstate_t();
+		std::string out(gk_utf8.size(), '\0');
+		char* toNext = &out[0];
+		for (size_t i = 0; i < utf16.size(); ++i)
+		{
+			const char16_t* from = utf16.data() + i;
+			const char16_t* fromNext = nullptr;
+			char* to = toNext;
+			auto res = cvt.out(state, from, from + 1, fromNext,
+				to, &out[0] + out.size(), toNext);
+			EXPECT_NE(res, Codecvt::error);
+			EXPECT_EQ(fromNext, from + 1);
+		}
+		EXPECT_EQ(out, gk_utf8);
+
+		char* unshiftNext = nullptr;
+		EXPECT_EQ(cvt.unshift(state, &out[0], &out[0], unshiftNext),
+			Codecvt::noconv);
+	}
+
+	// length
+	{
+		std::mbstate_t state = std::mbstate_t();
+		const char* begin = gk_utf8.data();
+		// "ASCII " + the surrogate pair
+		EXPECT_EQ(cvt.length(state, begin, begin + gk_utf8.size(), 8), 10);
+	}
+}
+
+GTEST_TEST(TestUtfStream, StreamBuf)
+{
+	std::string longUtf8;
+	for (size_t i = 0; i < 100; ++i)
+	{
+		longUtf8 += gk_utf8;
+	}
+	const std::u16string longUtf16 = Utf8ToUtf16(longUtf8);
+
+	// read, with blocks smaller than the input and not aligned to sequences
+	{
+		std::stringbuf bytes(longUtf8);
+		Utf8Utf16StreamBuf buf(&bytes, 7);
+		std::u16string res(
+			(std::istreambuf_iterator<char16_t>(&buf)),
+			std::istreambuf_iterator<char16_t>());
+		EXPECT_EQ(res, longUtf16);
+	}
+
+	// write
+	{
+		std::stringbuf bytes;
+		{
+			Utf8Utf16StreamBuf buf(&bytes, 7);
+			std::copy(longUtf16.begin(), longUtf16.end(),
+				std::ostreambuf_iterator<char16_t>(&buf));
+			EXPECT_EQ(buf.pubsync(), 0);
+		}
+		EXPECT_EQ(bytes.str(), longUtf8);
+	}
+
+	// a lone high surrogate at the end of the output
+	{
+		const std::u16string lone = u"ab" + std::u16string(1, char16_t(0xD83D));
+
+		std::stringbuf bytes;
+		{
+			Utf8Utf16StreamBuf buf(&bytes, 7);
+			buf.sputn(lone.data(), static_cast<std::streamsize>(lone.size()));
+			EXPECT_THROW(buf.Finish();, UtfConversionException);
+		}
+		EXPECT_EQ(bytes.str(), "ab");
+
+		// it's not dropped silently on destruction
+		std::stringbuf bytes2;
+		{
+			Utf8Utf16StreamBuf buf(&bytes2, 7);
+			buf.sputn(lone.data(), static_cast<std::streamsize>(lone.size()));
+		}
+		EXPECT_EQ(bytes2.str(), "ab\xEF\xBF\xBD");
+	}
+
+	// invalid input
+	{
+		std::stringbuf bytes("abc\xE6\xB5");
+		Utf8Utf16StreamBuf buf(&bytes, 7);
+		EXPECT_THROW(
+			std::u16string((std::istreambuf_iterator<char16_t>(&buf)),
+				std::istreambuf_iterator<char16_t>());,
+			UtfConversionException);
+	}
+}
+
+GTEST_TEST(TestUtfStream, Filebuf)
+{
+	// longer than the file buffer, so sequences are cut between blocks
+	std::string longUtf8;
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		longUtf8 += gk_utf8;
+	}
+	const std::u16string longUtf16 = Utf8ToUtf16(longUtf8);
+
+	const std::string path = ::testing::TempDir() + "TestUtfStream.txt";
+	const std::locale loc(std::locale::classic(), new Utf8Utf16Codecvt());
+
+	// write UTF-16, which is stored as UTF-8
+	{
+		std::basic_filebuf<char16_t> file;
+		file.pubimbue(loc);
+		ASSERT_NE(file.open(path, std::ios::out | std::ios::binary), nullptr);
+		EXPECT_EQ(file.sputn(longUtf16.data(),
+				static_cast<std::streamsize>(longUtf16.size())),
+			static_cast<std::streamsize>(longUtf16.size()));
+		EXPECT_NE(file.close(), nullptr);
+	}
+
+	{
+		std::ifstream file(path, std::ios::in | std::ios::binary);
+		const std::string bytes((std::istreambuf_iterator<char>(file)),
+			std::istreambuf_iterator<char>());
+		EXPECT_EQ(bytes, longUtf8);
+	}
+
+	// and read it back as UTF-16
+	{
+		std::basic_filebuf<char16_t> file;
+		file.pubimbue(loc);
+		ASSERT_NE(file.open(path, std::ios::in | std::ios::binary), nullptr);
+		const std::u16string res(
+			(std::istreambuf_iterator<char16_t>(&file)),
+			std::istreambuf_iterator<char16_t>());
+		EXPECT_EQ(res, longUtf16);
+	}
+
+	std::remove(path.c_str());
+}
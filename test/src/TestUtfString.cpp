@@ -0,0 +1,153 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <SimpleUtf/Utf.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfString, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfString, Metrics)
+{
+	const Utf8String empty8;
+	EXPECT_TRUE(empty8.empty());
+	EXPECT_EQ(empty8.GetNumCodePts(), 0);
+	EXPECT_TRUE(empty8.IsAscii());
+
+	const Utf8String ascii8(std::string("Hello, world!"));
+	EXPECT_EQ(ascii8.size(), 13);
+	EXPECT_EQ(ascii8.GetNumCodePts(), 13);
+	EXPECT_TRUE(ascii8.IsAscii());
+
+	const Utf8String mixed8(std::string("caf\xC3\xA9 \xE4\xB8\xAD \xF0\x9F\x98\x80"));
+	EXPECT_EQ(mixed8.size(), 14);
+	EXPECT_EQ(mixed8.GetNumCodePts(), 8);
+	EXPECT_FALSE(mixed8.IsAscii());
+	EXPECT_EQ(mixed8.Get(), "caf\xC3\xA9 \xE4\xB8\xAD \xF0\x9F\x98\x80");
+
+	const Utf16String ascii16(std::u16string(u"Hello"));
+	EXPECT_EQ(ascii16.GetNumCodePts(), 5);
+	EXPECT_TRUE(ascii16.IsAscii());
+
+	const Utf16String mixed16(std::u16string(u"caf\u00E9 \u4E2D \U0001F600"));
+	EXPECT_EQ(mixed16.size(), 9);
+	EXPECT_EQ(mixed16.GetNumCodePts(), 8);
+	EXPECT_FALSE(mixed16.IsAscii());
+}
+
+GTEST_TEST(TestUtfString, Invalid)
+{
+	EXPECT_THROW(Utf8String(std::string("abc\xC3")), UtfConversionException);
+	EXPECT_THROW(Utf8String(std::string("abc\xC0\x80")), UtfConversionException);
+	EXPECT_THROW(Utf8String(std::string("abc\xED\xA0\x80")),
+		UtfConversionException);
+	EXPECT_THROW(Utf8String(std::string("abc\xF4\x90\x80\x80")),
+		UtfConversionException);
+
+	EXPECT_THROW(Utf16String(std::u16string(1, char16_t(0xD800))),
+		UtfConversionException);
+	EXPECT_THROW(Utf16String(std::u16string(u"abc") + char16_t(0xDC00)),
+		UtfConversionException);
+}
+
+GTEST_TEST(TestUtfString, MoveAndRelease)
+{
+	// so containers move them instead of copying
+	static_assert(std::is_nothrow_move_constructible<Utf8String>::value,
+		"Utf8String should be nothrow move constructible");
+	static_assert(std::is_nothrow_move_assignable<Utf8String>::value,
+		"Utf8String should be nothrow move assignable");
+	static_assert(std::is_nothrow_move_constructible<Utf16String>::value,
+		"Utf16String should be nothrow move constructible");
+	static_assert(std::is_nothrow_move_assignable<Utf16String>::value,
+		"Utf16String should be nothrow move assignable");
+
+	Utf8String str8(std::string("caf\xC3\xA9"));
+	Utf8String moved8(std::move(str8));
+	EXPECT_EQ(moved8.GetNumCodePts(), 4);
+	EXPECT_FALSE(moved8.IsAscii());
+	EXPECT_TRUE(str8.empty());
+	EXPECT_EQ(str8.GetNumCodePts(), 0);
+	EXPECT_TRUE(str8.IsAscii());
+
+	str8 = std::move(moved8);
+	EXPECT_EQ(str8.GetNumCodePts(), 4);
+	EXPECT_EQ(moved8.GetNumCodePts(), 0);
+
+	EXPECT_EQ(str8.Release(), "caf\xC3\xA9");
+	EXPECT_TRUE(str8.empty());
+	EXPECT_EQ(str8.GetNumCodePts(), 0);
+
+	Utf16String str16(std::u16string(u"\U0001F600"));
+	Utf16String moved16;
+	moved16 = std::move(str16);
+	EXPECT_EQ(moved16.GetNumCodePts(), 1);
+	EXPECT_EQ(str16.GetNumCodePts(), 0);
+	EXPECT_EQ(moved16.Release(), u"\U0001F600");
+}
+
+GTEST_TEST(TestUtfString, Conversions)
+{
+	// every 7th code point, skipping surrogates, so all sequence lengths and
+	// most bit patterns are covered
+	std::u32string allCodePts;
+	for (char32_t val = 0; val <= 0x10FFFFU; val += 7)
+	{
+		if ((val < 0xD800U) || (val > 0xDFFFU))
+		{
+			allCodePts.push_back(val);
+		}
+	}
+	allCodePts.push_back(0x10FFFFU);
+
+	const std::u32string testStrs[] = {
+		U"",
+		U"Hello, world!",
+		U"caf\u00E9 \u4E2D\u6587 \U0001F600\U0010FFFF",
+		allCodePts,
+	};
+
+	for (const std::u32string& testStr : testStrs)
+	{
+		const std::string utf8 = Utf32ToUtf8(testStr);
+		const std::u16string utf16 = Utf32ToUtf16(testStr);
+
+		const Utf8String valid8(utf8);
+		EXPECT_EQ(valid8.GetNumCodePts(), testStr.size());
+		EXPECT_EQ(Utf8ToUtf16(valid8), utf16);
+		EXPECT_EQ(Utf8ToUtf32(valid8), testStr);
+		EXPECT_EQ(Utf8ToUtf16GetSize(valid8), utf16.size());
+		EXPECT_EQ(Utf8ToUtf32GetSize(valid8), testStr.size());
+
+		const Utf16String valid16(utf16);
+		EXPECT_EQ(valid16.GetNumCodePts(), testStr.size());
+		EXPECT_EQ(Utf16ToUtf8(valid16), utf8);
+		EXPECT_EQ(Utf16ToUtf32(valid16), testStr);
+		EXPECT_EQ(Utf16ToUtf8GetSize(valid16), utf8.size());
+		EXPECT_EQ(Utf16ToUtf32GetSize(valid16), testStr.size());
+	}
+
+	// the output string is cleared before written
+	std::u16string out16 = u"stale";
+	Utf8ToUtf16(Utf8String(std::string("ok")), out16);
+	EXPECT_EQ(out16, u"ok");
+	std::string out8 = "stale content";
+	Utf16ToUtf8(Utf16String(std::u16string(u"\u00E9")), out8);
+	EXPECT_EQ(out8, "\xC3\xA9");
+}
@@ -0,0 +1,126 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <SimpleUtf/UtfTruncate.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+namespace
+{
+
+const std::string gk_utf8 =
+	"ASCII \xF0\x9F\x98\x82 \xE6\xB5\x8B\xE8\xAF\x95 \xC3\xA9 and more ASCII"
+	"\xF0\x9F\x98\x82\xF0\x9F\x98\x82\xE6\xB5\x8B\xE8\xAF\x95\xC3\xA9\xC3\xA9";
+
+/**
+ * @brief The sizes of the prefixes of gk_utf8 that end at a code point
+ *        boundary, in UTF-8 and in UTF-16
+ *
+ */
+void GetBoundaries(std::vector<size_t>& utf8Sizes,
+	std::vector<size_t>& utf16Sizes)
+{
+	utf8Sizes.assign(1, 0);
+	utf16Sizes.assign(1, 0);
+	for (auto it = gk_utf8.begin(); it != gk_utf8.end(); )
+	{
+		auto res = Utf8ToCodePtOnce(it, gk_utf8.end());
+		it = res.second;
+		utf8Sizes.push_back(static_cast<size_t>(it - gk_utf8.begin()));
+		utf16Sizes.push_back(
+			utf16Sizes.back() + CodePtToUtf16OnceGetSize(res.first));
+	}
+}
+
+} // namespace
+
+GTEST_TEST(TestUtfTruncate, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfTruncate, Utf8ToBytes)
+{
+	std::vector<size_t> utf8Sizes;
+	std::vector<size_t> utf16Sizes;
+	GetBoundaries(utf8Sizes, utf16Sizes);
+
+	for (size_t max = 0; max <= gk_utf8.size() + 1; ++max)
+	{
+		// the longest prefix that fits
+		size_t expected = 0;
+		for (size_t size : utf8Sizes)
+		{
+			expected = size <= max ? size : expected;
+		}
+
+		std::string str = gk_utf8;
+		TruncateUtf8ToBytes(str, max);
+		EXPECT_EQ(str, gk_utf8.substr(0, expected));
+	}
+
+	const std::string str = gk_utf8;
+	EXPECT_EQ(TruncateUtf8ToBytes(str.begin(), str.end(), 8),
+		str.begin() + 6);
+}
+
+GTEST_TEST(TestUtfTruncate, Utf16ToUnits)
+{
+	const std::u16string utf16 = Utf8ToUtf16(gk_utf8);
+
+	for (size_t max = 0; max <= utf16.size() + 1; ++max)
+	{
+		std::u16string str = utf16;
+		TruncateUtf16ToUnits(str, max);
+
+		// the longest prefix that fits, and still converts
+		const size_t size = str.size();
+		EXPECT_LE(size, max);
+		EXPECT_NO_THROW(Utf16ToUtf8(str););
+		EXPECT_TRUE((size == utf16.size()) || (size + 1 >= max));
+		EXPECT_EQ(str, utf16.substr(0, size));
+	}
+
+	EXPECT_EQ(TruncateUtf16ToUnits(utf16.begin(), utf16.end(), 7),
+		utf16.begin() + 6);
+}
+
+GTEST_TEST(TestUtfTruncate, Utf8ToUtf16Units)
+{
+	std::vector<size_t> utf8Sizes;
+	std::vector<size_t> utf16Sizes;
+	GetBoundaries(utf8Sizes, utf16Sizes);
+
+	for (size_t max = 0; max <= utf16Sizes.back() + 1; ++max)
+	{
+		size_t expected = 0;
+		for (size_t i = 0; i < utf8Sizes.size(); ++i)
+		{
+			expected = utf16Sizes[i] <= max ? utf8Sizes[i] : expected;
+		}
+
+		std::string str = gk_utf8;
+		TruncateUtf8ToUtf16Units(str, max);
+		EXPECT_EQ(str, gk_utf8.substr(0, expected));
+
+		// non-pointer iterators take the byte-by-byte path
+		EXPECT_EQ(static_cast<size_t>(TruncateUtf8ToUtf16Units(
+			gk_utf8.begin(), gk_utf8.end(), max) - gk_utf8.begin()),
+			expected);
+	}
+}
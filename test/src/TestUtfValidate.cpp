@@ -0,0 +1,166 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <SimpleUtf/UtfValidate.hpp>
+
+#ifndef SIMPLEUTF_CUSTOMIZED_NAMESPACE
+using namespace SimpleUtf;
+#else
+using namespace SIMPLEUTF_CUSTOMIZED_NAMESPACE;
+#endif
+
+namespace SimpleUtf_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfValidate, CountTestFile)
+{
+	++SimpleUtf_Test::g_numOfTestFile;
+}
+
+GTEST_TEST(TestUtfValidate, Validate)
+{
+	const std::string valid =
+		"ASCII prefix longer than 8 \xF0\x9F\x98\x82 \xE6\xB5\x8B\xC3\xA9";
+
+	EXPECT_TRUE(IsValidUtf8(valid));
+	EXPECT_TRUE(IsValidUtf8(""));
+	EXPECT_FALSE(IsValidUtf8("abc\xE6\xB5"));
+	EXPECT_FALSE(IsValidUtf8("\xC0\x80"));
+	EXPECT_FALSE(IsValidUtf8("\xED\xA0\x80"));
+	EXPECT_FALSE(IsValidUtf8("\x80xyz"));
+
+	auto view = ValidateUtf8(valid);
+	EXPECT_TRUE(view.IsBorrowed());
+	EXPECT_EQ(view.data(), valid.data());
+	EXPECT_EQ(view.size(), valid.size());
+	EXPECT_EQ(view.ToString(), valid);
+
+	EXPECT_THROW(ValidateUtf8("abc\xE6\xB5");, UtfConversionException);
+}
+
+GTEST_TEST(TestUtfValidate, ValidateReplace)
+{
+	const std::string valid = "\xE6\xB5\x8B\xE8\xAF\x95 valid";
+	auto view = ValidateUtf8Replace(valid);
+	EXPECT_TRUE(view.IsBorrowed());
+	EXPECT_EQ(view.data(), valid.data());
+
+	const std::string invalid =
+		"ab\xE6\xB5" "c\x80\x80\x80\x80" "d\xF0\x9F\x98\x82\xFF";
+	auto repaired = ValidateUtf8Replace(invalid);
+	EXPECT_FALSE(repaired.IsBorrowed());
+	EXPECT_EQ(repaired.ToString(),
+		"ab\xEF\xBF\xBD" "c\xEF\xBF\xBD" "d\xF0\x9F\x98\x82\xEF\xBF\xBD");
+	EXPECT_TRUE(IsValidUtf8(repaired.ToString()));
+
+	// copies share the repaired storage
+	auto copy = repaired;
+	EXPECT_EQ(copy.data(), repaired.data());
+	EXPECT_EQ(copy.ToString(), repaired.ToString());
+}
+
+namespace
+{
+
+template<typename _StrType, typename = void>
+struct CanValidate : std::false_type
+{};
+
+template<typename _StrType>
+struct CanValidate<_StrType, decltype(
+	(void)ValidateUtf8(std::declval<_StrType>()),
+	(void)ValidateUtf8Replace(std::declval<_StrType>()))> : std::true_type
+{};
+
+} // namespace
+
+GTEST_TEST(TestUtfValidate, NoTemporaries)
+{
+	// the views would dangle on temporary strings
+	EXPECT_TRUE((CanValidate<const std::string&>::value));
+	EXPECT_TRUE((CanValidate<std::string&>::value));
+	EXPECT_TRUE((CanValidate<const char*>::value));
+	EXPECT_FALSE((CanValidate<std::string>::value));
+	EXPECT_FALSE((CanValidate<std::string&&>::value));
+
+	const char* cStr = "abc\xC3\xA9";
+	auto view = ValidateUtf8(cStr);
+	EXPECT_EQ(view.data(), cStr);
+	EXPECT_EQ(view.size(), 5);
+	EXPECT_EQ(ValidateUtf8Replace("a\xFF").ToString(), "a\xEF\xBF\xBD");
+}
+
+GTEST_TEST(TestUtfValidate, MatchesDecoder)
+{
+	// all sequences of up to 4 bytes from the boundary values of each byte
+	// range are judged the same way as by the decoder
+	static const uint8_t sk_bytes[] = {
+		0x00, 0x41, 0x7F, 0x80, 0x8F, 0x90, 0x9F, 0xA0, 0xBF, 0xC0,
+		0xC1, 0xC2, 0xDF, 0xE0, 0xED, 0xEF, 0xF0, 0xF4, 0xF5, 0xFF,
+	};
+	static constexpr size_t sk_numBytes = sizeof(sk_bytes);
+
+	auto isValidByDecoder = [](const std::string& str)
+	{
+		try
+		{
+			auto it = str.begin();
+			while (it != str.end())
+			{
+				it = Utf8ToCodePtOnce(it, str.end()).second;
+			}
+			return true;
+		}
+		catch (const UtfConversionException&)
+		{
+			return false;
+		}
+	};
+
+	size_t numTested = 0;
+	for (size_t len = 1; len <= 4; ++len)
+	{
+		size_t total = 1;
+		for (size_t i = 0; i < len; ++i)
+		{
+			total *= sk_numBytes;
+		}
+
+		for (size_t idx = 0; idx < total; ++idx)
+		{
+			std::string str;
+			for (size_t i = 0, rest = idx; i < len; ++i, rest /= sk_numBytes)
+			{
+				str.push_back(static_cast<char>(sk_bytes[rest % sk_numBytes]));
+			}
+
+			EXPECT_EQ(IsValidUtf8(str), isValidByDecoder(str)) << idx;
+			++numTested;
+		}
+	}
+	EXPECT_GT(numTested, 160000);
+}
+
+#ifdef SIMPLEUTF_ENABLE_STATS
+
+GTEST_TEST(TestUtfValidate, NoErrorStats)
+{
+	ResetUtfStats();
+
+	EXPECT_FALSE(IsValidUtf8("abc\xE6\xB5"));
+	const std::string invalid = "a\xFF\x80";
+	EXPECT_FALSE(ValidateUtf8Replace(invalid).IsBorrowed());
+
+	const auto stats = GetUtfStats();
+	EXPECT_EQ(stats.Get(UtfStatsCounter::ErrInvalidEncoding), 0);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::ErrUnexpectedEnding), 0);
+	EXPECT_EQ(stats.Get(UtfStatsCounter::ErrInvalidCodePoint), 0);
+}
+
+#endif // SIMPLEUTF_ENABLE_STATS
@@ -0,0 +1,624 @@
+// Copyright (c) 2022 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+// simpleutf-conv - converts a file between UTF-8, UTF-16, and UTF-32, with
+// explicit byte order.
+//
+// The input file is memory mapped, the size of the output is calculated
+// first so the output file can be memory mapped as well, and then large
+// inputs are split into chunks (at code point boundaries) that are
+// converted in parallel, each into its own slot of the output.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <SimpleUtf/UtfBatch.hpp>
+#include <SimpleUtf/UtfParallel.hpp>
+
+namespace SimpleUtfConv
+{
+
+enum class UtfForm
+{
+	Utf8,
+	Utf16,
+	Utf32,
+}; // enum class UtfForm
+
+struct Encoding
+{
+	UtfForm form;
+	bool bigEndian;
+}; // struct Encoding
+
+static bool ParseEncoding(const char* name, Encoding& enc)
+{
+	std::string lower(name);
+	for (auto& ch : lower)
+	{
+		ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+	}
+
+	static const struct
+	{
+		const char* name;
+		Encoding enc;
+	} sk_encodings[] = {
+		{ "utf-8",    { UtfForm::Utf8,  false } },
+		{ "utf8",     { UtfForm::Utf8,  false } },
+		{ "utf-16le", { UtfForm::Utf16, false } },
+		{ "utf16le",  { UtfForm::Utf16, false } },
+		{ "utf-16be", { UtfForm::Utf16, true  } },
+		{ "utf16be",  { UtfForm::Utf16, true  } },
+		{ "utf-32le", { UtfForm::Utf32, false } },
+		{ "utf32le",  { UtfForm::Utf32, false } },
+		{ "utf-32be", { UtfForm::Utf32, true  } },
+		{ "utf32be",  { UtfForm::Utf32, true  } },
+	};
+
+	for (const auto& item : sk_encodings)
+	{
+		if (lower == item.name)
+		{
+			enc = item.enc;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool IsNativeBigEndian()
+{
+	const uint16_t val = 0x0102U;
+	unsigned char firstByte = 0;
+	std::memcpy(&firstByte, &val, 1);
+	return firstByte == 0x01U;
+}
+
+inline char16_t SwapBytes(char16_t val)
+{
+	return static_cast<char16_t>(((val & 0x00FFU) << 8) | ((val & 0xFF00U) >> 8));
+}
+
+inline char32_t SwapBytes(char32_t val)
+{
+	return ((val & 0x000000FFU) << 24) | ((val & 0x0000FF00U) << 8) |
+		((val & 0x00FF0000U) >> 8) | ((val & 0xFF000000U) >> 24);
+}
+
+inline char SwapBytes(char val)
+{
+	return val;
+}
+
+template<typename _CharType>
+inline void SwapBytes(_CharType* begin, _CharType* end)
+{
+	for (; begin != end; ++begin)
+	{
+		*begin = SwapBytes(*begin);
+	}
+}
+
+static bool IsSameFile(const std::string& pathA, const std::string& pathB)
+{
+	struct stat stA;
+	struct stat stB;
+	return (::stat(pathA.c_str(), &stA) == 0) &&
+		(::stat(pathB.c_str(), &stB) == 0) &&
+		(stA.st_dev == stB.st_dev) && (stA.st_ino == stB.st_ino);
+}
+
+inline std::system_error MakeSysError(const std::string& what)
+{
+	return std::system_error(errno, std::generic_category(), what);
+}
+
+/**
+ * @brief A memory mapped file; an empty file is not mapped at all, since
+ *        mmap doesn't accept zero length.
+ *
+ */
+class MappedFile
+{
+public:
+
+	/**
+	 * @brief Maps an existing file for reading.
+	 *
+	 * @param writable Map it as a private (copy-on-write) writable mapping,
+	 *                 so the content can be byte swapped in place, without
+	 *                 changing the file.
+	 */
+	static MappedFile OpenInput(const std::string& path, bool writable)
+	{
+		MappedFile res;
+		res.m_fd = ::open(path.c_str(), O_RDONLY);
+		if (res.m_fd < 0)
+		{
+			throw MakeSysError("Failed to open " + path);
+		}
+
+		struct stat st;
+		if (::fstat(res.m_fd, &st) != 0)
+		{
+			throw MakeSysError("Failed to stat " + path);
+		}
+		res.m_size = static_cast<size_t>(st.st_size);
+
+		int prot = PROT_READ | (writable ? PROT_WRITE : 0);
+		res.Map(prot, MAP_PRIVATE, path);
+
+		if (res.m_data != nullptr)
+		{
+			// it's only an advice, so failures are ignored
+			(void)::madvise(res.m_data, res.m_size, MADV_SEQUENTIAL);
+		}
+		return res;
+	}
+
+	/**
+	 * @brief Creates (or truncates) a file of the given size, and maps it
+	 *        for writing.
+	 *
+	 */
+	static MappedFile CreateOutput(const std::string& path, size_t size)
+	{
+		MappedFile res;
+		res.m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (res.m_fd < 0)
+		{
+			throw MakeSysError("Failed to create " + path);
+		}
+
+		if (::ftruncate(res.m_fd, static_cast<off_t>(size)) != 0)
+		{
+			throw MakeSysError("Failed to resize " + path);
+		}
+		res.m_size = size;
+
+		res.Map(PROT_READ | PROT_WRITE, MAP_SHARED, path);
+		return res;
+	}
+
+	MappedFile(MappedFile&& other) :
+		m_fd(other.m_fd),
+		m_data(other.m_data),
+		m_size(other.m_size)
+	{
+		other.m_fd = -1;
+		other.m_data = nullptr;
+		other.m_size = 0;
+	}
+
+	MappedFile(const MappedFile&) = delete;
+
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	~MappedFile()
+	{
+		if (m_data != nullptr)
+		{
+			::munmap(m_data, m_size);
+		}
+		if (m_fd >= 0)
+		{
+			::close(m_fd);
+		}
+	}
+
+	void* GetData() const
+	{
+		return m_data;
+	}
+
+	size_t GetSize() const
+	{
+		return m_size;
+	}
+
+private:
+
+	MappedFile() :
+		m_fd(-1),
+		m_data(nullptr),
+		m_size(0)
+	{}
+
+	void Map(int prot, int flags, const std::string& path)
+	{
+		if (m_size == 0)
+		{
+			return;
+		}
+
+		void* ptr = ::mmap(nullptr, m_size, prot, flags, m_fd, 0);
+		if (ptr == MAP_FAILED)
+		{
+			throw MakeSysError("Failed to map " + path);
+		}
+		m_data = ptr;
+	}
+
+	int m_fd;
+	void* m_data;
+	size_t m_size;
+}; // class MappedFile
+
+struct ConvConfig
+{
+	size_t numThreads;
+	// size of each chunk converted in parallel, in bytes of the input
+	size_t chunkSize;
+}; // struct ConvConfig
+
+/**
+ * @brief Converting between the same encoding form (e.g., UTF-16LE to
+ *        UTF-16BE); it goes through the code points, so the input is
+ *        validated as well.
+ *
+ */
+template<typename _CharType>
+struct SameFormImpl;
+
+template<>
+struct SameFormImpl<char>
+{
+	using OutCharType = char;
+
+	static size_t GetSize(const char* begin, const char* end)
+	{
+		return SimpleUtf::UtfConvertGetSize(
+			SimpleUtf::Utf8ToCodePtOnce<const char*>,
+			SimpleUtf::CodePtToUtf8OnceGetSize, begin, end);
+	}
+
+	static char* Convert(const char* begin, const char* end, char* dest)
+	{
+		return SimpleUtf::UtfConvert(
+			SimpleUtf::Utf8ToCodePtOnce<const char*>,
+			SimpleUtf::CodePtToUtf8Once<char*>, begin, end, dest);
+	}
+
+	static const char* SeqBegin(const char* begin, const char* pos)
+	{
+		return SimpleUtf::Internal::Utf8SeqBegin(begin, pos);
+	}
+}; // struct SameFormImpl<char>
+
+template<>
+struct SameFormImpl<char16_t>
+{
+	using OutCharType = char16_t;
+
+	static size_t GetSize(const char16_t* begin, const char16_t* end)
+	{
+		return SimpleUtf::UtfConvertGetSize(
+			SimpleUtf::Utf16ToCodePtOnce<const char16_t*>,
+			SimpleUtf::CodePtToUtf16OnceGetSize, begin, end);
+	}
+
+	static char16_t* Convert(
+		const char16_t* begin, const char16_t* end, char16_t* dest)
+	{
+		return SimpleUtf::UtfConvert(
+			SimpleUtf::Utf16ToCodePtOnce<const char16_t*>,
+			SimpleUtf::CodePtToUtf16Once<char16_t*>, begin, end, dest);
+	}
+
+	static const char16_t* SeqBegin(const char16_t* begin, const char16_t* pos)
+	{
+		return SimpleUtf::Internal::Utf16SeqBegin(begin, pos);
+	}
+}; // struct SameFormImpl<char16_t>
+
+template<>
+struct SameFormImpl<char32_t>
+{
+	using OutCharType = char32_t;
+
+	static size_t GetSize(const char32_t* begin, const char32_t* end)
+	{
+		return SimpleUtf::UtfConvertGetSize(
+			SimpleUtf::Utf32ToCodePtOnce<const char32_t*>,
+			SimpleUtf::CodePtToUtf32OnceGetSize, begin, end);
+	}
+
+	static char32_t* Convert(
+		const char32_t* begin, const char32_t* end, char32_t* dest)
+	{
+		return SimpleUtf::UtfConvert(
+			SimpleUtf::Utf32ToCodePtOnce<const char32_t*>,
+			SimpleUtf::CodePtToUtf32Once<char32_t*>, begin, end, dest);
+	}
+
+	static const char32_t* SeqBegin(const char32_t* begin, const char32_t* pos)
+	{
+		return SimpleUtf::Internal::Utf32SeqBegin(begin, pos);
+	}
+}; // struct SameFormImpl<char32_t>
+
+/**
+ * @brief Converts the mapped input file into the output file.
+ *
+ * @tparam _InCharType The code unit type of the input
+ * @tparam _Impl       One of the `SimpleUtf::Internal::UtfXToUtfYBatchImpl`
+ *                     types, or `SameFormImpl`
+ * @return The size of the output, in bytes
+ */
+template<typename _InCharType, typename _Impl>
+inline size_t ConvertFile(const ConvConfig& config,
+	MappedFile& input, bool swapIn,
+	const std::string& outPath, bool swapOut)
+{
+	using OutCharType = typename _Impl::OutCharType;
+
+	if (input.GetSize() % sizeof(_InCharType) != 0)
+	{
+		throw SimpleUtf::UtfConversionException(
+			"The input size is not a multiple of the code unit size");
+	}
+
+	_InCharType* in = static_cast<_InCharType*>(input.GetData());
+	const size_t inLen = input.GetSize() / sizeof(_InCharType);
+
+	// at least 16 code units per chunk, so that a chunk always contains
+	// a complete code point
+	const size_t chunkLen =
+		std::max<size_t>(config.chunkSize / sizeof(_InCharType), 16);
+	const size_t numChunks = (inLen + chunkLen - 1) / chunkLen;
+
+	// there is no need to spawn threads for a single chunk
+	const size_t numThreads = std::min(config.numThreads, numChunks);
+	std::unique_ptr<SimpleUtf::WorkStealingPool> pool;
+	if (numThreads > 1)
+	{
+		pool.reset(new SimpleUtf::WorkStealingPool(numThreads));
+	}
+	auto runTasks = [&pool](size_t numTasks, std::function<void(size_t)> func)
+	{
+		if (pool)
+		{
+			pool->Run(numTasks, std::move(func));
+		}
+		else
+		{
+			for (size_t i = 0; i < numTasks; ++i)
+			{
+				func(i);
+			}
+		}
+	};
+
+	// 1. swap the input into the native byte order, in place
+	if (swapIn)
+	{
+		runTasks(numChunks, [&](size_t i)
+		{
+			SwapBytes(in + (i * chunkLen),
+				in + std::min(inLen, (i + 1) * chunkLen));
+		});
+	}
+
+	// 2. split the input at code point boundaries
+	std::vector<size_t> cuts;
+	cuts.push_back(0);
+	for (size_t i = 1; i < numChunks; ++i)
+	{
+		const size_t cut = static_cast<size_t>(
+			_Impl::SeqBegin(in, in + (i * chunkLen)) - in);
+		if (cut > cuts.back())
+		{
+			cuts.push_back(cut);
+		}
+	}
+	cuts.push_back(inLen);
+	const size_t numParts = cuts.size() - 1;
+
+	// 3. calculate the size of the output of each part
+	std::vector<size_t> outPos(numParts + 1, 0);
+	runTasks(numParts, [&](size_t i)
+	{
+		outPos[i + 1] = _Impl::GetSize(in + cuts[i], in + cuts[i + 1]);
+	});
+	for (size_t i = 0; i < numParts; ++i)
+	{
+		outPos[i + 1] += outPos[i];
+	}
+	const size_t outLen = outPos.back();
+
+	// 4. convert each part into its slot of the output
+	MappedFile output =
+		MappedFile::CreateOutput(outPath, outLen * sizeof(OutCharType));
+	OutCharType* out = static_cast<OutCharType*>(output.GetData());
+	try
+	{
+		runTasks(numParts, [&](size_t i)
+		{
+			OutCharType* dest = out + outPos[i];
+			OutCharType* destEnd =
+				_Impl::Convert(in + cuts[i], in + cuts[i + 1], dest);
+			if (swapOut)
+			{
+				SwapBytes(dest, destEnd);
+			}
+		});
+	}
+	catch (...)
+	{
+		// don't leave a partially converted file behind
+		::unlink(outPath.c_str());
+		throw;
+	}
+
+	return output.GetSize();
+}
+
+template<typename _InCharType,
+	template<typename> class _Utf8Impl,
+	template<typename> class _Utf16Impl,
+	template<typename> class _Utf32Impl>
+inline size_t ConvertFrom(const ConvConfig& config,
+	MappedFile& input, bool swapIn,
+	const std::string& outPath, UtfForm outForm, bool swapOut)
+{
+	switch (outForm)
+	{
+	case UtfForm::Utf8:
+		return ConvertFile<_InCharType, _Utf8Impl<_InCharType> >(
+			config, input, swapIn, outPath, swapOut);
+	case UtfForm::Utf16:
+		return ConvertFile<_InCharType, _Utf16Impl<_InCharType> >(
+			config, input, swapIn, outPath, swapOut);
+	case UtfForm::Utf32:
+	default:
+		return ConvertFile<_InCharType, _Utf32Impl<_InCharType> >(
+			config, input, swapIn, outPath, swapOut);
+	}
+}
+
+template<typename _InCharType>
+using Utf8Same = SameFormImpl<char>;
+template<typename _InCharType>
+using Utf16Same = SameFormImpl<char16_t>;
+template<typename _InCharType>
+using Utf32Same = SameFormImpl<char32_t>;
+
+static size_t Convert(const ConvConfig& config,
+	const std::string& inPath, const Encoding& inEnc,
+	const std::string& outPath, const Encoding& outEnc)
+{
+	using namespace SimpleUtf::Internal;
+
+	const bool nativeBig = IsNativeBigEndian();
+	const bool swapIn = (inEnc.form != UtfForm::Utf8) &&
+		(inEnc.bigEndian != nativeBig);
+	const bool swapOut = (outEnc.form != UtfForm::Utf8) &&
+		(outEnc.bigEndian != nativeBig);
+
+	MappedFile input = MappedFile::OpenInput(inPath, swapIn);
+
+	switch (inEnc.form)
+	{
+	case UtfForm::Utf8:
+		return ConvertFrom<char,
+			Utf8Same, Utf8ToUtf16BatchImpl, Utf8ToUtf32BatchImpl>(
+				config, input, swapIn, outPath, outEnc.form, swapOut);
+	case UtfForm::Utf16:
+		return ConvertFrom<char16_t,
+			Utf16ToUtf8BatchImpl, Utf16Same, Utf16ToUtf32BatchImpl>(
+				config, input, swapIn, outPath, outEnc.form, swapOut);
+	case UtfForm::Utf32:
+	default:
+		return ConvertFrom<char32_t,
+			Utf32ToUtf8BatchImpl, Utf32ToUtf16BatchImpl, Utf32Same>(
+				config, input, swapIn, outPath, outEnc.form, swapOut);
+	}
+}
+
+static void PrintUsage(const char* prog)
+{
+	std::cerr << "Usage: " << prog
+		<< " --from=<enc> --to=<enc> [--threads=<n>] [--chunk-size=<bytes>]"
+		<< " <input> <output>" << std::endl
+		<< "  <enc> is one of utf-8, utf-16le, utf-16be, utf-32le, utf-32be"
+		<< std::endl
+		<< "  --threads     number of threads; 0 (default) means the number"
+		<< " of hardware threads" << std::endl
+		<< "  --chunk-size  size of the input chunks converted in parallel"
+		<< " (default 4194304)" << std::endl;
+}
+
+} // namespace SimpleUtfConv
+
+int main(int argc, char** argv)
+{
+	using namespace SimpleUtfConv;
+
+	Encoding inEnc = { UtfForm::Utf8, false };
+	Encoding outEnc = { UtfForm::Utf8, false };
+	bool hasIn = false;
+	bool hasOut = false;
+	ConvConfig config = { 0, 4 * 1024 * 1024 };
+	std::vector<std::string> paths;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strncmp(argv[i], "--from=", 7) == 0)
+		{
+			hasIn = ParseEncoding(argv[i] + 7, inEnc);
+		}
+		else if (std::strncmp(argv[i], "--to=", 5) == 0)
+		{
+			hasOut = ParseEncoding(argv[i] + 5, outEnc);
+		}
+		else if (std::strncmp(argv[i], "--threads=", 10) == 0)
+		{
+			config.numThreads = std::strtoul(argv[i] + 10, nullptr, 10);
+		}
+		else if (std::strncmp(argv[i], "--chunk-size=", 13) == 0)
+		{
+			config.chunkSize = std::strtoul(argv[i] + 13, nullptr, 10);
+		}
+		else if (argv[i][0] != '-')
+		{
+			paths.push_back(argv[i]);
+		}
+		else
+		{
+			PrintUsage(argv[0]);
+			return -1;
+		}
+	}
+
+	if (!hasIn || !hasOut || (paths.size() != 2))
+	{
+		PrintUsage(argv[0]);
+		return -1;
+	}
+
+	if (IsSameFile(paths[0], paths[1]))
+	{
+		std::cerr << "Error: The input and output must be different files"
+			<< std::endl;
+		return 1;
+	}
+
+	if (config.numThreads == 0)
+	{
+		config.numThreads = std::thread::hardware_concurrency();
+		config.numThreads = config.numThreads != 0 ? config.numThreads : 1;
+	}
+
+	try
+	{
+		Convert(config, paths[0], inEnc, paths[1], outEnc);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
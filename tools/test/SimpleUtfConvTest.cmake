@@ -0,0 +1,179 @@
+# Copyright (c) 2022 Haofan Zheng
+# Use of this source code is governed by an MIT-style
+# license that can be found in the LICENSE file or at
+# https://opensource.org/licenses/MIT.
+
+# Tests simpleutf-conv by round-tripping files through
+# UTF-8 --> UTF-16LE --> UTF-16BE --> UTF-32LE --> UTF-32BE --> UTF-8
+#
+# Usage:
+#   cmake -DSIMPLEUTF_CONV=<path to simpleutf-conv> -DWORK_DIR=<dir>
+#         -P SimpleUtfConvTest.cmake
+
+cmake_minimum_required(VERSION 3.14)
+
+if(NOT SIMPLEUTF_CONV OR NOT WORK_DIR)
+	message(FATAL_ERROR "SIMPLEUTF_CONV and WORK_DIR must be defined")
+endif()
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+# the default --chunk-size of simpleutf-conv, i.e., inputs larger than this
+# are converted by multiple threads
+set(DEFAULT_CHUNK_SIZE 4194304)
+
+################################################################################
+# Helpers
+################################################################################
+
+# sets `${outVar}` to the given bytes (in decimal); it's used to keep the
+# non-ASCII characters out of this file
+function(MakeBytes outVar)
+	string(ASCII ${ARGN} res)
+	set(${outVar} "${res}" PARENT_SCOPE)
+endfunction()
+
+function(RunConv from to input output)
+	execute_process(
+		COMMAND ${SIMPLEUTF_CONV} --from=${from} --to=${to} ${ARGN}
+			${input} ${output}
+		RESULT_VARIABLE res
+		ERROR_VARIABLE err)
+	if(NOT res EQUAL 0)
+		message(FATAL_ERROR
+			"${from} --> ${to} of ${input} failed (${res}): ${err}")
+	endif()
+endfunction()
+
+function(ExpectSameFile fileA fileB)
+	execute_process(
+		COMMAND ${CMAKE_COMMAND} -E compare_files ${fileA} ${fileB}
+		RESULT_VARIABLE res)
+	if(NOT res EQUAL 0)
+		message(FATAL_ERROR "${fileA} and ${fileB} are different")
+	endif()
+endfunction()
+
+function(ExpectFileSize path expected)
+	file(SIZE ${path} size)
+	if(NOT size EQUAL expected)
+		message(FATAL_ERROR
+			"The size of ${path} is ${size}, while ${expected} is expected")
+	endif()
+endfunction()
+
+# converts `${name}.utf8` in WORK_DIR all the way around, and checks that
+# the result is the same as the input
+function(RoundTrip name)
+	set(base ${WORK_DIR}/${name})
+	RunConv(utf-8    utf-16le ${base}.utf8     ${base}.utf16le ${ARGN})
+	RunConv(utf-16le utf-16be ${base}.utf16le  ${base}.utf16be ${ARGN})
+	RunConv(utf-16be utf-32le ${base}.utf16be  ${base}.utf32le ${ARGN})
+	RunConv(utf-32le utf-32be ${base}.utf32le  ${base}.utf32be ${ARGN})
+	RunConv(utf-32be utf-8    ${base}.utf32be  ${base}.out.utf8 ${ARGN})
+	ExpectSameFile(${base}.utf8 ${base}.out.utf8)
+endfunction()
+
+# runs a conversion that must fail, and must not leave any output behind
+function(ExpectConvFailure from to input output)
+	file(REMOVE ${output})
+	execute_process(
+		COMMAND ${SIMPLEUTF_CONV} --from=${from} --to=${to} ${ARGN}
+			${input} ${output}
+		RESULT_VARIABLE res
+		OUTPUT_QUIET
+		ERROR_QUIET)
+	if(res EQUAL 0)
+		message(FATAL_ERROR
+			"${from} --> ${to} of the invalid ${input} succeeded")
+	endif()
+	if(EXISTS ${output})
+		message(FATAL_ERROR
+			"${from} --> ${to} of the invalid ${input} left ${output} behind")
+	endif()
+endfunction()
+
+################################################################################
+# Fixtures
+################################################################################
+
+# U+00E9, U+6D4B, U+8BD5, and U+1F602
+MakeBytes(CH_2B 195 169)
+MakeBytes(CH_3B 230 181 139 232 175 149)
+MakeBytes(CH_4B 240 159 152 130)
+# a byte that never appears in UTF-8
+MakeBytes(INVALID_BYTE 255)
+
+set(MIXED_TEXT "ASCII, x${CH_2B}y, ${CH_3B}, ${CH_4B}${CH_4B}\n")
+
+################################################################################
+# Test cases
+################################################################################
+
+# 1. a small file with code points of every length
+file(WRITE ${WORK_DIR}/small.utf8 "${MIXED_TEXT}")
+RoundTrip(small)
+# 19 code points, 2 of which are encoded as surrogate pairs
+ExpectFileSize(${WORK_DIR}/small.utf16le 42)
+ExpectFileSize(${WORK_DIR}/small.utf32be 76)
+file(READ ${WORK_DIR}/small.utf16be hex OFFSET 16 LIMIT 4 HEX)
+if(NOT hex STREQUAL "00e90079")
+	message(FATAL_ERROR "Unexpected UTF-16BE encoding: ${hex}")
+endif()
+file(READ ${WORK_DIR}/small.utf32le hex OFFSET 64 LIMIT 4 HEX)
+if(NOT hex STREQUAL "02f60100")
+	message(FATAL_ERROR "Unexpected UTF-32LE encoding: ${hex}")
+endif()
+
+# 2. an empty file
+file(WRITE ${WORK_DIR}/empty.utf8 "")
+RoundTrip(empty)
+ExpectFileSize(${WORK_DIR}/empty.utf16le 0)
+ExpectFileSize(${WORK_DIR}/empty.utf32be 0)
+
+# 3. a file larger than the default chunk size, so it's converted by multiple
+#    threads, with a 4-byte sequence straddling the first chunk boundary
+set(large "${MIXED_TEXT}")
+string(LENGTH "${large}" largeLen)
+while(largeLen LESS DEFAULT_CHUNK_SIZE)
+	string(APPEND large "${large}")
+	string(LENGTH "${large}" largeLen)
+endwhile()
+math(EXPR prefixLen "${DEFAULT_CHUNK_SIZE} - 2")
+string(SUBSTRING "${large}" 0 ${prefixLen} large)
+# the prefix may end in the middle of a sequence; pad it with ASCII
+string(REGEX REPLACE "[^\n -~]+$" "" large "${large}")
+string(LENGTH "${large}" largeLen)
+while(largeLen LESS prefixLen)
+	string(APPEND large ".")
+	string(LENGTH "${large}" largeLen)
+endwhile()
+string(APPEND large "${CH_4B}${MIXED_TEXT}${MIXED_TEXT}")
+file(WRITE ${WORK_DIR}/large.utf8 "${large}")
+RoundTrip(large --threads=4)
+# smaller chunks, so the chunk boundaries of each encoding form land in the
+# middle of sequences as well
+RoundTrip(large --threads=4 --chunk-size=1001)
+
+# 4. invalid inputs
+file(WRITE ${WORK_DIR}/invalid.utf8
+	"${MIXED_TEXT}${INVALID_BYTE}${MIXED_TEXT}")
+ExpectConvFailure(utf-8 utf-16le
+	${WORK_DIR}/invalid.utf8 ${WORK_DIR}/invalid.utf16le)
+ExpectConvFailure(utf-8 utf-8
+	${WORK_DIR}/invalid.utf8 ${WORK_DIR}/invalid.out.utf8)
+
+# a truncated sequence in a later chunk of a multi-threaded conversion
+string(SUBSTRING "${CH_4B}" 0 2 truncated)
+file(WRITE ${WORK_DIR}/invalid-large.utf8 "${large}${truncated}")
+ExpectConvFailure(utf-8 utf-32le
+	${WORK_DIR}/invalid-large.utf8 ${WORK_DIR}/invalid-large.utf32le
+	--threads=4)
+
+# a size that is not a multiple of the code unit size
+file(WRITE ${WORK_DIR}/odd.utf16le "abc")
+ExpectConvFailure(utf-16le utf-8
+	${WORK_DIR}/odd.utf16le ${WORK_DIR}/odd.utf8)
+
+message(STATUS "simpleutf-conv round trips passed")